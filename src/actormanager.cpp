@@ -48,6 +48,7 @@
 #include "net/playerhandler.h"
 
 #include <algorithm>
+#include <climits>
 #include <list>
 
 #include "debug.h"
@@ -58,8 +59,54 @@
 #define for_actorsm for (ActorSpritesIterator it = mActors.begin(), \
     it_end = mActors.end() ; it != it_end; ++it)
 
+// iterate actors from grid blocks what cover given tiles rectangle
+#define for_grid(x1, y1, x2, y2) \
+    for (int gridY = std::max(getGridCoord(y1), getGridFirstRow()), \
+        gridY2 = std::min(getGridCoord(y2), getGridLastRow()); \
+        gridY <= gridY2; ++ gridY) \
+        for (ActorGridCIter cell = mGrid.lower_bound(getGridKey( \
+            getGridCoord(x1), gridY)), cell_end = mGrid.upper_bound( \
+            getGridKey(getGridCoord(x2), gridY)); \
+            cell != cell_end; ++ cell) \
+            for (ActorSpritesConstIterator it = (*cell).second.begin(), \
+                it_end = (*cell).second.end(); it != it_end; ++ it)
+
 ActorManager *actorManager = nullptr;
 
+namespace
+{
+    // changed on each target filters rebuild of any actor manager
+    int targetFiltersGeneration = 0;
+
+    // grid block size in tiles
+    const int GRID_BLOCK_TILES = 8;
+    // max distance in tiles between being pixel position and tile position
+    // (walking and height offsets). Actors what reach farther kept in
+    // oversized actors list.
+    const int GRID_MARGIN = 4;
+
+    int getGridCoord(const int tile) A_WARN_UNUSED;
+    int getGridCoord(const int tile)
+    {
+        if (tile < 0)
+            return 0;
+        return std::min(tile / GRID_BLOCK_TILES, 0xffff);
+    }
+
+    int getGridKey(const int gridX, const int gridY) A_WARN_UNUSED;
+    int getGridKey(const int gridX, const int gridY)
+    {
+        return (gridY << 16) + gridX;
+    }
+
+    int getGridKey(const ActorSprite *const actor) A_WARN_UNUSED;
+    int getGridKey(const ActorSprite *const actor)
+    {
+        return getGridKey(getGridCoord(actor->getTileX()),
+            getGridCoord(actor->getTileY()));
+    }
+}  // namespace
+
 class FindBeingFunctor final
 {
     public:
@@ -108,21 +155,14 @@ class SortBeingFunctor final
             if (!being1 || !being2)
                 return false;
 
-            if (priorityBeings)
+            const TargetFilter *filter1 = nullptr;
+            const TargetFilter *filter2 = nullptr;
+            if (filters)
             {
-                int w1 = defaultPriorityIndex;
-                int w2 = defaultPriorityIndex;
-                const std::map<std::string, int>::const_iterator it1
-                    = priorityBeings->find(being1->getName());
-                const std::map<std::string, int>::const_iterator it2
-                    = priorityBeings->find(being2->getName());
-                if (it1 != priorityBeings->end())
-                    w1 = (*it1).second;
-                if (it2 != priorityBeings->end())
-                    w2 = (*it2).second;
-
-                if (w1 != w2)
-                    return w1 < w2;
+                filter1 = &getFilter(being1);
+                filter2 = &getFilter(being2);
+                if (filter1->priorityIndex != filter2->priorityIndex)
+                    return filter1->priorityIndex < filter2->priorityIndex;
             }
             if (being1->getDistance() != being2->getDistance())
             {
@@ -148,31 +188,29 @@ class SortBeingFunctor final
 
             if (d1 != d2)
                 return d1 < d2;
-            if (attackBeings)
-            {
-                int w1 = defaultAttackIndex;
-                int w2 = defaultAttackIndex;
-                const std::map<std::string, int>::const_iterator it1
-                    = attackBeings->find(being1->getName());
-                const std::map<std::string, int>::const_iterator it2
-                    = attackBeings->find(being2->getName());
-                if (it1 != attackBeings->end())
-                    w1 = (*it1).second;
-                if (it2 != attackBeings->end())
-                    w2 = (*it2).second;
-
-                if (w1 != w2)
-                    return w1 < w2;
-            }
+            if (filters && filter1->attackIndex != filter2->attackIndex)
+                return filter1->attackIndex < filter2->attackIndex;
 
             return (being1->getName() < being2->getName());
         }
-        std::map<std::string, int> *attackBeings;
-        std::map<std::string, int> *priorityBeings;
+
+        const TargetFilter &getFilter(const Being *const being) const
+        {
+            const TargetFilter *const filter = being->getTargetFilter(
+                generation);
+            if (filter)
+                return *filter;
+            const TargetFiltersCIter it = filters->find(being->getName());
+            if (it != filters->end())
+                return (*it).second;
+            return *defaultFilter;
+        }
+
+        const TargetFilters *filters;
+        const TargetFilter *defaultFilter;
+        int generation;
         int x;
         int y;
-        int defaultAttackIndex;
-        int defaultPriorityIndex;
         int attackRange;
         bool specialDistance;
 } beingActorSorter;
@@ -180,6 +218,16 @@ class SortBeingFunctor final
 ActorManager::ActorManager() :
     mActors(),
     mDeleteActors(),
+    mActorSlots(),
+    mFreeActorSlots(),
+    mBeingIds(),
+    mItemIds(),
+    mGrid(),
+    mOversizedActors(),
+    mPixelActors(),
+    mTargetFilters(),
+    mDefaultTargetFilter(),
+    mSortedBeings(),
     mBlockedBeings(),
     mMap(nullptr),
     mSpellHeal1(serverConfig.getValue("spellHeal1", "#lum")),
@@ -190,7 +238,8 @@ ActorManager::ActorManager() :
     mCyclePlayers(config.getBoolValue("cyclePlayers")),
     mCycleMonsters(config.getBoolValue("cycleMonsters")),
     mCycleNPC(config.getBoolValue("cycleNPC")),
-    mExtMouseTargeting(config.getBoolValue("extMouseTargeting"))
+    mExtMouseTargeting(config.getBoolValue("extMouseTargeting")),
+    mEnableAttackFilter(config.getBoolValue("enableAttackFilter"))
 {
     config.addListener("targetDeadPlayers", this);
     config.addListener("targetOnlyReachable", this);
@@ -198,6 +247,7 @@ ActorManager::ActorManager() :
     config.addListener("cycleMonsters", this);
     config.addListener("cycleNPC", this);
     config.addListener("extMouseTargeting", this);
+    config.addListener("enableAttackFilter", this);
 
     loadAttackList();
 }
@@ -222,6 +272,11 @@ void ActorManager::setPlayer(LocalPlayer *const player)
 {
     player_node = player;
     mActors.insert(player);
+    if (player)
+    {
+        addToRegistry(player);
+        addToGrid(player);
+    }
     if (socialWindow)
         socialWindow->updateAttackFilter();
     if (socialWindow)
@@ -235,6 +290,9 @@ Being *ActorManager::createBeing(const int id,
     Being *const being = new Being(id, type, subtype, mMap);
 
     mActors.insert(being);
+    addToRegistry(being);
+    addToIndex(being);
+    addToGrid(being);
     return being;
 }
 
@@ -251,6 +309,9 @@ FloorItem *ActorManager::createItem(const int id, const int itemId,
     if (!checkForPickup(floorItem))
         floorItem->disableHightlight();
     mActors.insert(floorItem);
+    addToRegistry(floorItem);
+    addToIndex(floorItem);
+    addToGrid(floorItem);
     return floorItem;
 }
 
@@ -268,6 +329,83 @@ void ActorManager::erase(ActorSprite *const actor)
         return;
 
     mActors.erase(actor);
+    removeFromRegistry(actor);
+    removeFromIndex(actor);
+    removeFromGrid(actor);
+}
+
+void ActorManager::addToRegistry(ActorSprite *const actor)
+{
+    // handle can be left from other manager, like for local player
+    if (findActor(actor->getActorHandle()) == actor)
+        return;
+    if (mFreeActorSlots.empty())
+    {
+        actor->setActorHandle(static_cast<int>(mActorSlots.size()));
+        mActorSlots.push_back(actor);
+    }
+    else
+    {
+        const int handle = mFreeActorSlots.back();
+        mFreeActorSlots.pop_back();
+        actor->setActorHandle(handle);
+        mActorSlots[static_cast<size_t>(handle)] = actor;
+    }
+}
+
+void ActorManager::removeFromRegistry(ActorSprite *const actor)
+{
+    const int handle = actor->getActorHandle();
+    if (findActor(handle) != actor)
+        return;
+    mActorSlots[static_cast<size_t>(handle)] = nullptr;
+    mFreeActorSlots.push_back(handle);
+    actor->setActorHandle(-1);
+}
+
+ActorSprite *ActorManager::findActor(const int handle) const
+{
+    if (handle < 0 || static_cast<size_t>(handle) >= mActorSlots.size())
+        return nullptr;
+    return mActorSlots[static_cast<size_t>(handle)];
+}
+
+void ActorManager::addToIndex(ActorSprite *const actor)
+{
+    if (actor->getType() == ActorType::FLOOR_ITEM)
+        mItemIds.insert(std::pair<int, ActorSprite*>(actor->getId(), actor));
+    else
+        mBeingIds.insert(std::pair<int, ActorSprite*>(actor->getId(), actor));
+}
+
+void ActorManager::removeFromIndex(const ActorSprite *const actor)
+{
+    ActorIdIndex &index = actor->getType() == ActorType::FLOOR_ITEM
+        ? mItemIds : mBeingIds;
+    const std::pair<ActorIdIndexIter, ActorIdIndexIter> range
+        = index.equal_range(actor->getId());
+    for (ActorIdIndexIter it = range.first; it != range.second; ++ it)
+    {
+        if ((*it).second == actor)
+        {
+            index.erase(it);
+            return;
+        }
+    }
+}
+
+ActorSprite *ActorManager::findInIndex(const ActorIdIndex &index,
+                                       const int id)
+{
+    // new actor inserted after old one with same id, which can wait
+    // for deletion, so newest actor is last in equal range
+    ActorIdIndexCIter it = index.upper_bound(id);
+    if (it == index.begin())
+        return nullptr;
+    -- it;
+    if ((*it).first != id)
+        return nullptr;
+    return (*it).second;
 }
 
 void ActorManager::undelete(const ActorSprite *const actor)
@@ -287,17 +425,11 @@ void ActorManager::undelete(const ActorSprite *const actor)
 
 Being *ActorManager::findBeing(const int id) const
 {
-    for_actors
-    {
-        ActorSprite *const actor = *it;
-        if (actor->getId() == id &&
-            actor->getType() != ActorType::FLOOR_ITEM)
-        {
-            return static_cast<Being*>(actor);
-        }
-    }
+    // local player id can change after adding, so it not indexed
+    if (player_node && player_node->getId() == id)
+        return player_node;
 
-    return nullptr;
+    return static_cast<Being*>(findInIndex(mBeingIds, id));
 }
 
 Being *ActorManager::findBeing(const int x, const int y,
@@ -307,10 +439,14 @@ Being *ActorManager::findBeing(const int x, const int y,
     beingActorFinder.y = static_cast<uint16_t>(y);
     beingActorFinder.type = type;
 
-    const ActorSpritesConstIterator it = std::find_if(
-        mActors.begin(), mActors.end(), beingActorFinder);
+    for_grid(x - GRID_MARGIN, y - GRID_MARGIN,
+        x + GRID_MARGIN, y + GRID_MARGIN + 1)
+    {
+        if (beingActorFinder(*it))
+            return static_cast<Being*>(*it);
+    }
 
-    return (it == mActors.end()) ? nullptr : static_cast<Being*>(*it);
+    return nullptr;
 }
 
 Being *ActorManager::findBeingByPixel(const int x, const int y,
@@ -322,13 +458,17 @@ Being *ActorManager::findBeingByPixel(const int x, const int y,
     const bool targetDead = mTargetDeadPlayers;
     const bool modActive = inputManager.isActionActive(
         InputAction::STOP_ATTACK);
+    const int tileX = x / mapTileSize;
+    const int tileY = y / mapTileSize;
 
     if (mExtMouseTargeting)
     {
         Being *tempBeing = nullptr;
         bool noBeing(false);
 
-        for_actorsm
+        const std::vector<ActorSprite*> &actors
+            = getPixelActors(tileX, tileY);
+        FOR_EACH (std::vector<ActorSprite*>::const_iterator, it, actors)
         {
             if (!*it)
                 continue;
@@ -391,7 +531,9 @@ Being *ActorManager::findBeingByPixel(const int x, const int y,
     }
     else
     {
-        for_actorsm
+        const std::vector<ActorSprite*> &actors
+            = getPixelActors(tileX, tileY);
+        FOR_EACH (std::vector<ActorSprite*>::const_iterator, it, actors)
         {
             if (!*it)
                 continue;
@@ -433,8 +575,11 @@ void ActorManager::findBeingsByPixel(std::vector<ActorSprite*> &beings,
     const int uptol = mapTileSize;
     const bool modActive = inputManager.isActionActive(
         InputAction::STOP_ATTACK);
+    const int tileX = x / mapTileSize;
+    const int tileY = y / mapTileSize;
 
-    for_actors
+    const std::vector<ActorSprite*> &actors = getPixelActors(tileX, tileY);
+    FOR_EACH (std::vector<ActorSprite*>::const_iterator, it, actors)
     {
         if (!*it)
             continue;
@@ -473,7 +618,7 @@ Being *ActorManager::findPortalByTile(const int x, const int y) const
     if (!mMap)
         return nullptr;
 
-    for_actorsm
+    for_grid(x, y, x, y)
     {
         if (!*it)
             continue;
@@ -492,24 +637,12 @@ Being *ActorManager::findPortalByTile(const int x, const int y) const
 
 FloorItem *ActorManager::findItem(const int id) const
 {
-    for_actorsm
-    {
-        if (!*it)
-            continue;
-
-        if ((*it)->getId() == id &&
-            (*it)->getType() == ActorType::FLOOR_ITEM)
-        {
-            return static_cast<FloorItem*>(*it);
-        }
-    }
-
-    return nullptr;
+    return static_cast<FloorItem*>(findInIndex(mItemIds, id));
 }
 
 FloorItem *ActorManager::findItem(const int x, const int y) const
 {
-    for_actorsm
+    for_grid(x, y, x, y)
     {
         if (!*it)
             continue;
@@ -535,7 +668,7 @@ bool ActorManager::pickUpAll(const int x1, const int y1,
     const bool allowAll = mPickupItemsSet.find("") != mPickupItemsSet.end();
     if (!serverBuggy)
     {
-        for_actorsm
+        for_grid(x1, y1, x2, y2)
         {
             if (!*it)
                 continue;
@@ -570,7 +703,7 @@ bool ActorManager::pickUpAll(const int x1, const int y1,
     {
         FloorItem *item = nullptr;
         unsigned cnt = 65535;
-        for_actorsm
+        for_grid(x1, y1, x2, y2)
         {
             if (!*it)
                 continue;
@@ -627,12 +760,16 @@ bool ActorManager::pickUpNearest(const int x, const int y,
     if (!player_node)
         return false;
 
+    const int x1 = x - maxdist;
+    const int y1 = y - maxdist;
+    const int x2 = x + maxdist;
+    const int y2 = y + maxdist;
     maxdist = maxdist * maxdist;
     FloorItem *closestItem = nullptr;
     int dist = 0;
     const bool allowAll = mPickupItemsSet.find("") != mPickupItemsSet.end();
 
-    for_actorsm
+    for_grid(x1, y1, x2, y2)
     {
         if (!*it)
             continue;
@@ -749,6 +886,93 @@ Being *ActorManager::findNearestByName(const std::string &name,
     return closestBeing;
 }
 
+void ActorManager::addToGrid(ActorSprite *const actor)
+{
+    mGrid[getGridKey(actor)].insert(actor);
+    updateActorReach(actor);
+}
+
+void ActorManager::removeFromGrid(ActorSprite *const actor)
+{
+    mOversizedActors.erase(actor);
+    const ActorGridIter it = mGrid.find(getGridKey(actor));
+    if (it == mGrid.end())
+        return;
+    (*it).second.erase(actor);
+    if ((*it).second.empty())
+        mGrid.erase(it);
+}
+
+void ActorManager::moveActor(ActorSprite *const actor,
+                             const int x, const int y)
+{
+    const int newKey = getGridKey(getGridCoord(x), getGridCoord(y));
+    const int oldKey = getGridKey(actor);
+    if (newKey == oldKey)
+        return;
+
+    const ActorGridIter it = mGrid.find(oldKey);
+    if (it == mGrid.end())
+        return;
+    // actors not added to manager must not be added to grid
+    if (!(*it).second.erase(actor))
+        return;
+    if ((*it).second.empty())
+        mGrid.erase(it);
+    mGrid[newKey].insert(actor);
+}
+
+void ActorManager::updateActorReach(ActorSprite *const actor)
+{
+    const int dx = abs(actor->getPixelX() / mapTileSize - actor->getTileX());
+    const int dy = abs(actor->getPixelY() / mapTileSize - actor->getTileY());
+    const int extent = std::max(actor->getWidth(), actor->getHeight())
+        / mapTileSize;
+    if (std::max(dx, dy) + extent <= GRID_MARGIN)
+    {
+        if (!mOversizedActors.empty())
+            mOversizedActors.erase(actor);
+        return;
+    }
+    if (mOversizedActors.find(actor) != mOversizedActors.end())
+        return;
+    // actors not added to manager must not be added to list
+    if (mActors.find(actor) != mActors.end())
+        mOversizedActors.insert(actor);
+}
+
+const std::vector<ActorSprite*> &ActorManager::getPixelActors(
+    const int tileX, const int tileY) const
+{
+    mPixelActors.clear();
+    for_grid(tileX - GRID_MARGIN, tileY - GRID_MARGIN,
+        tileX + GRID_MARGIN, tileY + GRID_MARGIN)
+    {
+        if (mOversizedActors.empty()
+            || mOversizedActors.find(*it) == mOversizedActors.end())
+        {
+            mPixelActors.push_back(*it);
+        }
+    }
+    mPixelActors.insert(mPixelActors.end(), mOversizedActors.begin(),
+        mOversizedActors.end());
+    return mPixelActors;
+}
+
+int ActorManager::getGridFirstRow() const
+{
+    if (mGrid.empty())
+        return 0;
+    return (*mGrid.begin()).first >> 16;
+}
+
+int ActorManager::getGridLastRow() const
+{
+    if (mGrid.empty())
+        return -1;
+    return (*mGrid.rbegin()).first >> 16;
+}
+
 const ActorSprites &ActorManager::getAll() const
 {
     return mActors;
@@ -757,10 +981,12 @@ const ActorSprites &ActorManager::getAll() const
 void ActorManager::logic()
 {
     BLOCK_START("ActorManager::logic")
-    for_actors
+    // slots contiguous, and index loop allow actors added from logic
+    for (size_t f = 0; f < mActorSlots.size(); f ++)
     {
-        if (*it)
-            (*it)->logic();
+        ActorSprite *const actor = mActorSlots[f];
+        if (actor)
+            actor->logic();
     }
 
     if (mDeleteActors.empty())
@@ -797,6 +1023,9 @@ void ActorManager::logic()
     {
         ActorSprite *actor = *it;
         mActors.erase(actor);
+        removeFromRegistry(actor);
+        removeFromIndex(actor);
+        removeFromGrid(actor);
         delete actor;
     }
 
@@ -821,9 +1050,19 @@ void ActorManager::clear()
         delete *it;
     mActors.clear();
     mDeleteActors.clear();
+    mBeingIds.clear();
+    mItemIds.clear();
+    mGrid.clear();
+    mOversizedActors.clear();
+    mActorSlots.clear();
+    mFreeActorSlots.clear();
 
     if (player_node)
+    {
         mActors.insert(player_node);
+        addToRegistry(player_node);
+        addToGrid(player_node);
+    }
 }
 
 Being *ActorManager::findNearestLivingBeing(const int x, const int y,
@@ -867,13 +1106,6 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
     if (!aroundBeing || !player_node)
         return nullptr;
 
-    std::set<std::string> attackMobs;
-    std::set<std::string> priorityMobs;
-    std::set<std::string> ignoreAttackMobs;
-    std::map<std::string, int> attackMobsMap;
-    std::map<std::string, int> priorityMobsMap;
-    int defaultAttackIndex = 10000;
-    int defaultPriorityIndex = 10000;
     const int attackRange = player_node->getAttackRange();
 
     bool specialDistance = false;
@@ -883,6 +1115,9 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
         specialDistance = true;
     }
 
+    // path distance used for reachable monsters not limited by tiles radius
+    const int radius = (mTargetOnlyReachable && (type == ActorType::MONSTER
+        || type == ActorType::UNKNOWN)) ? -1 : maxDist;
     maxDist = maxDist * maxDist;
 
     const bool cycleSelect = allowSort
@@ -891,37 +1126,20 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
         || (mCycleNPC && type == ActorType::NPC));
 
     const bool filtered = allowSort
-        && config.getBoolValue("enableAttackFilter")
+        && mEnableAttackFilter
         && type == ActorType::MONSTER;
     const bool modActive = inputManager.isActionActive(
         InputAction::STOP_ATTACK);
 
-    bool ignoreDefault = false;
     if (filtered)
     {
-        attackMobs = mAttackMobsSet;
-        priorityMobs = mPriorityAttackMobsSet;
-        ignoreAttackMobs = mIgnoreAttackMobsSet;
-        attackMobsMap = mAttackMobsMap;
-        priorityMobsMap = mPriorityAttackMobsMap;
-        beingActorSorter.attackBeings = &attackMobsMap;
-        beingActorSorter.priorityBeings = &priorityMobsMap;
         beingActorSorter.specialDistance = specialDistance;
         beingActorSorter.attackRange = attackRange;
-        if (ignoreAttackMobs.find("") != ignoreAttackMobs.end())
-            ignoreDefault = true;
-        std::map<std::string, int>::const_iterator
-            itr = attackMobsMap.find("");
-        if (itr != attackMobsMap.end())
-            defaultAttackIndex = (*itr).second;
-        itr = priorityMobsMap.find("");
-        if (itr != priorityMobsMap.end())
-            defaultPriorityIndex = (*itr).second;
     }
 
     if (cycleSelect)
     {
-        std::vector<Being*> sortedBeings;
+        mSortedBeings.clear();
 
         FOR_EACH (ActorSprites::iterator, i, mActors)
         {
@@ -936,20 +1154,8 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
 
             Being *const being = static_cast<Being*>(*i);
 
-            if (filtered)
-            {
-                if (ignoreAttackMobs.find(being->getName())
-                    != ignoreAttackMobs.end())
-                {
-                    continue;
-                }
-                if (ignoreDefault && attackMobs.find(being->getName())
-                    == attackMobs.end() && priorityMobs.find(being->getName())
-                    == priorityMobs.end())
-                {
-                    continue;
-                }
-            }
+            if (filtered && getTargetFilter(being).ignore)
+                continue;
 
             if (being->getInfo()
                 && !(being->getInfo()->isTargetSelection() || modActive))
@@ -960,38 +1166,35 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
             if (validateBeing(aroundBeing, being, type, nullptr, maxDist))
             {
                 if (being != excluded)
-                    sortedBeings.push_back(being);
+                    mSortedBeings.push_back(being);
             }
         }
 
         // no selectable beings
-        if (sortedBeings.empty())
+        if (mSortedBeings.empty())
             return nullptr;
 
         beingActorSorter.x = x;
         beingActorSorter.y = y;
         if (filtered)
         {
-            beingActorSorter.attackBeings = &attackMobsMap;
-            beingActorSorter.defaultAttackIndex = defaultAttackIndex;
-            beingActorSorter.priorityBeings = &priorityMobsMap;
-            beingActorSorter.defaultPriorityIndex = defaultPriorityIndex;
+            beingActorSorter.filters = &mTargetFilters;
+            beingActorSorter.defaultFilter = &mDefaultTargetFilter;
+            beingActorSorter.generation = targetFiltersGeneration;
         }
         else
         {
-            beingActorSorter.attackBeings = nullptr;
-            beingActorSorter.priorityBeings = nullptr;
-        }
-        std::sort(sortedBeings.begin(), sortedBeings.end(), beingActorSorter);
-        if (filtered)
-        {
-            beingActorSorter.attackBeings = nullptr;
-            beingActorSorter.priorityBeings = nullptr;
+            beingActorSorter.filters = nullptr;
+            beingActorSorter.defaultFilter = nullptr;
         }
+        std::sort(mSortedBeings.begin(), mSortedBeings.end(),
+            beingActorSorter);
+        beingActorSorter.filters = nullptr;
+        beingActorSorter.defaultFilter = nullptr;
 
         if (player_node->getTarget() == nullptr)
         {
-            Being *const target = sortedBeings.at(0);
+            Being *const target = mSortedBeings.at(0);
 
             if (specialDistance && target->getType() == ActorType::MONSTER
                 && target->getDistance() <= 2)
@@ -1004,12 +1207,13 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
 
         beingEqualActorFinder.findBeing = player_node->getTarget();
         std::vector<Being*>::const_iterator i = std::find_if(
-            sortedBeings.begin(), sortedBeings.end(), beingEqualActorFinder);
+            mSortedBeings.begin(), mSortedBeings.end(),
+            beingEqualActorFinder);
 
-        if (i == sortedBeings.end() || ++i == sortedBeings.end())
+        if (i == mSortedBeings.end() || ++i == mSortedBeings.end())
         {
             // if no selected being in vector, return first nearest being
-            return sortedBeings.at(0);
+            return mSortedBeings.at(0);
         }
 
         // we find next being after target
@@ -1018,35 +1222,38 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
     else
     {
         int dist = 0;
-        int index = defaultPriorityIndex;
+        int index = mDefaultTargetFilter.priorityIndex;
         Being *closestBeing = nullptr;
 
-        FOR_EACH (ActorSprites::iterator, i, mActors)
+        // beings outside of radius never pass distance check
+        int x1 = 0;
+        int y1 = 0;
+        int x2 = INT_MAX;
+        int y2 = INT_MAX;
+        if (radius >= 0)
         {
-            if (!*i)
+            x1 = x - radius;
+            y1 = y - radius;
+            x2 = x + radius;
+            y2 = y + radius;
+        }
+
+        for_grid(x1, y1, x2, y2)
+        {
+            if (!*it)
                 continue;
 
-            if ((*i)->getType() == ActorType::FLOOR_ITEM
-                || (*i)->getType() == ActorType::PORTAL)
+            if ((*it)->getType() == ActorType::FLOOR_ITEM
+                || (*it)->getType() == ActorType::PORTAL)
             {
                 continue;
             }
-            Being *const being = static_cast<Being*>(*i);
+            Being *const being = static_cast<Being*>(*it);
 
-            if (filtered)
-            {
-                if (ignoreAttackMobs.find(being->getName())
-                    != ignoreAttackMobs.end())
-                {
-                    continue;
-                }
-                if (ignoreDefault && attackMobs.find(being->getName())
-                    == attackMobs.end() && priorityMobs.find(being->getName())
-                    == priorityMobs.end())
-                {
-                    continue;
-                }
-            }
+            const TargetFilter *const filter = filtered
+                ? &getTargetFilter(being) : nullptr;
+            if (filter && filter->ignore)
+                continue;
 
             if (being->getInfo()
                 && !(being->getInfo()->isTargetSelection() || modActive))
@@ -1073,51 +1280,26 @@ Being *ActorManager::findNearestLivingBeing(const Being *const aroundBeing,
                 continue;
             }
 
-//            logger->log("being name:" + being->getName());
-//            logger->log("index:" + toString(index));
-//            logger->log("d:" + toString(d));
+            // far being with better priority must not hide near one
+            if (radius >= 0 && d > maxDist)
+                continue;
 
-            if (!filtered && (d <= dist || !closestBeing))
-            {
-                dist = d;
-                closestBeing = being;
-            }
-            else if (filtered)
+            if (!filter)
             {
-                int w2 = defaultPriorityIndex;
-                if (closestBeing)
+                if (d <= dist || !closestBeing)
                 {
-                    const std::map<std::string, int>::const_iterator it2
-                        = priorityMobsMap.find(being->getName());
-                    if (it2 != priorityMobsMap.end())
-                        w2 = (*it2).second;
-
-                    if (w2 < index)
-                    {
-                        dist = d;
-                        closestBeing = being;
-                        index = w2;
-                        continue;
-                    }
-                    if (w2 == index && d <= dist)
-                    {
-                        dist = d;
-                        closestBeing = being;
-                        index = w2;
-                        continue;
-                    }
+                    dist = d;
+                    closestBeing = being;
                 }
-
-                if (!closestBeing)
+            }
+            else
+            {
+                const int w2 = filter->priorityIndex;
+                if (!closestBeing || w2 < index || (w2 == index && d <= dist))
                 {
                     dist = d;
                     closestBeing = being;
-                    const std::map<std::string, int>::const_iterator it1
-                        = priorityMobsMap.find(being->getName());
-                    if (it1 != priorityMobsMap.end())
-                        index = (*it1).second;
-                    else
-                        index = defaultPriorityIndex;
+                    index = w2;
                 }
             }
         }
@@ -1470,6 +1652,8 @@ void ActorManager::optionChanged(const std::string &name)
         mCycleNPC = config.getBoolValue("cycleNPC");
     else if (name == "extMouseTargeting")
         mExtMouseTargeting = config.getBoolValue("extMouseTargeting");
+    else if (name == "enableAttackFilter")
+        mEnableAttackFilter = config.getBoolValue("enableAttackFilter");
 }
 
 void ActorManager::removeAttackMob(const std::string &name)
@@ -1566,11 +1750,80 @@ void ActorManager::addIgnorePickupItem(const std::string &name)
 void ActorManager::rebuildPriorityAttackMobs()
 {
     rebuildMobsList(PriorityAttackMob);
+    rebuildTargetFilters();
 }
 
 void ActorManager::rebuildAttackMobs()
 {
     rebuildMobsList(AttackMob);
+    rebuildTargetFilters();
+}
+
+void ActorManager::rebuildTargetFilters()
+{
+    // pointers cached in beings become invalid
+    targetFiltersGeneration ++;
+    mTargetFilters.clear();
+    mDefaultTargetFilter = TargetFilter();
+    std::map<std::string, int>::const_iterator it = mAttackMobsMap.find("");
+    if (it != mAttackMobsMap.end())
+        mDefaultTargetFilter.attackIndex = (*it).second;
+    it = mPriorityAttackMobsMap.find("");
+    if (it != mPriorityAttackMobsMap.end())
+        mDefaultTargetFilter.priorityIndex = (*it).second;
+    mDefaultTargetFilter.ignore = mIgnoreAttackMobsSet.find("")
+        != mIgnoreAttackMobsSet.end();
+
+    typedef std::map<std::string, int>::const_iterator MobsMapCIter;
+    // named mobs not in attack or priority lists use default filter
+    FOR_EACH (MobsMapCIter, i, mAttackMobsMap)
+    {
+        TargetFilter &filter = mTargetFilters[(*i).first];
+        filter.attackIndex = (*i).second;
+        filter.priorityIndex = mDefaultTargetFilter.priorityIndex;
+    }
+    FOR_EACH (MobsMapCIter, i, mPriorityAttackMobsMap)
+    {
+        TargetFilter &filter = mTargetFilters[(*i).first];
+        if (mAttackMobsMap.find((*i).first) == mAttackMobsMap.end())
+            filter.attackIndex = mDefaultTargetFilter.attackIndex;
+        filter.priorityIndex = (*i).second;
+    }
+    FOR_EACH (std::set<std::string>::const_iterator, i, mIgnoreAttackMobsSet)
+    {
+        TargetFiltersIter it2 = mTargetFilters.find(*i);
+        if (it2 == mTargetFilters.end())
+        {
+            TargetFilter filter = mDefaultTargetFilter;
+            filter.ignore = true;
+            mTargetFilters[*i] = filter;
+        }
+        else
+        {
+            (*it2).second.ignore = true;
+        }
+    }
+}
+
+const TargetFilter &ActorManager::getTargetFilter(const std::string &name)
+                                                  const
+{
+    const TargetFiltersCIter it = mTargetFilters.find(name);
+    if (it != mTargetFilters.end())
+        return (*it).second;
+    return mDefaultTargetFilter;
+}
+
+const TargetFilter &ActorManager::getTargetFilter(Being *const being) const
+{
+    const TargetFilter *filter = being->getTargetFilter(
+        targetFiltersGeneration);
+    if (!filter)
+    {
+        filter = &getTargetFilter(being->getName());
+        being->setTargetFilter(filter, targetFiltersGeneration);
+    }
+    return *filter;
 }
 
 void ActorManager::rebuildPickupItems()
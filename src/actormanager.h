@@ -29,6 +29,9 @@
 
 #include "utils/stringvector.h"
 
+#include <map>
+#include <set>
+
 #include "localconsts.h"
 
 class Being;
@@ -39,6 +42,27 @@ typedef std::set<ActorSprite*> ActorSprites;
 typedef ActorSprites::iterator ActorSpritesIterator;
 typedef ActorSprites::const_iterator ActorSpritesConstIterator;
 
+/**
+ * Attack filter lists compiled for one mob name.
+ */
+struct TargetFilter final
+{
+    TargetFilter() :
+        attackIndex(10000),
+        priorityIndex(10000),
+        ignore(false)
+    {
+    }
+
+    int attackIndex;
+    int priorityIndex;
+    bool ignore;
+};
+
+typedef std::map<std::string, TargetFilter> TargetFilters;
+typedef TargetFilters::iterator TargetFiltersIter;
+typedef TargetFilters::const_iterator TargetFiltersCIter;
+
 class ActorManager final: public ConfigListener
 {
     public:
@@ -65,6 +89,12 @@ class ActorManager final: public ConfigListener
                            const ActorType::Type type,
                            const uint16_t subtype) A_WARN_UNUSED;
 
+        /**
+         * Returns actor by registry handle. Handle stays same until actor
+         * removed from manager, and can be reused after that.
+         */
+        ActorSprite *findActor(const int handle) const A_WARN_UNUSED;
+
         /**
          * Create a FloorItem and add it to the list of ActorSprites.
          */
@@ -83,6 +113,20 @@ class ActorManager final: public ConfigListener
 
         void undelete(const ActorSprite *const actor);
 
+        /**
+         * Moves actor in spatial grid. Must be called before actor
+         * tile coordinates changed.
+         */
+        void moveActor(ActorSprite *const actor,
+                       const int x, const int y);
+
+        /**
+         * Checks if actor sprite or pixel position reach farther from
+         * actor tile than pixel queries search in grid. Such actors
+         * checked by all pixel queries. Called on actor position change.
+         */
+        void updateActorReach(ActorSprite *const actor);
+
         /**
          * Returns a specific Being, by id;
          */
@@ -328,8 +372,65 @@ class ActorManager final: public ConfigListener
 
         void storeAttackList() const;
 
+        void addToRegistry(ActorSprite *const actor);
+
+        void removeFromRegistry(ActorSprite *const actor);
+
+        void addToIndex(ActorSprite *const actor);
+
+        void removeFromIndex(const ActorSprite *const actor);
+
+        void addToGrid(ActorSprite *const actor);
+
+        void removeFromGrid(ActorSprite *const actor);
+
+        int getGridFirstRow() const A_WARN_UNUSED;
+
+        int getGridLastRow() const A_WARN_UNUSED;
+
+        const std::vector<ActorSprite*> &getPixelActors(const int tileX,
+                                                        const int tileY)
+                                                        const A_WARN_UNUSED;
+
+        void rebuildTargetFilters();
+
+        const TargetFilter &getTargetFilter(const std::string &name)
+                                            const A_WARN_UNUSED;
+
+        const TargetFilter &getTargetFilter(Being *const being)
+                                            const A_WARN_UNUSED;
+
+        typedef std::multimap<int, ActorSprite*> ActorIdIndex;
+        typedef ActorIdIndex::iterator ActorIdIndexIter;
+        typedef ActorIdIndex::const_iterator ActorIdIndexCIter;
+
+        static ActorSprite *findInIndex(const ActorIdIndex &index,
+                                        const int id) A_WARN_UNUSED;
+
+        typedef std::map<int, ActorSprites> ActorGrid;
+        typedef ActorGrid::iterator ActorGridIter;
+        typedef ActorGrid::const_iterator ActorGridCIter;
+
         ActorSprites mActors;
         ActorSprites mDeleteActors;
+        // actors from mActors in contiguous slots, indexed by handle
+        std::vector<ActorSprite*> mActorSlots;
+        std::vector<int> mFreeActorSlots;
+        // actors from mActors by id, except local player
+        ActorIdIndex mBeingIds;
+        ActorIdIndex mItemIds;
+        // actors from mActors by blocks of tiles
+        ActorGrid mGrid;
+        // actors from mGrid what can be hit outside of grid margin
+        ActorSprites mOversizedActors;
+        // reused by pixel queries
+        mutable std::vector<ActorSprite*> mPixelActors;
+        // attack filter lists by mob name
+        TargetFilters mTargetFilters;
+        // attack filter for mobs not in lists
+        TargetFilter mDefaultTargetFilter;
+        // reused by findNearestLivingBeing
+        mutable std::vector<Being*> mSortedBeings;
         std::set<uint32_t> mBlockedBeings;
         Map *mMap;
         std::string mSpellHeal1;
@@ -341,6 +442,7 @@ class ActorManager final: public ConfigListener
         bool mCycleMonsters;
         bool mCycleNPC;
         bool mExtMouseTargeting;
+        bool mEnableAttackFilter;
 
 #define defVarsP(mob) \
         std::list<std::string> mPriority##mob;\
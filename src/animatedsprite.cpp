@@ -22,14 +22,12 @@
 
 #include "animatedsprite.h"
 
-#include "animationdelayload.h"
-
 #include "render/graphics.h"
 
 #include "resources/action.h"
 #include "resources/animation.h"
-#include "resources/delayedmanager.h"
 #include "resources/image.h"
+#include "resources/resourcehandle.h"
 #include "resources/resourcemanager.h"
 #include "resources/spriteaction.h"
 
@@ -51,6 +49,7 @@ AnimatedSprite::AnimatedSprite(SpriteDef *const sprite) :
     mNumber(100),
     mNumber1(100),
     mDelayLoad(nullptr),
+    mDelayedAction(SpriteActionId::STAND),
     mTerminated(false)
 {
     mAlpha = 1.0F;
@@ -74,21 +73,22 @@ AnimatedSprite *AnimatedSprite::load(const std::string &filename,
 }
 
 AnimatedSprite *AnimatedSprite::delayedLoad(const std::string &filename,
-                                            const int variant)
+                                            const int variant,
+                                            const Actor *const owner)
 {
     if (!mEnableCache)
         return load(filename, variant);
-    ResourceManager *const resman = ResourceManager::getInstance();
-    Resource *const res = resman->getFromCache(filename, variant);
-    if (res)
-    {
-        res->decRef();
-        return load(filename, variant);
-    }
 
     AnimatedSprite *const as = new AnimatedSprite(nullptr);
+    ResourceManager *const resman = ResourceManager::getInstance();
+    // reference from resource manager owned by sprite
+    SpriteDef *const s = resman->getSpriteAsync(filename, variant,
+        as, as->mDelayLoad);
+    if (s)
+        as->setSprite(s);
+    else if (as->mDelayLoad)
+        as->mDelayLoad->setOwner(owner);
     as->play(SpriteAction::STAND);
-    as->setDelayLoad(filename, variant);
     return as;
 }
 
@@ -108,12 +108,7 @@ AnimatedSprite::~AnimatedSprite()
         mSprite->decRef();
         mSprite = nullptr;
     }
-    if (mDelayLoad)
-    {
-        mDelayLoad->clearSprite();
-        DelayedManager::removeDelayLoad(mDelayLoad);
-        delete2(mDelayLoad);
-    }
+    delete2(mDelayLoad);
 }
 
 bool AnimatedSprite::reset()
@@ -132,16 +127,21 @@ bool AnimatedSprite::reset()
 }
 
 bool AnimatedSprite::play(const std::string &spriteAction)
+{
+    return play(SpriteDef::getActionId(spriteAction));
+}
+
+bool AnimatedSprite::play(const int actionId)
 {
     if (!mSprite)
     {
         if (!mDelayLoad)
             return false;
-        mDelayLoad->setAction(spriteAction);
+        mDelayedAction = actionId;
         return true;
     }
 
-    const Action *const action = mSprite->getAction(spriteAction, mNumber);
+    const Action *const action = mSprite->getAction(actionId, mNumber);
     if (!action)
         return false;
 
@@ -178,7 +178,7 @@ bool AnimatedSprite::update(const int time)
     if (!updateCurrentAnimation(dt))
     {
         // Animation finished, reset to default
-        play(SpriteAction::STAND);
+        play(SpriteActionId::STAND);
         mTerminated = true;
     }
 
@@ -411,20 +411,14 @@ bool AnimatedSprite::updateNumber(const unsigned num)
     return false;
 }
 
-void AnimatedSprite::setDelayLoad(const std::string &filename,
-                                  const int variant)
-{
-    if (mDelayLoad)
-    {
-        mDelayLoad->clearSprite();
-        DelayedManager::removeDelayLoad(mDelayLoad);
-        delete mDelayLoad;
-    }
-    mDelayLoad = new AnimationDelayLoad(filename, variant, this);
-    DelayedManager::addDelayedAnimation(mDelayLoad);
-}
-
-void AnimatedSprite::clearDelayLoad()
+void AnimatedSprite::resourceLoaded(ResourceHandle *const handle A_UNUSED,
+                                    Resource *const resource)
 {
+    // handle will be deleted by DelayedManager
     mDelayLoad = nullptr;
+    SpriteDef *const s = static_cast<SpriteDef*>(resource);
+    if (!s)
+        return;
+    setSprite(s);
+    play(mDelayedAction);
 }
@@ -25,16 +25,19 @@
 
 #include "sprite.h"
 
+#include "listeners/resourcelistener.h"
+
 #include <string>
 
+class Actor;
 class Animation;
-class AnimationDelayLoad;
 struct Frame;
 
 /**
  * Animates a sprite by adding playback state.
  */
-class AnimatedSprite final : public Sprite
+class AnimatedSprite final : public Sprite,
+                             public ResourceListener
 {
     public:
         /**
@@ -55,8 +58,14 @@ class AnimatedSprite final : public Sprite
         static AnimatedSprite *load(const std::string &filename,
                                     const int variant = 0) A_WARN_UNUSED;
 
+        /**
+         * Creates sprite what loads sprite definition later.
+         *
+         * @param owner    the actor what show sprite, used for load order
+         */
         static AnimatedSprite *delayedLoad(const std::string &filename,
-                                           const int variant = 0)
+                                           const int variant = 0,
+                                           const Actor *const owner = nullptr)
                                            A_WARN_UNUSED;
 
         static AnimatedSprite *clone(const AnimatedSprite *const anim);
@@ -67,6 +76,8 @@ class AnimatedSprite final : public Sprite
 
         bool play(const std::string &action) override final;
 
+        bool play(const int actionId) override final;
+
         bool update(const int time) override final;
 
         void draw(Graphics *const graphics,
@@ -95,7 +106,8 @@ class AnimatedSprite final : public Sprite
 
         bool updateNumber(const unsigned num);
 
-        void clearDelayLoad();
+        void resourceLoaded(ResourceHandle *const handle,
+                            Resource *const resource) override final;
 
         void setSprite(SpriteDef *const sprite)
         { mSprite = sprite; }
@@ -126,8 +138,6 @@ class AnimatedSprite final : public Sprite
     private:
         bool updateCurrentAnimation(const unsigned int dt);
 
-        void setDelayLoad(const std::string &filename, const int variant);
-
         SpriteDirection::Type mDirection;  /**< The sprite direction. */
         int mLastTime;                 /**< The last time update was called. */
 
@@ -140,7 +150,8 @@ class AnimatedSprite final : public Sprite
         const Frame *mFrame;           /**< The currently active frame. */
         unsigned mNumber;
         unsigned mNumber1;
-        AnimationDelayLoad *mDelayLoad;
+        ResourceHandle *mDelayLoad;
+        int mDelayedAction;
         bool mTerminated;
         static bool mEnableCache;
 };
@@ -29,7 +29,7 @@ Actor::Actor() :
     mMap(nullptr),
     mPos(),
     mYDiff(0),
-    mMapActor()
+    mMapIndex(-1)
 {
 }
 
@@ -37,7 +37,7 @@ Actor::~Actor()
 {
     if (mMap)
     {
-        mMap->removeActor(mMapActor);
+        mMap->removeActor(this);
         mMap = nullptr;
     }
 }
@@ -46,13 +46,13 @@ void Actor::setMap(Map *const map)
 {
     // Remove Actor from potential previous map
     if (mMap)
-        mMap->removeActor(mMapActor);
+        mMap->removeActor(this);
 
     mMap = map;
 
     // Add Actor to potential new map
     if (mMap)
-        mMapActor = mMap->addActor(this);
+        mMap->addActor(this);
 }
 
 int Actor::getTileX() const
@@ -66,6 +66,7 @@ ActorSprite::ActorSprite(const int id) :
     mStatusParticleEffects(&mStunParticleEffects, false),
     mChildParticleEffects(&mStatusParticleEffects, false),
     mId(id),
+    mActorHandle(-1),
     mStunMode(0),
     mUsedTargetCursor(nullptr),
     mActorSpriteListeners(),
@@ -257,7 +258,7 @@ void ActorSprite::setupSpriteDisplay(const SpriteDisplay &display,
             combineDye3((*it)->sprite, color));
 
         const int variant = (*it)->variant;
-        addSprite(AnimatedSprite::delayedLoad(file, variant));
+        addSprite(AnimatedSprite::delayedLoad(file, variant, this));
     }
 
     // Ensure that something is shown, if desired
@@ -267,7 +268,7 @@ void ActorSprite::setupSpriteDisplay(const SpriteDisplay &display,
         {
             addSprite(AnimatedSprite::delayedLoad(
                 paths.getStringValue("sprites").append(
-                paths.getStringValue("spriteErrorFile"))));
+                paths.getStringValue("spriteErrorFile")), 0, this));
         }
         else
         {
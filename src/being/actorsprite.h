@@ -60,6 +60,15 @@ public:
     void setId(const int id)
     { mId = id; }
 
+    /**
+     * Returns slot in ActorManager registry, or -1 if not registered.
+     */
+    int getActorHandle() const A_WARN_UNUSED
+    { return mActorHandle; }
+
+    void setActorHandle(const int handle)
+    { mActorHandle = handle; }
+
     /**
      * Returns the type of the ActorSprite.
      */
@@ -202,6 +211,7 @@ protected:
     ParticleVector mStatusParticleEffects;
     ParticleList mChildParticleEffects;
     int mId;
+    int mActorHandle;
     uint16_t mStunMode;               /**< Stun mode; zero if not stunned */
 
 private:
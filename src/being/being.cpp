@@ -113,6 +113,17 @@ bool Being::mMoveNames = false;
 bool Being::mUseDiagonal = true;
 int Being::mAwayEffect = -1;
 
+namespace
+{
+    // attack actions from items and monsters can be empty
+    int getActionId(const std::string &action)
+    {
+        if (action.empty())
+            return SpriteActionId::INVALID;
+        return SpriteDef::getActionId(action);
+    }
+}  // namespace
+
 std::list<BeingCacheEntry*> beingInfoCache;
 typedef std::map<int, Guild*>::const_iterator GuildsMapCIter;
 typedef std::map<int, int>::const_iterator IntMapCIter;
@@ -126,7 +137,9 @@ Being::Being(const int id,
     mInfo(BeingInfo::unknown),
     mEmotionSprite(nullptr),
     mAnimationEffect(nullptr),
-    mSpriteAction(SpriteAction::STAND),
+    mSpriteActionId(SpriteActionId::STAND),
+    mTargetFilter(nullptr),
+    mTargetFilterGeneration(0),
     mName(),
     mRaceName(),
     mPartyName(),
@@ -371,6 +384,8 @@ void Being::setPosition(const Vector &pos)
     Actor::setPosition(pos);
 
     updateCoords();
+    if (actorManager)
+        actorManager->updateActorReach(this);
 
     if (mText)
     {
@@ -828,6 +843,8 @@ void Being::handleSkill(Being *const victim, const int damage,
 
 void Being::setName(const std::string &name)
 {
+    // attack filter selected by name
+    mTargetFilter = nullptr;
     if (mType == ActorType::NPC)
     {
         mName = name.substr(0, name.find('#', 0));
@@ -1029,11 +1046,11 @@ void Being::fireMissile(Being *const victim, const std::string &particle) const
     }
 }
 
-std::string Being::getSitAction() const
+int Being::getSitAction() const
 {
     if (serverVersion < 0)
     {
-        return SpriteAction::SIT;
+        return SpriteActionId::SIT;
     }
     else
     {
@@ -1041,22 +1058,22 @@ std::string Being::getSitAction() const
         {
             const unsigned char mask = mMap->getBlockMask(mX, mY);
             if (mask & BlockMask::GROUNDTOP)
-                return SpriteAction::SITTOP;
+                return SpriteActionId::SITTOP;
             else if (mask & BlockMask::AIR)
-                return SpriteAction::SITSKY;
+                return SpriteActionId::SITSKY;
             else if (mask & BlockMask::WATER)
-                return SpriteAction::SITWATER;
+                return SpriteActionId::SITWATER;
         }
-        return SpriteAction::SIT;
+        return SpriteActionId::SIT;
     }
 }
 
 
-std::string Being::getMoveAction() const
+int Being::getMoveAction() const
 {
     if (serverVersion < 0)
     {
-        return SpriteAction::MOVE;
+        return SpriteActionId::MOVE;
     }
     else
     {
@@ -1064,22 +1081,22 @@ std::string Being::getMoveAction() const
         {
             const unsigned char mask = mMap->getBlockMask(mX, mY);
             if (mask & BlockMask::AIR)
-                return SpriteAction::FLY;
+                return SpriteActionId::FLY;
             else if (mask & BlockMask::WATER)
-                return SpriteAction::SWIM;
+                return SpriteActionId::SWIM;
         }
-        return SpriteAction::MOVE;
+        return SpriteActionId::MOVE;
     }
 }
 
-std::string Being::getWeaponAttackAction(const ItemInfo *const weapon) const
+int Being::getWeaponAttackAction(const ItemInfo *const weapon) const
 {
     if (!weapon)
-        return SpriteAction::ATTACK;
+        return SpriteActionId::ATTACK;
 
     if (serverVersion < 0)
     {
-        return weapon->getAttackAction();
+        return getActionId(weapon->getAttackAction());
     }
     else
     {
@@ -1087,22 +1104,22 @@ std::string Being::getWeaponAttackAction(const ItemInfo *const weapon) const
         {
             const unsigned char mask = mMap->getBlockMask(mX, mY);
             if (mask & BlockMask::AIR)
-                return weapon->getSkyAttackAction();
+                return getActionId(weapon->getSkyAttackAction());
             else if (mask & BlockMask::WATER)
-                return weapon->getWaterAttackAction();
+                return getActionId(weapon->getWaterAttackAction());
         }
-        return weapon->getAttackAction();
+        return getActionId(weapon->getAttackAction());
     }
 }
 
-std::string Being::getAttackAction(const Attack *const attack1) const
+int Being::getAttackAction(const Attack *const attack1) const
 {
     if (!attack1)
-        return SpriteAction::ATTACK;
+        return SpriteActionId::ATTACK;
 
     if (serverVersion < 0)
     {
-        return attack1->mAction;
+        return getActionId(attack1->mAction);
     }
     else
     {
@@ -1110,20 +1127,20 @@ std::string Being::getAttackAction(const Attack *const attack1) const
         {
             const unsigned char mask = mMap->getBlockMask(mX, mY);
             if (mask & BlockMask::AIR)
-                return attack1->mSkyAction;
+                return getActionId(attack1->mSkyAction);
             else if (mask & BlockMask::WATER)
-                return attack1->mWaterAction;
+                return getActionId(attack1->mWaterAction);
         }
-        return attack1->mAction;
+        return getActionId(attack1->mAction);
     }
 }
 
 #define getSpriteAction(func, action) \
-    std::string Being::get##func##Action() const \
+    int Being::get##func##Action() const \
 { \
     if (serverVersion < 0) \
     { \
-        return SpriteAction::action; \
+        return SpriteActionId::action; \
     } \
     else \
     { \
@@ -1131,11 +1148,11 @@ std::string Being::getAttackAction(const Attack *const attack1) const
         { \
             const unsigned char mask = mMap->getBlockMask(mX, mY); \
             if (mask & BlockMask::AIR) \
-                return SpriteAction::action##SKY; \
+                return SpriteActionId::action##SKY; \
             else if (mask & BlockMask::WATER) \
-                return SpriteAction::action##WATER; \
+                return SpriteActionId::action##WATER; \
         } \
-        return SpriteAction::action; \
+        return SpriteActionId::action; \
     } \
 }
 
@@ -1145,7 +1162,7 @@ getSpriteAction(Spawn, SPAWN)
 
 void Being::setAction(const BeingAction::Action &action, const int attackId)
 {
-    std::string currentAction = SpriteAction::INVALID;
+    int currentAction = SpriteActionId::INVALID;
 
     switch (action)
     {
@@ -1165,7 +1182,7 @@ void Being::setAction(const BeingAction::Action &action, const int attackId)
             if (mInfo)
             {
                 ItemSoundEvent::Type event;
-                if (currentAction == SpriteAction::SITTOP)
+                if (currentAction == SpriteActionId::SITTOP)
                     event = ItemSoundEvent::SITTOP;
                 else
                     event = ItemSoundEvent::SIT;
@@ -1249,20 +1266,20 @@ void Being::setAction(const BeingAction::Action &action, const int attackId)
             break;
     }
 
-    if (currentAction != SpriteAction::INVALID)
+    if (currentAction != SpriteActionId::INVALID)
     {
-        mSpriteAction = currentAction;
-        play(currentAction);
+        mSpriteActionId = currentAction;
+        play(mSpriteActionId);
         if (mEmotionSprite)
-            mEmotionSprite->play(currentAction);
+            mEmotionSprite->play(mSpriteActionId);
         if (mAnimationEffect)
-            mAnimationEffect->play(currentAction);
+            mAnimationEffect->play(mSpriteActionId);
         mAction = action;
     }
 
-    if (currentAction != SpriteAction::MOVE
-        && currentAction != SpriteAction::FLY
-        && currentAction != SpriteAction::SWIM)
+    if (currentAction != SpriteActionId::MOVE
+        && currentAction != SpriteActionId::FLY
+        && currentAction != SpriteActionId::SWIM)
     {
         mActionTime = tick_time;
     }
@@ -1380,7 +1397,11 @@ void Being::nextTile()
     }
 
     if (mX != pos.x || mY != pos.y)
+    {
         mOldHeight = mMap->getHeightOffset(mX, mY);
+        if (actorManager)
+            actorManager->moveActor(this, pos.x, pos.y);
+    }
     mX = pos.x;
     mY = pos.y;
     const uint8_t height = mMap->getHeightOffset(mX, mY);
@@ -2072,7 +2093,7 @@ void Being::setSprite(const unsigned int slot, const int id,
 
             equipmentSprite = AnimatedSprite::delayedLoad(
                 paths.getStringValue("sprites").append(
-                combineDye(filename, color)));
+                combineDye(filename, color)), 0, this);
         }
 
         if (equipmentSprite)
@@ -3016,7 +3037,7 @@ void Being::setEmote(const uint8_t emotion, const int emote_time)
 
         if (mEmotionSprite)
         {
-            mEmotionSprite->play(mSpriteAction);
+            mEmotionSprite->play(mSpriteActionId);
             mEmotionSprite->setSpriteDirection(
                 static_cast<SpriteDirection::Type>(mSpriteDirection));
         }
@@ -3335,6 +3356,8 @@ void Being::setLook(const uint8_t look)
 
 void Being::setTileCoords(const int x, const int y)
 {
+    if (actorManager)
+        actorManager->moveActor(this, x, y);
     mX = x;
     mY = y;
     if (mMap)
@@ -62,6 +62,7 @@ class SpeechBubble;
 class Text;
 
 struct ParticleInfo;
+struct TargetFilter;
 
 extern volatile int cur_time;
 
@@ -242,6 +243,24 @@ class Being notfinal : public ActorSprite,
          */
         void setName(const std::string &name);
 
+        /**
+         * Returns attack filter cached by ActorManager, or nullptr if
+         * filters was rebuilt after caching.
+         */
+        const TargetFilter *getTargetFilter(const int generation) const
+                                            A_WARN_UNUSED
+        {
+            return mTargetFilterGeneration == generation
+                ? mTargetFilter : nullptr;
+        }
+
+        void setTargetFilter(const TargetFilter *const filter,
+                             const int generation)
+        {
+            mTargetFilter = filter;
+            mTargetFilterGeneration = generation;
+        }
+
         bool getShowName() const A_WARN_UNUSED
         { return mShowName; }
 
@@ -606,21 +625,21 @@ class Being notfinal : public ActorSprite,
         { return mGender; }
 
         /**
-         * Return sprite sit action for current environment.
+         * Return sprite sit action id for current environment.
          */
-        std::string getSitAction() const A_WARN_UNUSED;
+        int getSitAction() const A_WARN_UNUSED;
 
-        std::string getMoveAction() const A_WARN_UNUSED;
+        int getMoveAction() const A_WARN_UNUSED;
 
-        std::string getDeadAction() const A_WARN_UNUSED;
+        int getDeadAction() const A_WARN_UNUSED;
 
-        std::string getStandAction() const A_WARN_UNUSED;
+        int getStandAction() const A_WARN_UNUSED;
 
-        std::string getSpawnAction() const A_WARN_UNUSED;
+        int getSpawnAction() const A_WARN_UNUSED;
 
-        std::string getWeaponAttackAction(const ItemInfo *const weapon) const;
+        int getWeaponAttackAction(const ItemInfo *const weapon) const;
 
-        std::string getAttackAction(const Attack *const attack) const;
+        int getAttackAction(const Attack *const attack) const;
 
         /**
          * Whether or not this player is a GM.
@@ -911,7 +930,9 @@ class Being notfinal : public ActorSprite,
         AnimatedSprite *mEmotionSprite;
         AnimatedSprite* mAnimationEffect;
 
-        std::string mSpriteAction;
+        int mSpriteActionId;
+        const TargetFilter *mTargetFilter;
+        int mTargetFilterGeneration;
         std::string mName;              /**< Name of character */
         std::string mRaceName;
         std::string mPartyName;
@@ -106,6 +106,18 @@ bool CompoundSprite::play(const std::string &action)
     return ret;
 }
 
+bool CompoundSprite::play(const int actionId)
+{
+    bool ret = false;
+    FOR_EACH (SpriteIterator, it, mSprites)
+    {
+        if (*it)
+            ret |= (*it)->play(actionId);
+    }
+    mNeedsRedraw |= ret;
+    return ret;
+}
+
 bool CompoundSprite::update(const int time)
 {
     bool ret = false;
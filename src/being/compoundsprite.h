@@ -48,6 +48,8 @@ public:
 
     virtual bool play(const std::string &action) override final;
 
+    virtual bool play(const int actionId) override final;
+
     virtual bool update(const int time) override final;
 
     virtual void draw(Graphics *const graphics,
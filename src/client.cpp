@@ -91,6 +91,10 @@
 
 #include "particle/particle.h"
 
+#include "render/rendertrace.h"
+
+#include "resources/delayedmanager.h"
+#include "resources/dye.h"
 #include "resources/imagehelper.h"
 #include "resources/openglimagehelper.h"
 #include "resources/resourcemanager.h"
@@ -113,6 +117,7 @@
 #include "resources/db/weaponsdb.h"
 
 #include "utils/cpu.h"
+#include "utils/datapack.h"
 #include "utils/delete2.h"
 #include "utils/fuzzer.h"
 #include "utils/gettext.h"
@@ -336,6 +341,7 @@ void Client::gameInit()
     ConfigManager::checkConfigVersion();
     logVars();
     Cpu::detect();
+    Dye::initFunctions(Cpu::getFlags());
 #if defined(USE_OPENGL) 
 #if !defined(ANDROID) && !defined(__APPLE__) && !defined(__native_client__)
     if (!settings.options.safeMode && settings.options.test.empty()
@@ -471,6 +477,7 @@ void Client::initConfigListeners()
     config.addListener("repeateDelay", this);
     config.addListener("repeateInterval", this);
     config.addListener("logInput", this);
+    config.addListener("delayedLoadBudget", this);
 }
 
 void Client::initSoundManager()
@@ -596,6 +603,9 @@ void Client::gameClear()
 
     eventsManager.shutdown();
 
+    // save frames recorded before quit
+    delete2(renderTrace);
+
     delete2(setupWindow);
     delete2(helpWindow);
     delete2(didYouKnowWindow);
@@ -672,6 +682,7 @@ void Client::gameClear()
 
     touchManager.clear();
     ResourceManager::deleteInstance();
+    DataPack::clear();
 
     if (logger)
         logger->log1("Quitting8");
@@ -802,6 +813,8 @@ int Client::gameExec()
             frame_count++;
             if (gui)
                 gui->draw();
+            if (renderTrace && renderTrace->endFrame())
+                delete2(renderTrace);
             mainGraphics->updateScreen();
         }
         else
@@ -946,6 +959,9 @@ int Client::gameExec()
             BLOCK_START("Client::gameExec 7")
             PlayerInfo::stateChange(mState);
 
+            // scene changed, so save frames recorded in old state
+            delete2(renderTrace);
+
             if (mOldState == STATE_GAME)
             {
                 delete2(mGame);
@@ -1630,6 +1646,10 @@ void Client::optionChanged(const std::string &name)
     {
         WindowManager::applyKeyRepeat();
     }
+    else if (name == "delayedLoadBudget")
+    {
+        DelayedManager::setTimeBudget(config.getIntValue("delayedLoadBudget"));
+    }
 }
 
 void Client::action(const ActionEvent &event)
@@ -52,6 +52,7 @@
 #if defined USE_OPENGL
 #include "render/normalopenglgraphics.h"
 #endif
+#include "render/rendertrace.h"
 
 #if defined USE_OPENGL && defined DEBUG_SDLFONT
 #include "render/nullopenglgraphics.h"
@@ -69,14 +70,15 @@
 #include "net/pethandler.h"
 #include "net/tradehandler.h"
 
-#ifdef DEBUG_DUMP_LEAKS1
 #include "resources/image.h"
-#include "resources/resource.h"
-#include "resources/subimage.h"
-#endif
-
+#include "resources/imageset.h"
 #include "resources/iteminfo.h"
+#include "resources/resource.h"
 #include "resources/resourcemanager.h"
+#include "resources/sdlmusic.h"
+#include "resources/soundeffect.h"
+#include "resources/spritedef.h"
+#include "resources/subimage.h"
 
 #include "resources/db/itemdb.h"
 
@@ -1410,6 +1412,87 @@ impHandler2(dumpMods)
     outStringNormal(tab, str, str);
 }
 
+impHandler1(recordTrace)
+{
+    int frames = atoi(args.c_str());
+    if (frames <= 0)
+        frames = 300;
+    RenderTrace::start(settings.localDataDir + "/rendertrace.bin", frames);
+}
+
+static const int resourceTypes = 7;
+
+static int getResourceType(const Resource *const res)
+{
+    if (dynamic_cast<const SpriteDef*>(res))
+        return 0;
+    if (dynamic_cast<const ImageSet*>(res))
+        return 1;
+    if (dynamic_cast<const SubImage*>(res))
+        return 2;
+    if (dynamic_cast<const Image*>(res))
+        return 3;
+    if (dynamic_cast<const SoundEffect*>(res))
+        return 4;
+    if (dynamic_cast<const SDLMusic*>(res))
+        return 5;
+    return 6;
+}
+
+static void countResources(const ResourceManager::Resources *const res,
+                           int *const counts,
+                           int *const sizes)
+{
+    for (int f = 0; f < resourceTypes; f ++)
+    {
+        counts[f] = 0;
+        sizes[f] = 0;
+    }
+    FOR_EACHP (ResourceManager::ResourceCIterator, it, res)
+    {
+        const Resource *const resource = (*it).second;
+        if (!resource)
+            continue;
+        const int type = getResourceType(resource);
+        counts[type] ++;
+        sizes[type] += resource->calcMemory();
+    }
+}
+
+impHandler0(dumpResources)
+{
+    if (!debugChatTab)
+        return;
+
+    static const char *const names[resourceTypes] =
+    {
+        "sprites", "image sets", "subimages", "images",
+        "sounds", "music", "other"
+    };
+    const ResourceManager *const resman = ResourceManager::getInstance();
+    int counts[resourceTypes];
+    int sizes[resourceTypes];
+    int orphanCounts[resourceTypes];
+    int orphanSizes[resourceTypes];
+    countResources(resman->getResources(), counts, sizes);
+    countResources(resman->getOrphanedResources(),
+        orphanCounts, orphanSizes);
+
+    for (int f = 0; f < resourceTypes; f ++)
+    {
+        if (!counts[f] && !orphanCounts[f])
+            continue;
+        debugChatTab->chatLog(strprintf("%s: %d (%d KB), unused: %d (%d KB)",
+            names[f], counts[f], sizes[f] / 1024,
+            orphanCounts[f], orphanSizes[f] / 1024),
+            ChatMsgType::BY_SERVER);
+    }
+    debugChatTab->chatLog(strprintf("unused cache: %u KB / %u KB",
+        static_cast<unsigned int>(resman->getOrphanedMemory() / 1024),
+        static_cast<unsigned int>(resman->getMemoryBudget() / 1024)),
+        ChatMsgType::BY_SERVER);
+}
+
 #ifdef USE_OPENGL
 impHandler2(dumpGL)
 {
@@ -119,6 +119,8 @@ namespace Commands
     decHandler(dumpOGL);
     decHandler(dumpGL);
     decHandler(dumpMods);
+    decHandler(recordTrace);
+    decHandler(dumpResources);
     decHandler(cacheInfo);
     decHandler(execute);
     decHandler(testsdlfont);
@@ -213,6 +215,8 @@ enum
     COMMAND_DUMPOGL,
     COMMAND_DUMPGL,
     COMMAND_DUMPMODS,
+    COMMAND_RECORDTRACE,
+    COMMAND_DUMPRESOURCES,
     COMMAND_URL,
     COMMAND_OPEN,
     COMMAND_EXECUTE,
@@ -314,6 +318,8 @@ static const CommandInfo commands[] =
     {"dumpogl", &Commands::dumpOGL, -1, false},
     {"dumpgl", &Commands::dumpGL, -1, false},
     {"dumpmods", &Commands::dumpMods, -1, false},
+    {"recordtrace", &Commands::recordTrace, -1, false},
+    {"dumpresources", &Commands::dumpResources, -1, false},
     {"url", &Commands::url, -1, true},
     {"open", &Commands::open, -1, true},
     {"execute", &Commands::execute, -1, true},
@@ -303,6 +303,7 @@ DefaultsData* getConfigDefaults()
     AddDEF("videodetected", false);
     AddDEF("hideErased", false);
     AddDEF("enableDelayedAnimations", true);
+    AddDEF("delayedLoadBudget", 5);
     AddDEF("enableCompoundSpriteDelay", true);
 #ifdef ANDROID
     AddDEF("useAtlases", false);
@@ -368,6 +369,16 @@ DefaultsData* getConfigDefaults()
     AddDEF("hidesupport", false);
     AddDEF("showserverpos", false);
     AddDEF("textureSize", 1024);
+    AddDEF("softwareRenderThreads", 0);
+    AddDEF("imageDecodeThreads", 4);
+    AddDEF("resourceCacheSize", 64);
+    AddDEF("useDataPacks", false);
+    AddDEF("useDyeCache", true);
+    AddDEF("dyeCacheSize", 64);
+    AddDEF("useDbCache", true);
+    AddDEF("useGlyphAtlas", false);
+    AddDEF("asyncFontRender", true);
+    AddDEF("softwareDirtyRects", false);
     return configData;
 }
 
@@ -380,6 +380,7 @@ Game::Game() :
 
     AnimatedSprite::setEnableCache(mainGraphics->getOpenGL()
         && config.getBoolValue("enableDelayedAnimations"));
+    DelayedManager::setTimeBudget(config.getIntValue("delayedLoadBudget"));
 
     CompoundSprite::setEnableDelay(
         config.getBoolValue("enableCompoundSpriteDelay"));
@@ -607,8 +608,7 @@ void Game::slowLogic()
 
     if (shopWindow)
         shopWindow->updateTimes();
-    if (mainGraphics->getOpenGL())
-        DelayedManager::delayedLoad();
+    DelayedManager::delayedLoad(player_node);
     if (guildManager)
         guildManager->slowLogic();
     PacketCounters::update();
@@ -454,6 +454,7 @@ void GraphicsManager::initGraphics()
         config.getBoolValue("alphaCache"));
     ImageHelper::setEnableAlpha(config.getFloatValue("guialpha") != 1.0F);
 #endif
+    ImageHelper::setUseDyeCache(config.getBoolValue("useDyeCache"));
     createRenderers();
     detectPixelSize();
     setVideoMode();
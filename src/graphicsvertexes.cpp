@@ -28,6 +28,38 @@
 
 #ifdef USE_OPENGL
 unsigned int vertexBufSize = 500;
+
+namespace
+{
+    template <typename T>
+    T *getFreeArray(std::vector<T*> &freePool)
+    {
+        if (freePool.empty())
+            return new T[static_cast<size_t>(vertexBufSize * 4 + 30)];
+        T *const arr = freePool.back();
+        freePool.pop_back();
+        return arr;
+    }
+
+    template <typename T>
+    void deleteArrays(std::vector<T*> &pool)
+    {
+        for (typename std::vector<T*>::iterator it = pool.begin();
+            it != pool.end(); ++ it)
+        {
+            delete [] (*it);
+        }
+        pool.clear();
+    }
+
+    template <typename T>
+    void freeArrays(std::vector<T*> &pool,
+                    std::vector<T*> &freePool)
+    {
+        freePool.insert(freePool.end(), pool.begin(), pool.end());
+        pool.clear();
+    }
+}  // namespace
 #endif
 
 SDLGraphicsVertexes::SDLGraphicsVertexes() :
@@ -38,7 +70,6 @@ SDLGraphicsVertexes::SDLGraphicsVertexes() :
 
 SDLGraphicsVertexes::~SDLGraphicsVertexes()
 {
-    delete_all(mList);
 }
 
 #ifdef USE_OPENGL
@@ -53,7 +84,11 @@ OpenGLGraphicsVertexes::OpenGLGraphicsVertexes() :
     mIntVertPool(),
     mShortVertPool(),
     mIntTexPool(),
-    mVbo()
+    mVbo(),
+    mFloatTexFree(),
+    mIntVertFree(),
+    mShortVertFree(),
+    mIntTexFree()
 {
     mFloatTexPool.reserve(30);
     mIntVertPool.reserve(30);
@@ -70,33 +105,14 @@ OpenGLGraphicsVertexes::~OpenGLGraphicsVertexes()
 
 void OpenGLGraphicsVertexes::clear()
 {
-    for (std::vector<GLfloat*>::iterator it = mFloatTexPool.begin();
-        it != mFloatTexPool.end(); ++ it)
-    {
-        delete [] (*it);
-    }
-    mFloatTexPool.clear();
-
-    for (std::vector<GLint*>::iterator it = mIntVertPool.begin();
-        it != mIntVertPool.end(); ++ it)
-    {
-        delete [] (*it);
-    }
-    mIntVertPool.clear();
-
-    for (std::vector<GLshort*>::iterator it = mShortVertPool.begin();
-        it != mShortVertPool.end(); ++ it)
-    {
-        delete [] (*it);
-    }
-    mShortVertPool.clear();
-
-    for (std::vector<GLint*>::iterator it = mIntTexPool.begin();
-        it != mIntTexPool.end(); ++ it)
-    {
-        delete [] (*it);
-    }
-    mIntTexPool.clear();
+    deleteArrays(mFloatTexPool);
+    deleteArrays(mIntVertPool);
+    deleteArrays(mShortVertPool);
+    deleteArrays(mIntTexPool);
+    deleteArrays(mFloatTexFree);
+    deleteArrays(mIntVertFree);
+    deleteArrays(mShortVertFree);
+    deleteArrays(mIntTexFree);
 
     const int sz = static_cast<int>(mVbo.size());
     if (sz > 0)
@@ -125,30 +141,52 @@ void OpenGLGraphicsVertexes::init()
     clear();
 }
 
+void OpenGLGraphicsVertexes::reset()
+{
+    freeArrays(mFloatTexPool, mFloatTexFree);
+    freeArrays(mIntVertPool, mIntVertFree);
+    freeArrays(mShortVertPool, mShortVertFree);
+    freeArrays(mIntTexPool, mIntTexFree);
+
+    // buffer objects filled from arrays content, so cant be reused
+    const int sz = static_cast<int>(mVbo.size());
+    if (sz > 0)
+    {
+        mainGraphics->removeArray(sz, &mVbo[0]);
+        mVbo.clear();
+    }
+
+    mVp.clear();
+    mFloatTexArray = nullptr;
+    mIntTexArray = nullptr;
+    mIntVertArray = nullptr;
+    mShortVertArray = nullptr;
+}
+
 GLfloat *OpenGLGraphicsVertexes::switchFloatTexArray()
 {
-    mFloatTexArray = new GLfloat[static_cast<size_t>(vertexBufSize * 4 + 30)];
+    mFloatTexArray = getFreeArray(mFloatTexFree);
     mFloatTexPool.push_back(mFloatTexArray);
     return mFloatTexArray;
 }
 
 GLint *OpenGLGraphicsVertexes::switchIntVertArray()
 {
-    mIntVertArray = new GLint[static_cast<size_t>(vertexBufSize * 4 + 30)];
+    mIntVertArray = getFreeArray(mIntVertFree);
     mIntVertPool.push_back(mIntVertArray);
     return mIntVertArray;
 }
 
 GLshort *OpenGLGraphicsVertexes::switchShortVertArray()
 {
-    mShortVertArray = new GLshort[static_cast<size_t>(vertexBufSize * 4 + 30)];
+    mShortVertArray = getFreeArray(mShortVertFree);
     mShortVertPool.push_back(mShortVertArray);
     return mShortVertArray;
 }
 
 GLint *OpenGLGraphicsVertexes::switchIntTexArray()
 {
-    mIntTexArray = new GLint[static_cast<size_t>(vertexBufSize * 4 + 30)];
+    mIntTexArray = getFreeArray(mIntTexFree);
     mIntTexPool.push_back(mIntTexArray);
     return mIntTexArray;
 }
@@ -183,8 +221,7 @@ GLfloat *OpenGLGraphicsVertexes::continueFloatTexArray()
 {
     if (mFloatTexPool.empty())
     {
-        mFloatTexArray = new GLfloat[static_cast<size_t>(
-            vertexBufSize * 4 + 30)];
+        mFloatTexArray = getFreeArray(mFloatTexFree);
         mFloatTexPool.push_back(mFloatTexArray);
     }
     else
@@ -198,7 +235,7 @@ GLint *OpenGLGraphicsVertexes::continueIntVertArray()
 {
     if (mIntVertPool.empty())
     {
-        mIntVertArray = new GLint[static_cast<size_t>(vertexBufSize * 4 + 30)];
+        mIntVertArray = getFreeArray(mIntVertFree);
         mIntVertPool.push_back(mIntVertArray);
     }
     else
@@ -212,8 +249,7 @@ GLshort *OpenGLGraphicsVertexes::continueShortVertArray()
 {
     if (mShortVertPool.empty())
     {
-        mShortVertArray = new GLshort[static_cast<size_t>(
-            vertexBufSize * 4 + 30)];
+        mShortVertArray = getFreeArray(mShortVertFree);
         mShortVertPool.push_back(mShortVertArray);
     }
     else
@@ -227,7 +263,7 @@ GLint *OpenGLGraphicsVertexes::continueIntTexArray()
 {
     if (mIntTexPool.empty())
     {
-        mIntTexArray = new GLint[static_cast<size_t>(vertexBufSize * 4 + 30)];
+        mIntTexArray = getFreeArray(mIntTexFree);
         mIntTexPool.push_back(mIntTexArray);
     }
     else
@@ -248,10 +284,14 @@ ImageVertexes::ImageVertexes() :
     sdl.reserve(30);
 }
 
-ImageVertexes::~ImageVertexes()
+void ImageVertexes::clear()
 {
-    delete_all(sdl);
+    image = nullptr;
+    // keep allocated capacity for next rebuild
     sdl.clear();
+#ifdef USE_OPENGL
+    ogl.reset();
+#endif
 }
 
 ImageCollection::ImageCollection() :
@@ -50,6 +50,8 @@ struct DoubleRect final
     SDL_Rect dst;
 };
 
+typedef std::vector<DoubleRect> DoubleRects;
+
 class SDLGraphicsVertexes final
 {
     public:
@@ -59,7 +61,7 @@ class SDLGraphicsVertexes final
 
         ~SDLGraphicsVertexes();
 
-        std::vector<DoubleRect*> mList;
+        DoubleRects mList;
 };
 
 #ifdef USE_OPENGL
@@ -113,6 +115,11 @@ class OpenGLGraphicsVertexes final
 
         void clear();
 
+        /**
+         * Drops vertexes but keeps arrays for next calculation.
+         */
+        void reset();
+
         int ptr;
 
         GLfloat *mFloatTexArray;
@@ -125,11 +132,16 @@ class OpenGLGraphicsVertexes final
         std::vector<GLshort*> mShortVertPool;
         std::vector<GLint*> mIntTexPool;
         std::vector<GLuint> mVbo;
+
+    private:
+        // arrays released by reset
+        std::vector<GLfloat*> mFloatTexFree;
+        std::vector<GLint*> mIntVertFree;
+        std::vector<GLshort*> mShortVertFree;
+        std::vector<GLint*> mIntTexFree;
 };
 #endif
 
-typedef std::vector<DoubleRect*> DoubleRects;
-
 class ImageVertexes final
 {
     public:
@@ -137,7 +149,7 @@ class ImageVertexes final
 
         A_DELETE_COPY(ImageVertexes)
 
-        ~ImageVertexes();
+        void clear();
 
         const Image *image;
 #ifdef USE_OPENGL
@@ -66,30 +66,62 @@
 
 #include "gui/fonts/font.h"
 
+#include "configuration.h"
 #include "logger.h"
 
+#include "gui/fonts/glyphatlas.h"
 #include "gui/fonts/textchunk.h"
+#include "gui/fonts/textchunkhandle.h"
+#include "gui/fonts/textchunkworker.h"
+#include "gui/fonts/textplate.h"
 
 #include "render/graphics.h"
 
 #include "resources/image.h"
 #include "resources/imagehelper.h"
 
+#include "utils/delete2.h"
 #include "utils/files.h"
 #include "utils/paths.h"
 #include "utils/sdlcheckutils.h"
 #include "utils/stringutils.h"
 #include "utils/timer.h"
 
+#include <algorithm>
+#include <climits>
+
 #include "debug.h"
 
+#ifdef SDL_TTF_VERSION_ATLEAST
+#if SDL_TTF_VERSION_ATLEAST(2, 0, 14)
+#define USE_TTF_KERNING
+#endif
+#define USE_TTF_OUTLINE
+#endif
+
 const unsigned int CACHE_SIZE = 256;
 const unsigned int CACHE_SIZE_SMALL1 = 2;
 const unsigned int CACHE_SIZE_SMALL2 = 50;
 const unsigned int CACHE_SIZE_SMALL3 = 170;
 const unsigned int CLEAN_TIME = 7;
+const unsigned int KERNING_FIRST = 32;
+const unsigned int KERNING_LAST = 126;
+const unsigned int KERNING_SIZE = KERNING_LAST - KERNING_FIRST + 1;
+const int KERNING_UNKNOWN = INT_MIN;
+// max text images created from worker surfaces per frame
+const int MAX_FRAME_UPLOADS = 20;
+
+namespace
+{
+    int mUploadFrame = -1;
+    int mUploadCount = 0;
+    // shared by all fonts, so new font at address of deleted font never
+    // match plates of old font
+    uint32_t mFontGeneration = 0;
+}  // namespace
 
 bool Font::mSoftMode(false);
+bool Font::mUseAtlas(false);
 
 extern char *strBuf;
 
@@ -99,18 +131,32 @@ Font::Font(std::string filename,
            const int size,
            const int style) :
     mFont(nullptr),
+#ifdef USE_OPENGL
+    mAtlas(nullptr),
+#endif
     mCreateCounter(0),
     mDeleteCounter(0),
-    mCleanTime(cur_time + CLEAN_TIME)
+    mCleanTime(cur_time + CLEAN_TIME),
+    mGeneration(++ mFontGeneration),
+    mKerning(),
+    mWorkerFont(nullptr),
+    mUseAdvanceTable(false),
+    mUseKerning(false)
 {
     if (fontCounter == 0)
     {
         mSoftMode = imageHelper->useOpenGL() == RENDER_SOFTWARE;
+#ifdef USE_OPENGL
+        mUseAtlas = config.getBoolValue("useGlyphAtlas")
+            && GlyphAtlas::isSupported();
+#endif
         if (TTF_Init() == -1)
         {
             logger->error("Unable to initialize SDL_ttf: " +
                 std::string(TTF_GetError()));
         }
+        if (config.getBoolValue("asyncFontRender"))
+            textChunkWorker = new TextChunkWorker;
     }
 
     if (!fontCounter)
@@ -134,20 +180,32 @@ Font::Font(std::string filename,
             logger->error("Font::Font: " +
                           std::string(TTF_GetError()));
         }
+        filename = backFile;
     }
 
     TTF_SetFontStyle(mFont, style);
+    updateAdvanceTable();
+#ifdef USE_OPENGL
+    if (mUseAtlas)
+        mAtlas = new GlyphAtlas(mFont);
+#endif
+    openWorkerFont(filename, size, style);
 }
 
 Font::~Font()
 {
-    TTF_CloseFont(mFont);
+#ifdef USE_OPENGL
+    delete2(mAtlas);
+#endif
+    closeFont(mFont);
     mFont = nullptr;
     --fontCounter;
     clear();
+    closeWorkerFont();
 
     if (fontCounter == 0)
     {
+        delete2(textChunkWorker);
         TTF_Quit();
         delete []strBuf;
     }
@@ -155,6 +213,11 @@ Font::~Font()
 
 TTF_Font *Font::openFont(const char *const name, const int size)
 {
+    // FreeType library shared with text render thread
+    Mutex *const mutex = textChunkWorker
+        ? textChunkWorker->getFontMutex() : nullptr;
+    if (mutex)
+        mutex->lock();
 // disabled for now because some systems like gentoo cant use it
 // #ifdef USE_SDL2
 //    SDL_RWops *const rw = MPHYSFSRWOPS_openRead(name);
@@ -162,9 +225,26 @@ TTF_Font *Font::openFont(const char *const name, const int size)
 //        return nullptr;
 //    return TTF_OpenFontIndexRW(rw, 1, size, 0);
 // #else
-    return TTF_OpenFontIndex(Files::getPath(name).c_str(),
+    TTF_Font *const font = TTF_OpenFontIndex(Files::getPath(name).c_str(),
         size, 0);
 // #endif
+    if (mutex)
+        mutex->unlock();
+    return font;
+}
+
+void Font::closeFont(TTF_Font *const font)
+{
+    if (!font)
+        return;
+    // also wait while worker render with this font
+    Mutex *const mutex = textChunkWorker
+        ? textChunkWorker->getFontMutex() : nullptr;
+    if (mutex)
+        mutex->lock();
+    TTF_CloseFont(font);
+    if (mutex)
+        mutex->unlock();
 }
 
 void Font::loadFont(std::string filename,
@@ -188,37 +268,274 @@ void Font::loadFont(std::string filename,
         return;
     }
 
-    if (mFont)
-        TTF_CloseFont(mFont);
-
+    closeFont(mFont);
     mFont = font;
     TTF_SetFontStyle(mFont, style);
+    updateAdvanceTable();
+#ifdef USE_OPENGL
+    if (mAtlas)
+        mAtlas->setFont(mFont);
+#endif
     clear();
+    openWorkerFont(filename, size, style);
+}
+
+void Font::openWorkerFont(const std::string &filename,
+                          const int size,
+                          const int style)
+{
+    closeWorkerFont();
+    if (mUseAtlas || !textChunkWorker || !textChunkWorker->isStarted())
+        return;
+
+    // SDL_ttf font can not be shared between threads
+    mWorkerFont = openFont(filename.c_str(), size);
+    if (mWorkerFont)
+        TTF_SetFontStyle(mWorkerFont, style);
+}
+
+void Font::closeWorkerFont()
+{
+    if (!mWorkerFont)
+        return;
+
+    // jobs with this font already cancelled by clear()
+    closeFont(mWorkerFont);
+    mWorkerFont = nullptr;
+}
+
+bool Font::finishChunk(TextChunk *const chunk, const float alpha)
+{
+    if (mUploadFrame != frame_count)
+    {
+        mUploadFrame = frame_count;
+        mUploadCount = 0;
+    }
+    if (mUploadCount >= MAX_FRAME_UPLOADS)
+        return false;
+
+    SDL_Surface *surface = nullptr;
+    if (!textChunkWorker->getResult(chunk->job, surface))
+        return false;
+    chunk->job = nullptr;
+    mUploadCount ++;
+    if (surface)
+    {
+        chunk->img = imageHelper->createTextSurface(
+            surface, surface->w, surface->h, alpha);
+        // created by worker without debug surface checks
+        SDL_FreeSurface(surface);
+    }
+    return true;
+}
+
+void Font::updateAdvanceTable()
+{
+    mKerning.clear();
+    mUseAdvanceTable = false;
+    mUseKerning = false;
+
+    // tables mirror TTF_SizeUTF8 only for plain style without outline
+    if (!mFont || TTF_GetFontStyle(mFont) != TTF_STYLE_NORMAL)
+        return;
+#ifdef USE_TTF_OUTLINE
+    if (TTF_GetFontOutline(mFont))
+        return;
+#endif
+
+    if (TTF_GetFontKerning(mFont))
+    {
+#ifdef USE_TTF_KERNING
+        mUseKerning = true;
+#else
+        // kerning can not be queried, so measure by SDL_ttf
+        return;
+#endif
+    }
+
+    for (unsigned int f = 0; f < ADVANCE_TABLE_SIZE; f ++)
+    {
+        int minY;
+        int maxY;
+        // skip control characters
+        if (f < 32 || (f >= 127 && f < 160)
+            || TTF_GlyphMetrics(mFont, static_cast<Uint16>(f),
+            &mMinX[f], &mMaxX[f], &minY, &maxY, &mAdvance[f]) != 0)
+        {
+            mAdvance[f] = -1;
+        }
+    }
+    mUseAdvanceTable = true;
+}
+
+int Font::getKerning(const unsigned int prev A_UNUSED,
+                     const unsigned int chr A_UNUSED) const
+{
+#ifdef USE_TTF_KERNING
+    if (!mUseKerning)
+        return 0;
+
+    if (prev < KERNING_FIRST || prev > KERNING_LAST
+        || chr < KERNING_FIRST || chr > KERNING_LAST)
+    {
+        return TTF_GetFontKerningSizeGlyphs(mFont,
+            static_cast<Uint16>(prev), static_cast<Uint16>(chr));
+    }
+
+    if (mKerning.empty())
+        mKerning.resize(KERNING_SIZE * KERNING_SIZE, KERNING_UNKNOWN);
+    int &kerning = mKerning[(prev - KERNING_FIRST) * KERNING_SIZE
+        + chr - KERNING_FIRST];
+    if (kerning == KERNING_UNKNOWN)
+    {
+        kerning = TTF_GetFontKerningSizeGlyphs(mFont,
+            static_cast<Uint16>(prev), static_cast<Uint16>(chr));
+    }
+    return kerning;
+#else
+    return 0;
+#endif
+}
+
+int Font::getTableWidth(const std::string &text) const
+{
+    if (!mUseAdvanceTable)
+        return -1;
+
+    // same way as TTF_SizeUTF8 calculate width
+    int x = 0;
+    int minX = 0;
+    int maxX = 0;
+    unsigned int prev = 0;
+    const size_t sz = text.size();
+    for (size_t f = 0; f < sz; f ++)
+    {
+        unsigned int chr = static_cast<unsigned char>(text[f]);
+        if (chr >= 0x80)
+        {
+            // only two bytes sequences for U+0080 - U+00FF
+            if ((chr != 0xc2 && chr != 0xc3) || f + 1 >= sz)
+                return -1;
+            const unsigned int chr2 = static_cast<unsigned char>(
+                text[f + 1]);
+            if ((chr2 & 0xc0) != 0x80)
+                return -1;
+            chr = ((chr & 0x1f) << 6) | (chr2 & 0x3f);
+            f ++;
+        }
+        const int advance = mAdvance[chr];
+        if (advance < 0)
+            return -1;
+
+        if (prev)
+            x += getKerning(prev, chr);
+        const int left = x + mMinX[chr];
+        if (left < minX)
+            minX = left;
+        const int right = x + std::max(advance, mMaxX[chr]);
+        if (right > maxX)
+            maxX = right;
+        x += advance;
+        prev = chr;
+    }
+    return maxX - minX;
 }
 
 void Font::clear()
 {
+    mGeneration = ++ mFontGeneration;
     for (size_t f = 0; f < CACHES_NUMBER; f ++)
         mCache[f].clear();
 }
 
+TextChunkList *Font::getCacheList(const uint64_t textHash) const
+{
+    return &mCache[(textHash ^ (textHash >> 32)) % CACHES_NUMBER];
+}
+
 void Font::drawString(Graphics *const graphics,
                       const std::string &text,
                       const int x, const int y)
+{
+    drawStringInternal(graphics, text, x, y, nullptr);
+}
+
+void Font::drawString(Graphics *const graphics,
+                      const std::string &text,
+                      const int x, const int y,
+                      TextChunkHandle &handle)
+{
+    drawStringInternal(graphics, text, x, y, &handle);
+}
+
+void Font::drawString(Graphics *const graphics,
+                      const std::string &text,
+                      const int x, const int y,
+                      TextPlate &plate)
 {
     BLOCK_START("Font::drawString")
-    if (text.empty())
+    if (text.empty() || !graphics)
+    {
+        BLOCK_END("Font::drawString")
+        return;
+    }
+
+    Color col = graphics->getColor();
+    const Color &col2 = graphics->getColor2();
+    const float alpha = static_cast<float>(col.a) / 255.0F;
+    col.a = 255;
+
+#ifdef USE_OPENGL
+    if (mAtlas)
     {
+        mAtlas->drawString(graphics, text, col, col2, alpha, x, y);
         BLOCK_END("Font::drawString")
         return;
     }
+#endif
+
+    TextChunk *chunk = plate.chunk;
+    if (chunk && plate.font == this && plate.generation == mGeneration
+        && chunk->color == col && chunk->color2 == col2
+        && chunk->text == text)
+    {
+        Image *const image = chunk->img;
+        if (image)
+        {
+            image->setAlpha(alpha);
+            graphics->drawImage(image, x, y);
+        }
+        BLOCK_END("Font::drawString")
+        return;
+    }
+
+    plate.clear();
+    chunk = new TextChunk(text, col, col2);
+    chunk->generate(mFont, alpha);
+    plate.chunk = chunk;
+    plate.font = this;
+    plate.generation = mGeneration;
 
-    Graphics *const g = dynamic_cast<Graphics *const>(graphics);
-    if (!g)
+    const Image *const image = chunk->img;
+    if (image)
+        graphics->drawImage(image, x, y);
+    BLOCK_END("Font::drawString")
+}
+
+void Font::drawStringInternal(Graphics *const graphics,
+                              const std::string &text,
+                              const int x, const int y,
+                              TextChunkHandle *const handle)
+{
+    BLOCK_START("Font::drawString")
+    if (text.empty() || !graphics)
+    {
+        BLOCK_END("Font::drawString")
         return;
+    }
 
-    Color col = g->getColor();
-    const Color &col2 = g->getColor2();
+    Color col = graphics->getColor();
+    const Color &col2 = graphics->getColor2();
     const float alpha = static_cast<float>(col.a) / 255.0F;
 
     /* The alpha value is ignored at string generation so avoid caching the
@@ -226,21 +543,58 @@ void Font::drawString(Graphics *const graphics,
      */
     col.a = 255;
 
-    const unsigned char chr = text[0];
-    TextChunkList *const cache = &mCache[chr];
+#ifdef USE_OPENGL
+    if (mAtlas)
+    {
+        mAtlas->drawString(graphics, text, col, col2, alpha, x, y);
+        BLOCK_END("Font::drawString")
+        return;
+    }
+#endif
+
+    const uint64_t textHash = hashString64(text);
+    if (handle && handle->font == this
+        && handle->textHash == textHash
+        && handle->generation == handle->list->generation)
+    {
+        TextChunk *const chunk2 = handle->chunk;
+        if (chunk2->color == col && chunk2->color2 == col2)
+        {
+            handle->list->moveToFirst(chunk2);
+            if (chunk2->job && !finishChunk(chunk2, alpha))
+            {
+                BLOCK_END("Font::drawString")
+                return;
+            }
+            Image *const image = chunk2->img;
+            if (image)
+            {
+                image->setAlpha(alpha);
+                graphics->drawImage(image, x, y);
+            }
+            BLOCK_END("Font::drawString")
+            return;
+        }
+    }
+
+    TextChunkList *const cache = getCacheList(textHash);
 
-    std::map<TextChunkSmall, TextChunk*> &search = cache->search;
-    std::map<TextChunkSmall, TextChunk*>::iterator i
-        = search.find(TextChunkSmall(text, col, col2));
+    TextChunkMap &search = cache->search;
+    TextChunkMap::iterator i
+        = search.find(TextChunkSmall(text, col, col2, textHash));
+    TextChunk *chunk2 = nullptr;
     if (i != search.end())
     {
-        TextChunk *const chunk2 = (*i).second;
+        chunk2 = (*i).second;
         cache->moveToFirst(chunk2);
-        Image *const image = chunk2->img;
-        if (image)
+        if (!chunk2->job || finishChunk(chunk2, alpha))
         {
-            image->setAlpha(alpha);
-            g->drawImage(image, x, y);
+            Image *const image = chunk2->img;
+            if (image)
+            {
+                image->setAlpha(alpha);
+                graphics->drawImage(image, x, y);
+            }
         }
     }
     else
@@ -255,14 +609,30 @@ void Font::drawString(Graphics *const graphics,
 #ifdef DEBUG_FONT_COUNTERS
         mCreateCounter ++;
 #endif
-        TextChunk *chunk2 = new TextChunk(text, col, col2);
-
-        chunk2->generate(mFont, alpha);
+        chunk2 = new TextChunk(text, col, col2);
         cache->insertFirst(chunk2);
 
-        const Image *const image = chunk2->img;
-        if (image)
-            g->drawImage(image, x, y);
+        if (mWorkerFont)
+        {
+            // text will be drawn after worker render it
+            chunk2->job = textChunkWorker->addJob(mWorkerFont,
+                text, col, col2);
+        }
+        else
+        {
+            chunk2->generate(mFont, alpha);
+            const Image *const image = chunk2->img;
+            if (image)
+                graphics->drawImage(image, x, y);
+        }
+    }
+    if (handle)
+    {
+        handle->font = this;
+        handle->list = cache;
+        handle->chunk = chunk2;
+        handle->generation = cache->generation;
+        handle->textHash = textHash;
     }
     BLOCK_END("Font::drawString")
 }
@@ -287,8 +657,16 @@ int Font::getWidth(const std::string &text) const
     if (text.empty())
         return 0;
 
-    const unsigned char chr = text[0];
-    TextChunkList *const cache = &mCache[chr];
+#ifdef USE_OPENGL
+    if (mAtlas)
+        return mAtlas->getWidth(text);
+#endif
+
+    const int width = getTableWidth(text);
+    if (width >= 0)
+        return width;
+
+    TextChunkList *const cache = getCacheList(hashString64(text));
 
     std::map<std::string, TextChunk*> &search = cache->searchWidth;
     std::map<std::string, TextChunk*>::iterator i = search.find(text);
@@ -299,7 +677,7 @@ int Font::getWidth(const std::string &text) const
         const Image *const image = chunk->img;
         if (image)
             return image->getWidth();
-        else
+        else if (!chunk->job)
             return 0;
     }
 
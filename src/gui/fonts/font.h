@@ -72,12 +72,18 @@
 #include <SDL_ttf.h>
 
 #include <string>
+#include <vector>
 
 #include "localconsts.h"
 
+class GlyphAtlas;
 class Graphics;
+class TextChunk;
+class TextChunkHandle;
+class TextPlate;
 
 const unsigned int CACHES_NUMBER = 256;
+const unsigned int ADVANCE_TABLE_SIZE = 256;
 
 /**
  * A wrapper around SDL_ttf for allowing the use of TrueType fonts.
@@ -101,6 +107,13 @@ class Font final
 
         int getWidth(const std::string &text) const A_WARN_UNUSED;
 
+        /**
+         * Measure text by glyph metrics tables.
+         * Returns -1 if text have characters outside of tables, or font
+         * style or outline not supported by tables.
+         */
+        int getTableWidth(const std::string &text) const A_WARN_UNUSED;
+
         int getHeight() const A_WARN_UNUSED;
 
         const TextChunkList *getCache() const A_WARN_UNUSED;
@@ -112,6 +125,23 @@ class Font final
                         const std::string &text,
                         const int x, const int y);
 
+        /**
+         * Draw string and remember found cache chunk in handle.
+         * Next draws with same handle skip cache lookup.
+         */
+        void drawString(Graphics *const graphics,
+                        const std::string &text,
+                        const int x, const int y,
+                        TextChunkHandle &handle);
+
+        /**
+         * Draw string using image owned by plate.
+         */
+        void drawString(Graphics *const graphics,
+                        const std::string &text,
+                        const int x, const int y,
+                        TextPlate &plate);
+
         void clear();
 
         void doClean();
@@ -129,16 +159,65 @@ class Font final
 
         static bool mSoftMode;
 
+        static bool mUseAtlas;
+
     private:
         static TTF_Font *openFont(const char *const name, const int size);
 
+        static void closeFont(TTF_Font *const font);
+
+        void drawStringInternal(Graphics *const graphics,
+                                const std::string &text,
+                                const int x, const int y,
+                                TextChunkHandle *const handle);
+
+        TextChunkList *getCacheList(const uint64_t textHash) const
+                                    A_WARN_UNUSED;
+
+        /**
+         * Fill glyph metrics for Latin-1 characters.
+         */
+        void updateAdvanceTable();
+
+        int getKerning(const unsigned int prev,
+                       const unsigned int chr) const A_WARN_UNUSED;
+
+        void openWorkerFont(const std::string &filename,
+                            const int size,
+                            const int style);
+
+        void closeWorkerFont();
+
+        /**
+         * Create image from worker result. Returns false if chunk
+         * not ready yet.
+         */
+        bool finishChunk(TextChunk *const chunk, const float alpha);
+
         TTF_Font *mFont;
+#ifdef USE_OPENGL
+        GlyphAtlas *mAtlas;
+#endif
         unsigned mCreateCounter;
         unsigned mDeleteCounter;
 
         // Word surfaces cache
         int mCleanTime;
+        // Unique between all fonts, changed on cache clear.
+        // Used to validate TextPlate
+        uint32_t mGeneration;
         mutable TextChunkList mCache[CACHES_NUMBER];
+
+        // Glyph metrics for Latin-1, advance -1 mean unknown glyph
+        int mAdvance[ADVANCE_TABLE_SIZE];
+        int mMinX[ADVANCE_TABLE_SIZE];
+        int mMaxX[ADVANCE_TABLE_SIZE];
+        // Kerning for printable ASCII pairs, filled on demand
+        mutable std::vector<int> mKerning;
+        // Copy of font for TextChunkWorker
+        TTF_Font *mWorkerFont;
+        bool mUseAdvanceTable;
+        bool mUseKerning;
 };
 
 #ifdef UNITTESTS
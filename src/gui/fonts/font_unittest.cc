@@ -25,11 +25,23 @@
 #include "gui/fonts/font.h"
 #include "gui/fonts/textchunk.h"
 #include "gui/fonts/textchunksmall.h"
+#include "gui/fonts/textchunkworker.h"
+
+#include "resources/sdlimagehelper.h"
+
+#include "utils/delete2.h"
+#include "utils/stringutils.h"
 
 #include "gtest/gtest.h"
 
+#include <physfs.h>
+
+#include <SDL_timer.h>
+
 #include "debug.h"
 
+extern const char *dirSeparator;
+
 TEST(TextChunkList, empty)
 {
     TextChunkList list;
@@ -460,3 +472,247 @@ TEST(TextChunkList, sort7)
     EXPECT_EQ(true, item1 < item2);
     EXPECT_EQ(false, item2 < item1);
 }
+
+TEST(TextChunkList, hash1)
+{
+    TextChunkSmall item1("test line1",
+        Color(1, 2, 3), Color(1, 2, 3));
+    TextChunkSmall item2("test line1",
+        Color(1, 2, 3), Color(1, 2, 3),
+        hashString64("test line1"));
+    TextChunkSmall item3("test line1",
+        Color(1, 2, 3), Color(1, 2, 4));
+    TextChunkSmallHashLess less;
+    EXPECT_EQ(item1.hash, item2.hash);
+    EXPECT_NE(item1.hash, item3.hash);
+    EXPECT_EQ(false, less(item1, item2));
+    EXPECT_EQ(false, less(item2, item1));
+    EXPECT_NE(less(item1, item3), less(item3, item1));
+}
+
+namespace
+{
+    TTF_Font *openTestFont()
+    {
+        return TTF_OpenFont("/usr/share/fonts/truetype/"
+            "ttf-dejavu/DejaVuSans-Oblique.ttf", 18);
+    }
+
+    // jobs processed in order, so all older jobs finished after this
+    bool waitWorker(TextChunkWorker *const worker, TTF_Font *const font)
+    {
+        TextChunkJob *const job = worker->addJob(font, "last",
+            Color(1, 2, 3), Color(1, 2, 3));
+        SDL_Surface *surface = nullptr;
+        for (int f = 0; f < 10000; f ++)
+        {
+            if (worker->getResult(job, surface))
+            {
+                if (surface)
+                    SDL_FreeSurface(surface);
+                return true;
+            }
+            SDL_Delay(1);
+        }
+        return false;
+    }
+}  // namespace
+
+TEST(TextChunkWorker, cancel1)
+{
+    TTF_Init();
+    TTF_Font *const font = openTestFont();
+    ASSERT_NE(nullptr, font);
+    const int jobsLeft = textChunkJobCnt;
+    TextChunkWorker *const worker = new TextChunkWorker;
+    ASSERT_TRUE(worker->isStarted());
+
+    TextChunkJob *jobs[20];
+    for (int f = 0; f < 20; f ++)
+    {
+        jobs[f] = worker->addJob(font, "long test line for render",
+            Color(1, 2, 3), Color(2, 3, 4));
+    }
+    // some jobs queued, one can be in render, some already done
+    for (int f = 0; f < 20; f ++)
+        worker->cancelJob(jobs[f]);
+
+    EXPECT_TRUE(waitWorker(worker, font));
+    EXPECT_EQ(jobsLeft, textChunkJobCnt);
+
+    delete worker;
+    TTF_CloseFont(font);
+    TTF_Quit();
+}
+
+TEST(TextChunkWorker, clear1)
+{
+    TTF_Init();
+    TTF_Font *const font = openTestFont();
+    ASSERT_NE(nullptr, font);
+    const int jobsLeft = textChunkJobCnt;
+    const int chunksLeft = textChunkCnt;
+    textChunkWorker = new TextChunkWorker;
+
+    TextChunkList list;
+    for (int f = 0; f < 20; f ++)
+    {
+        TextChunk *const chunk = new TextChunk("test " + toString(f),
+            Color(1, 2, 3), Color(2, 3, 4));
+        chunk->job = textChunkWorker->addJob(font, chunk->text,
+            chunk->color, chunk->color2);
+        list.insertFirst(chunk);
+    }
+    // evict part of chunks and clear rest while jobs in flight
+    list.removeBack(5);
+    EXPECT_EQ(15, list.size);
+    list.clear();
+    EXPECT_EQ(0, list.size);
+    EXPECT_EQ(chunksLeft, textChunkCnt);
+
+    EXPECT_TRUE(waitWorker(textChunkWorker, font));
+    EXPECT_EQ(jobsLeft, textChunkJobCnt);
+
+    delete2(textChunkWorker);
+    TTF_CloseFont(font);
+    TTF_Quit();
+}
+
+TEST(TextChunkWorker, closeFont1)
+{
+    TTF_Init();
+    TTF_Font *const font1 = openTestFont();
+    TTF_Font *const font2 = openTestFont();
+    ASSERT_NE(nullptr, font1);
+    ASSERT_NE(nullptr, font2);
+    const int jobsLeft = textChunkJobCnt;
+    TextChunkWorker *const worker = new TextChunkWorker;
+
+    TextChunkJob *jobs[20];
+    for (int f = 0; f < 20; f ++)
+    {
+        jobs[f] = worker->addJob(font1, "long test line for render",
+            Color(1, 2, 3), Color(2, 3, 4));
+    }
+    for (int f = 0; f < 20; f ++)
+        worker->cancelJob(jobs[f]);
+    // worker can be inside render with font1 here
+    {
+        MutexLocker lock(worker->getFontMutex());
+        TTF_CloseFont(font1);
+    }
+
+    EXPECT_TRUE(waitWorker(worker, font2));
+    EXPECT_EQ(jobsLeft, textChunkJobCnt);
+
+    delete worker;
+    TTF_CloseFont(font2);
+    TTF_Quit();
+}
+
+namespace
+{
+    const char *const testFontName = "/usr/share/fonts/truetype/"
+        "ttf-dejavu/DejaVuSans-Oblique.ttf";
+
+    const char *const tableTexts[] =
+    {
+        "AV", "To", "Wa", "LT", "Ty", "yo", "f.", "r,", "ff", "fi",
+        "Hello world!", "AVAVAVAVAV", "The quick brown fox jumps over "
+        "the lazy dog 0123456789", " leading and trailing ",
+        "{[(<@#$%^&*>)]}", "caf\xc3\xa9 na\xc3\xafve \xc2\xa9"
+    };
+
+    void initFontTest()
+    {
+        PHYSFS_init("manaplus");
+        dirSeparator = "/";
+        if (!logger)
+            logger = new Logger();
+        if (!imageHelper)
+            imageHelper = new SDLImageHelper();
+    }
+
+    int getTtfWidth(TTF_Font *const font, const std::string &text)
+    {
+        int width = 0;
+        int height = 0;
+        TTF_SizeUTF8(font, text.c_str(), &width, &height);
+        return width;
+    }
+}  // namespace
+
+TEST(Font, tableWidth1)
+{
+    initFontTest();
+    Font *const font = new Font(testFontName, 18);
+    TTF_Font *const ttfFont = openTestFont();
+    ASSERT_NE(nullptr, ttfFont);
+
+    for (unsigned int chr = 32; chr < 127; chr ++)
+    {
+        const std::string text(1, static_cast<char>(chr));
+        const int width = font->getTableWidth(text);
+        // tables can be disabled if kerning can not be queried
+        if (width < 0)
+            continue;
+        EXPECT_EQ(getTtfWidth(ttfFont, text), width) << text;
+    }
+    for (unsigned int chr1 = 32; chr1 < 127; chr1 ++)
+    {
+        for (unsigned int chr2 = 32; chr2 < 127; chr2 ++)
+        {
+            std::string text(1, static_cast<char>(chr1));
+            text.append(1, static_cast<char>(chr2));
+            const int width = font->getTableWidth(text);
+            if (width >= 0)
+            {
+                EXPECT_EQ(getTtfWidth(ttfFont, text), width) << text;
+            }
+        }
+    }
+    const size_t sz = sizeof(tableTexts) / sizeof(const char*);
+    for (size_t f = 0; f < sz; f ++)
+    {
+        const int width = font->getTableWidth(tableTexts[f]);
+        if (width >= 0)
+        {
+            EXPECT_EQ(getTtfWidth(ttfFont, tableTexts[f]), width);
+        }
+        EXPECT_EQ(getTtfWidth(ttfFont, tableTexts[f]),
+            font->getWidth(tableTexts[f]));
+    }
+    // characters outside of tables
+    EXPECT_EQ(-1, font->getTableWidth("\xd0\x96"));
+    EXPECT_EQ(-1, font->getTableWidth("a\tb"));
+
+    TTF_CloseFont(ttfFont);
+    delete font;
+}
+
+TEST(Font, tableWidthStyles)
+{
+    initFontTest();
+    const int styles[] =
+    {
+        TTF_STYLE_BOLD, TTF_STYLE_ITALIC, TTF_STYLE_BOLD | TTF_STYLE_ITALIC
+    };
+    for (size_t k = 0; k < sizeof(styles) / sizeof(int); k ++)
+    {
+        Font *const font = new Font(testFontName, 18, styles[k]);
+        TTF_Font *const ttfFont = openTestFont();
+        ASSERT_NE(nullptr, ttfFont);
+        TTF_SetFontStyle(ttfFont, styles[k]);
+
+        const size_t sz = sizeof(tableTexts) / sizeof(const char*);
+        for (size_t f = 0; f < sz; f ++)
+        {
+            // styled fonts measured by SDL_ttf
+            EXPECT_EQ(-1, font->getTableWidth(tableTexts[f]));
+            EXPECT_EQ(getTtfWidth(ttfFont, tableTexts[f]),
+                font->getWidth(tableTexts[f]));
+        }
+        TTF_CloseFont(ttfFont);
+        delete font;
+    }
+}
@@ -0,0 +1,415 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gui/fonts/glyphatlas.h"
+
+#ifdef USE_OPENGL
+
+#include "gui/color.h"
+
+#include "gui/fonts/textchunk.h"
+
+#include "render/graphics.h"
+
+#include "resources/image.h"
+#include "resources/imagehelper.h"
+
+#include "utils/delete2.h"
+#include "utils/sdlcheckutils.h"
+
+#include "debug.h"
+
+#ifdef SDL_TTF_VERSION_ATLEAST
+#if SDL_TTF_VERSION_ATLEAST(2, 0, 14)
+#define USE_TTF_KERNING
+#endif
+#endif
+
+namespace
+{
+    const int PAGE_SIZE = 256;
+    // pages limit for all color pairs of one font
+    const int MAX_PAGES = 16;
+    const uint32_t INVALID_CHAR = 0xffffffffU;
+}  // namespace
+
+// decode one utf8 char and move pos to next char
+static uint32_t nextChar(const std::string &text, size_t &pos)
+{
+    const unsigned char c = static_cast<unsigned char>(text[pos]);
+    if (c < 0x80)
+    {
+        pos ++;
+        return c;
+    }
+    size_t sz;
+    uint32_t code;
+    if ((c & 0xe0) == 0xc0)
+    {
+        sz = 2;
+        code = c & 0x1f;
+    }
+    else if ((c & 0xf0) == 0xe0)
+    {
+        sz = 3;
+        code = c & 0x0f;
+    }
+    else if ((c & 0xf8) == 0xf0)
+    {
+        sz = 4;
+        code = c & 0x07;
+    }
+    else
+    {
+        pos ++;
+        return INVALID_CHAR;
+    }
+    if (pos + sz > text.size())
+    {
+        pos = text.size();
+        return INVALID_CHAR;
+    }
+    for (size_t f = 1; f < sz; f ++)
+    {
+        const unsigned char c2 = static_cast<unsigned char>(text[pos + f]);
+        if ((c2 & 0xc0) != 0x80)
+        {
+            pos ++;
+            return INVALID_CHAR;
+        }
+        code = (code << 6) | (c2 & 0x3f);
+    }
+    pos += sz;
+    return code;
+}
+
+static uint64_t getColorKey(const Color &color)
+{
+    return (color.r & 0xff) << 16 | (color.g & 0xff) << 8 | (color.b & 0xff);
+}
+
+GlyphAtlas::GlyphAtlas(TTF_Font *const font) :
+    mFont(font),
+    mSets(),
+    mAdvances(),
+    mQueue(),
+    mPagesCount(0),
+    mUseCounter(0)
+{
+}
+
+GlyphAtlas::~GlyphAtlas()
+{
+    clear();
+}
+
+bool GlyphAtlas::isSupported()
+{
+    // modern renderer not implement cached drawing
+    const RenderType mode = imageHelper->useOpenGL();
+    return mode == RENDER_NORMAL_OPENGL
+        || mode == RENDER_SAFE_OPENGL
+        || mode == RENDER_GLES_OPENGL;
+}
+
+void GlyphAtlas::setFont(TTF_Font *const font)
+{
+    clear();
+    mFont = font;
+}
+
+void GlyphAtlas::clear()
+{
+    for (std::map<uint64_t, GlyphSet*>::iterator it = mSets.begin(),
+         it_end = mSets.end(); it != it_end; ++ it)
+    {
+        GlyphSet *const set = (*it).second;
+        clearSet(set);
+        delete set;
+    }
+    mSets.clear();
+    mAdvances.clear();
+    mQueue.clear();
+    mPagesCount = 0;
+}
+
+void GlyphAtlas::clearSet(GlyphSet *const set)
+{
+    FOR_EACH (std::vector<GlyphPage*>::iterator, it, set->pages)
+        deletePage(*it);
+    mPagesCount -= static_cast<int>(set->pages.size());
+    set->pages.clear();
+    for (std::map<uint32_t, Glyph*>::iterator it = set->glyphs.begin(),
+         it_end = set->glyphs.end(); it != it_end; ++ it)
+    {
+        delete (*it).second;
+    }
+    set->glyphs.clear();
+}
+
+void GlyphAtlas::trimPages(GlyphSet *const current)
+{
+    while (mPagesCount > MAX_PAGES)
+    {
+        std::map<uint64_t, GlyphSet*>::iterator oldest = mSets.end();
+        for (std::map<uint64_t, GlyphSet*>::iterator it = mSets.begin(),
+             it_end = mSets.end(); it != it_end; ++ it)
+        {
+            const GlyphSet *const set = (*it).second;
+            if (set == current || set->pages.empty())
+                continue;
+            if (oldest == mSets.end()
+                || set->lastUse < (*oldest).second->lastUse)
+            {
+                oldest = it;
+            }
+        }
+        if (oldest == mSets.end())
+        {
+            // one color pair use all pages, so start it from scratch
+            clearSet(current);
+            return;
+        }
+        clearSet((*oldest).second);
+        delete (*oldest).second;
+        mSets.erase(oldest);
+    }
+}
+
+int GlyphAtlas::getPagesCount() const
+{
+    return mPagesCount;
+}
+
+void GlyphAtlas::deletePage(GlyphPage *const page)
+{
+    // sub images must be deleted before parent image
+    FOR_EACH (std::vector<Glyph*>::iterator, it, page->glyphs)
+        delete2((*it)->image);
+    delete2(page->image);
+    delete page;
+}
+
+GlyphAtlas::GlyphPage *GlyphAtlas::getPage(GlyphSet *const set,
+                                           const int width,
+                                           const int height)
+{
+    if (!set->pages.empty())
+    {
+        GlyphPage *const page = set->pages.back();
+        if (page->penX + width > PAGE_SIZE)
+        {
+            page->penX = 0;
+            page->penY += page->rowHeight + 1;
+            page->rowHeight = 0;
+        }
+        if (page->penY + height <= PAGE_SIZE)
+            return page;
+    }
+
+    // empty page uploaded once, glyphs added later as sub rects
+    SDL_Surface *const surface = imageHelper->create32BitSurface(
+        PAGE_SIZE, PAGE_SIZE);
+    if (!surface)
+        return nullptr;
+    Image *const image = imageHelper->load(surface);
+    MSDL_FreeSurface(surface);
+    if (!image)
+        return nullptr;
+    image->setNotCount(true);
+    GlyphPage *const page = new GlyphPage;
+    page->image = image;
+    set->pages.push_back(page);
+    mPagesCount ++;
+    return page;
+}
+
+GlyphAtlas::Glyph *GlyphAtlas::getGlyph(GlyphSet *const set,
+                                        const char *const chr,
+                                        const size_t len,
+                                        const uint32_t code,
+                                        const Color &color,
+                                        const Color &color2)
+{
+    const std::map<uint32_t, Glyph*>::const_iterator it
+        = set->glyphs.find(code);
+    if (it != set->glyphs.end())
+        return (*it).second;
+
+    Glyph *const glyph = new Glyph;
+    set->glyphs[code] = glyph;
+
+    SDL_Surface *const surface = TextChunk::render(mFont,
+        std::string(chr, len), color, color2);
+    if (!surface)
+        return glyph;
+
+    const int width = surface->w;
+    const int height = surface->h;
+    GlyphPage *page = nullptr;
+    if (width <= PAGE_SIZE && height <= PAGE_SIZE)
+        page = getPage(set, width, height);
+    if (!page)
+    {
+        MSDL_FreeSurface(surface);
+        return glyph;
+    }
+
+    const int x = page->penX;
+    const int y = page->penY;
+    imageHelper->copySurfaceToImage(page->image, x, y, surface);
+    MSDL_FreeSurface(surface);
+    glyph->image = page->image->getSubImage(x, y, width, height);
+
+    page->penX += width + 1;
+    if (height > page->rowHeight)
+        page->rowHeight = height;
+    page->glyphs.push_back(glyph);
+    return glyph;
+}
+
+int GlyphAtlas::getAdvance(const char *const chr,
+                           const size_t len,
+                           const uint32_t code)
+{
+    const std::map<uint32_t, int>::const_iterator it = mAdvances.find(code);
+    if (it != mAdvances.end())
+        return (*it).second;
+
+    int advance = 0;
+    int minX;
+    int maxX;
+    int minY;
+    int maxY;
+    if (code > 0xffff || TTF_GlyphMetrics(mFont, static_cast<Uint16>(code),
+        &minX, &maxX, &minY, &maxY, &advance) != 0)
+    {
+        int height;
+        const std::string str(chr, len);
+        TTF_SizeUTF8(mFont, str.c_str(), &advance, &height);
+    }
+    mAdvances[code] = advance;
+    return advance;
+}
+
+int GlyphAtlas::getKerning(const uint32_t prev A_UNUSED,
+                           const uint32_t code A_UNUSED) const
+{
+#ifdef USE_TTF_KERNING
+    if (prev && prev <= 0xffff && code <= 0xffff
+        && TTF_GetFontKerning(mFont))
+    {
+        return TTF_GetFontKerningSizeGlyphs(mFont,
+            static_cast<Uint16>(prev), static_cast<Uint16>(code));
+    }
+#endif
+    return 0;
+}
+
+int GlyphAtlas::getWidth(const std::string &text)
+{
+    int width = 0;
+    uint32_t prev = 0;
+    size_t pos = 0;
+    const size_t sz = text.size();
+    while (pos < sz)
+    {
+        const size_t start = pos;
+        uint32_t code = nextChar(text, pos);
+        if (code == INVALID_CHAR)
+        {
+            code = '?';
+            width += getKerning(prev, code) + getAdvance("?", 1, code);
+        }
+        else
+        {
+            width += getKerning(prev, code)
+                + getAdvance(text.c_str() + start, pos - start, code);
+        }
+        prev = code;
+    }
+    return width;
+}
+
+void GlyphAtlas::drawString(Graphics *const graphics,
+                            const std::string &text,
+                            const Color &color,
+                            const Color &color2,
+                            const float alpha,
+                            const int x, const int y)
+{
+    BLOCK_START("GlyphAtlas::drawString")
+    const uint64_t key = getColorKey(color) << 24 | getColorKey(color2);
+    GlyphSet *set = nullptr;
+    const std::map<uint64_t, GlyphSet*>::const_iterator it = mSets.find(key);
+    if (it != mSets.end())
+    {
+        set = (*it).second;
+    }
+    else
+    {
+        set = new GlyphSet;
+        mSets[key] = set;
+    }
+    mUseCounter ++;
+    set->lastUse = mUseCounter;
+    trimPages(set);
+
+    // collect glyphs first, because new glyphs update page textures
+    // and must not be uploaded inside cached draw batch
+    mQueue.clear();
+    int penX = x;
+    uint32_t prev = 0;
+    size_t pos = 0;
+    const size_t sz = text.size();
+    while (pos < sz)
+    {
+        const size_t start = pos;
+        uint32_t code = nextChar(text, pos);
+        const char *chr = text.c_str() + start;
+        size_t len = pos - start;
+        if (code == INVALID_CHAR)
+        {
+            code = '?';
+            chr = "?";
+            len = 1;
+        }
+        penX += getKerning(prev, code);
+        Glyph *const glyph = getGlyph(set, chr, len, code, color, color2);
+        if (glyph->image)
+            mQueue.push_back(GlyphPos(glyph, penX));
+        penX += getAdvance(chr, len, code);
+        prev = code;
+    }
+
+    FOR_EACH (std::vector<GlyphPos>::const_iterator, it2, mQueue)
+    {
+        Image *const image = (*it2).first->image;
+        if (image)
+        {
+            image->setAlpha(alpha);
+            graphics->drawImageCached(image, (*it2).second, y);
+        }
+    }
+    graphics->completeCache();
+    BLOCK_END("GlyphAtlas::drawString")
+}
+
+#endif  // USE_OPENGL
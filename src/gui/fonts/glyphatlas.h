@@ -0,0 +1,152 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUI_FONTS_GLYPHATLAS_H
+#define GUI_FONTS_GLYPHATLAS_H
+
+#ifdef USE_OPENGL
+
+#include <SDL_ttf.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "localconsts.h"
+
+class Color;
+class Graphics;
+class Image;
+
+/**
+ * Draws text from glyphs rasterized once into atlas pages.
+ * Each color pair have own pages. Text drawn as batch of cached images
+ * from one texture. New glyphs uploaded into page texture as sub rects.
+ * If pages count grows over limit, pages of least recently used color
+ * pair removed.
+ */
+class GlyphAtlas final
+{
+    public:
+        explicit GlyphAtlas(TTF_Font *const font);
+
+        A_DELETE_COPY(GlyphAtlas)
+
+        ~GlyphAtlas();
+
+        void drawString(Graphics *const graphics,
+                        const std::string &text,
+                        const Color &color,
+                        const Color &color2,
+                        const float alpha,
+                        const int x, const int y);
+
+        int getWidth(const std::string &text) A_WARN_UNUSED;
+
+        void setFont(TTF_Font *const font);
+
+        void clear();
+
+        int getPagesCount() const A_WARN_UNUSED;
+
+        static bool isSupported() A_WARN_UNUSED;
+
+    private:
+        struct Glyph final
+        {
+            Glyph() :
+                image(nullptr)
+            { }
+
+            A_DELETE_COPY(Glyph)
+
+            Image *image;
+        };
+
+        struct GlyphPage final
+        {
+            GlyphPage() :
+                image(nullptr),
+                glyphs(),
+                penX(0),
+                penY(0),
+                rowHeight(0)
+            { }
+
+            A_DELETE_COPY(GlyphPage)
+
+            Image *image;
+            std::vector<Glyph*> glyphs;
+            int penX;
+            int penY;
+            int rowHeight;
+        };
+
+        struct GlyphSet final
+        {
+            GlyphSet() :
+                glyphs(),
+                pages(),
+                lastUse(0)
+            { }
+
+            A_DELETE_COPY(GlyphSet)
+
+            std::map<uint32_t, Glyph*> glyphs;
+            std::vector<GlyphPage*> pages;
+            unsigned int lastUse;
+        };
+
+        Glyph *getGlyph(GlyphSet *const set,
+                        const char *const chr,
+                        const size_t len,
+                        const uint32_t code,
+                        const Color &color,
+                        const Color &color2) A_WARN_UNUSED;
+
+        GlyphPage *getPage(GlyphSet *const set,
+                           const int width,
+                           const int height) A_WARN_UNUSED;
+
+        int getAdvance(const char *const chr,
+                       const size_t len,
+                       const uint32_t code) A_WARN_UNUSED;
+
+        int getKerning(const uint32_t prev,
+                       const uint32_t code) const A_WARN_UNUSED;
+
+        void trimPages(GlyphSet *const current);
+
+        void clearSet(GlyphSet *const set);
+
+        static void deletePage(GlyphPage *const page);
+
+        typedef std::pair<Glyph*, int> GlyphPos;
+
+        TTF_Font *mFont;
+        std::map<uint64_t, GlyphSet*> mSets;
+        std::map<uint32_t, int> mAdvances;
+        std::vector<GlyphPos> mQueue;
+        int mPagesCount;
+        unsigned int mUseCounter;
+};
+
+#endif  // USE_OPENGL
+#endif  // GUI_FONTS_GLYPHATLAS_H
@@ -25,6 +25,8 @@
 
 #include "sdlshared.h"
 
+#include "gui/fonts/textchunkworker.h"
+
 #include "resources/image.h"
 #include "resources/surfaceimagehelper.h"
 
@@ -37,6 +39,24 @@
 namespace
 {
     const int OUTLINE_SIZE = 1;
+
+    SDL_Surface *renderBlended(TTF_Font *const font,
+                               const char *const str,
+                               const SDL_Color &color,
+                               const bool worker)
+    {
+        if (worker)
+            return TTF_RenderUTF8_Blended(font, str, color);
+        return MTTF_RenderUTF8_Blended(font, str, color);
+    }
+
+    void freeSurface(SDL_Surface *const surface, const bool worker)
+    {
+        if (worker)
+            SDL_FreeSurface(surface);
+        else
+            MSDL_FreeSurface(surface);
+    }
 }  // namespace
 
 char *strBuf = nullptr;
@@ -52,7 +72,8 @@ TextChunk::TextChunk(const std::string &text0, const Color &color0,
     color(color0),
     color2(color1),
     prev(nullptr),
-    next(nullptr)
+    next(nullptr),
+    job(nullptr)
 {
 #ifdef UNITTESTS
     textChunkCnt ++;
@@ -61,6 +82,8 @@ TextChunk::TextChunk(const std::string &text0, const Color &color0,
 
 TextChunk::~TextChunk()
 {
+    if (job && textChunkWorker)
+        textChunkWorker->cancelJob(job);
     delete2(img);
 #ifdef UNITTESTS
     textChunkCnt --;
@@ -76,6 +99,36 @@ bool TextChunk::operator==(const TextChunk &chunk) const
 void TextChunk::generate(TTF_Font *const font, const float alpha)
 {
     BLOCK_START("TextChunk::generate")
+    SDL_Surface *const surface = render(font, text, color, color2);
+    if (!surface)
+    {
+        img = nullptr;
+        BLOCK_END("TextChunk::generate")
+        return;
+    }
+
+    img = imageHelper->createTextSurface(
+        surface, surface->w, surface->h, alpha);
+    MSDL_FreeSurface(surface);
+
+    BLOCK_END("TextChunk::generate")
+}
+
+SDL_Surface *TextChunk::render(TTF_Font *const font,
+                               const std::string &text,
+                               const Color &color,
+                               const Color &color2)
+{
+    getSafeUtf8String(text, strBuf);
+    return renderUtf8(font, strBuf, color, color2, false);
+}
+
+SDL_Surface *TextChunk::renderUtf8(TTF_Font *const font,
+                                   const char *const str,
+                                   const Color &color,
+                                   const Color &color2,
+                                   const bool worker)
+{
     SDL_Color sdlCol;
     sdlCol.b = static_cast<uint8_t>(color.b);
     sdlCol.r = static_cast<uint8_t>(color.r);
@@ -86,33 +139,25 @@ void TextChunk::generate(TTF_Font *const font, const float alpha)
     sdlCol.unused = 0;
 #endif
 
-    getSafeUtf8String(text, strBuf);
-
-    SDL_Surface *surface = MTTF_RenderUTF8_Blended(
-        font, strBuf, sdlCol);
+    SDL_Surface *surface = renderBlended(font, str, sdlCol, worker);
 
     if (!surface)
-    {
-        img = nullptr;
-        BLOCK_END("TextChunk::generate")
-        return;
-    }
-
-    const int width = surface->w;
-    const int height = surface->h;
+        return nullptr;
 
     if (color.r != color2.r || color.g != color2.g
         || color.b != color2.b)
     {   // outlining
         SDL_Color sdlCol2;
-        SDL_Surface *const background = imageHelper->create32BitSurface(
-            width, height);
+        // same format as rendered text
+        const SDL_PixelFormat *const format = surface->format;
+        SDL_Surface *const background = worker
+            ? SDL_CreateRGBSurface(SDL_SWSURFACE, surface->w, surface->h,
+            32, format->Rmask, format->Gmask, format->Bmask, format->Amask)
+            : imageHelper->create32BitSurface(surface->w, surface->h);
         if (!background)
         {
-            img = nullptr;
-            MSDL_FreeSurface(surface);
-            BLOCK_END("TextChunk::generate")
-            return;
+            freeSurface(surface, worker);
+            return nullptr;
         }
         sdlCol2.b = static_cast<uint8_t>(color2.b);
         sdlCol2.r = static_cast<uint8_t>(color2.r);
@@ -122,14 +167,13 @@ void TextChunk::generate(TTF_Font *const font, const float alpha)
 #else
         sdlCol2.unused = 0;
 #endif
-        SDL_Surface *const surface2 = MTTF_RenderUTF8_Blended(
-            font, strBuf, sdlCol2);
+        SDL_Surface *const surface2 = renderBlended(font, str, sdlCol2,
+            worker);
         if (!surface2)
         {
-            img = nullptr;
-            MSDL_FreeSurface(surface);
-            BLOCK_END("TextChunk::generate")
-            return;
+            freeSurface(surface, worker);
+            freeSurface(background, worker);
+            return nullptr;
         }
         SDL_Rect rect =
         {
@@ -154,13 +198,9 @@ void TextChunk::generate(TTF_Font *const font, const float alpha)
         rect.y = 0;
         SurfaceImageHelper::combineSurface(surface, nullptr,
             background, &rect);
-        MSDL_FreeSurface(surface);
-        MSDL_FreeSurface(surface2);
+        freeSurface(surface, worker);
+        freeSurface(surface2, worker);
         surface = background;
     }
-    img = imageHelper->createTextSurface(
-        surface, width, height, alpha);
-    MSDL_FreeSurface(surface);
-
-    BLOCK_END("TextChunk::generate")
+    return surface;
 }
@@ -33,6 +33,7 @@
 #include "localconsts.h"
 
 class Image;
+struct TextChunkJob;
 
 class TextChunk final
 {
@@ -49,12 +50,32 @@ class TextChunk final
 
         void generate(TTF_Font *const font, const float alpha);
 
+        /**
+         * Renders text with outline if colors differ.
+         */
+        static SDL_Surface *render(TTF_Font *const font,
+                                   const std::string &text,
+                                   const Color &color,
+                                   const Color &color2) A_WARN_UNUSED;
+
+        /**
+         * Same as render, but not use shared buffer, so can be called
+         * from worker thread. Worker must set worker flag, because debug
+         * surface checks is not thread safe.
+         */
+        static SDL_Surface *renderUtf8(TTF_Font *const font,
+                                       const char *const str,
+                                       const Color &color,
+                                       const Color &color2,
+                                       const bool worker) A_WARN_UNUSED;
+
         Image *img;
         std::string text;
         Color color;
         Color color2;
         TextChunk *prev;
         TextChunk *next;
+        TextChunkJob *job;
 };
 
 #ifdef UNITTESTS
@@ -0,0 +1,62 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUI_FONTS_TEXTCHUNKHANDLE_H
+#define GUI_FONTS_TEXTCHUNKHANDLE_H
+
+#include "localconsts.h"
+
+class Font;
+class TextChunk;
+class TextChunkList;
+
+/**
+ * Remembers where text chunk was found in font cache.
+ * Chunk reused only if hash of drawn text is same.
+ */
+class TextChunkHandle final
+{
+    public:
+        TextChunkHandle() :
+            font(nullptr),
+            list(nullptr),
+            chunk(nullptr),
+            generation(0),
+            textHash(0)
+        {
+        }
+
+        void reset()
+        {
+            font = nullptr;
+            list = nullptr;
+            chunk = nullptr;
+            generation = 0;
+            textHash = 0;
+        }
+
+        const Font *font;
+        TextChunkList *list;
+        TextChunk *chunk;
+        uint32_t generation;
+        uint64_t textHash;
+};
+
+#endif  // GUI_FONTS_TEXTCHUNKHANDLE_H
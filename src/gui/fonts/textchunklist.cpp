@@ -24,10 +24,16 @@
 
 #include "debug.h"
 
+namespace
+{
+    uint32_t mGenerationCounter = 0;
+}  // namespace
+
 TextChunkList::TextChunkList() :
     start(nullptr),
     end(nullptr),
     size(0),
+    generation(++ mGenerationCounter),
     search(),
     searchWidth()
 {
@@ -85,12 +91,15 @@ void TextChunkList::removeBack()
         searchWidth.erase(oldEnd->text);
         delete oldEnd;
         size --;
+        generation = ++ mGenerationCounter;
     }
 }
 
 void TextChunkList::removeBack(int n)
 {
     TextChunk *item = end;
+    if (n && item)
+        generation = ++ mGenerationCounter;
     while (n && item)
     {
         n --;
@@ -116,6 +125,7 @@ void TextChunkList::removeBack(int n)
 
 void TextChunkList::clear()
 {
+    generation = ++ mGenerationCounter;
     search.clear();
     searchWidth.clear();
     TextChunk *item = start;
@@ -30,6 +30,9 @@
 
 class TextChunk;
 
+typedef std::map<TextChunkSmall, TextChunk*, TextChunkSmallHashLess>
+    TextChunkMap;
+
 class TextChunkList final
 {
     public:
@@ -50,7 +53,12 @@ class TextChunkList final
         TextChunk *start;
         TextChunk *end;
         uint32_t size;
-        std::map<TextChunkSmall, TextChunk*> search;
+        /**
+         * Changed each time chunks removed from list.
+         * Used to validate TextChunkHandle.
+         */
+        uint32_t generation;
+        TextChunkMap search;
         std::map<std::string, TextChunk*> searchWidth;
 };
 
@@ -22,28 +22,63 @@
 
 #include "gui/fonts/font.h"
 
+#include "utils/stringutils.h"
+
 #include "debug.h"
 
+namespace
+{
+    const uint64_t FNV_PRIME = 1099511628211ULL;
+
+    uint64_t hashColor(uint64_t hash, const Color &color)
+    {
+        hash = (hash ^ static_cast<uint64_t>(color.r & 0xff)) * FNV_PRIME;
+        hash = (hash ^ static_cast<uint64_t>(color.g & 0xff)) * FNV_PRIME;
+        hash = (hash ^ static_cast<uint64_t>(color.b & 0xff)) * FNV_PRIME;
+        return hash;
+    }
+
+    uint64_t hashKey(const uint64_t textHash,
+                     const Color &color0,
+                     const Color &color1)
+    {
+        return hashColor(hashColor(textHash, color0), color1);
+    }
+}  // namespace
+
 TextChunkSmall::TextChunkSmall(const std::string &text0,
                                const Color &color0,
                                const Color &color1) :
     text(text0),
     color(color0),
-    color2(color1)
+    color2(color1),
+    hash(hashKey(hashString64(text0), color0, color1))
+{
+}
+
+TextChunkSmall::TextChunkSmall(const std::string &text0,
+                               const Color &color0,
+                               const Color &color1,
+                               const uint64_t textHash) :
+    text(text0),
+    color(color0),
+    color2(color1),
+    hash(hashKey(textHash, color0, color1))
 {
 }
 
 TextChunkSmall::TextChunkSmall(const TextChunkSmall &old) :
     text(old.text),
     color(old.color),
-    color2(old.color2)
+    color2(old.color2),
+    hash(old.hash)
 {
 }
 
 bool TextChunkSmall::operator==(const TextChunkSmall &chunk) const
 {
-    return (chunk.text == text && chunk.color == color
-            && chunk.color2 == color2);
+    return (chunk.hash == hash && chunk.text == text
+            && chunk.color == color && chunk.color2 == color2);
 }
 
 bool TextChunkSmall::operator<(const TextChunkSmall &chunk) const
@@ -72,3 +107,12 @@ bool TextChunkSmall::operator<(const TextChunkSmall &chunk) const
 
     return false;
 }
+
+bool TextChunkSmallHashLess::operator()(const TextChunkSmall &chunk1,
+                                        const TextChunkSmall &chunk2) const
+{
+    // hash is computed once per key, so most compares stop here
+    if (chunk1.hash != chunk2.hash)
+        return chunk1.hash < chunk2.hash;
+    return chunk1 < chunk2;
+}
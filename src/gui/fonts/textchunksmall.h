@@ -34,6 +34,11 @@ class TextChunkSmall final
                        const Color &color0,
                        const Color &color1);
 
+        TextChunkSmall(const std::string &text0,
+                       const Color &color0,
+                       const Color &color1,
+                       const uint64_t textHash);
+
         TextChunkSmall(const TextChunkSmall &old);
 
         bool operator==(const TextChunkSmall &chunk) const;
@@ -42,5 +47,15 @@ class TextChunkSmall final
         std::string text;
         Color color;
         Color color2;
+        uint64_t hash;
+};
+
+/**
+ * Orders keys by precomputed hash first. Used by font cache.
+ */
+struct TextChunkSmallHashLess final
+{
+    bool operator()(const TextChunkSmall &chunk1,
+                    const TextChunkSmall &chunk2) const A_WARN_UNUSED;
 };
 #endif  // GUI_FONTS_TEXTCHUNKSMALL_H
@@ -0,0 +1,155 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gui/fonts/textchunkworker.h"
+
+#include "logger.h"
+
+#include "gui/fonts/textchunk.h"
+
+#include "utils/sdlhelper.h"
+#include "utils/stringutils.h"
+
+#include "debug.h"
+
+TextChunkWorker *textChunkWorker = nullptr;
+
+#ifdef UNITTESTS
+int textChunkJobCnt = 0;
+#endif
+
+TextChunkWorker::TextChunkWorker() :
+    mJobs(),
+    mThread(nullptr),
+    mSem(SDL_CreateSemaphore(0)),
+    mMutex(),
+    mFontMutex(),
+    mQuit(false)
+{
+    mThread = SDL::createThread(&TextChunkWorker::workerThread,
+        "textchunkworker", this);
+    if (!mThread)
+        logger->log("Error: text render thread creation failed");
+}
+
+TextChunkWorker::~TextChunkWorker()
+{
+    if (mThread)
+    {
+        mQuit = true;
+        SDL_SemPost(mSem);
+        SDL_WaitThread(mThread, nullptr);
+        mThread = nullptr;
+    }
+    FOR_EACH (std::list<TextChunkJob*>::iterator, it, mJobs)
+        deleteJob(*it);
+    mJobs.clear();
+    SDL_DestroySemaphore(mSem);
+}
+
+void TextChunkWorker::deleteJob(TextChunkJob *const job)
+{
+    if (job->surface)
+        SDL_FreeSurface(job->surface);
+    delete job;
+}
+
+TextChunkJob *TextChunkWorker::addJob(TTF_Font *const font,
+                                      const std::string &text,
+                                      const Color &color,
+                                      const Color &color2)
+{
+    TextChunkJob *const job = new TextChunkJob(font, text, color, color2);
+    {
+        MutexLocker lock(&mMutex);
+        mJobs.push_back(job);
+    }
+    SDL_SemPost(mSem);
+    return job;
+}
+
+bool TextChunkWorker::getResult(TextChunkJob *const job,
+                                SDL_Surface *&surface)
+{
+    MutexLocker lock(&mMutex);
+    if (!job->done)
+        return false;
+    surface = job->surface;
+    delete job;
+    return true;
+}
+
+void TextChunkWorker::cancelJob(TextChunkJob *const job)
+{
+    MutexLocker lock(&mMutex);
+    if (job->done)
+        deleteJob(job);
+    else
+        job->cancelled = true;
+}
+
+int TextChunkWorker::workerThread(void *ptr)
+{
+    TextChunkWorker *const worker = static_cast<TextChunkWorker *const>(ptr);
+    if (!worker)
+        return 0;
+
+    for (;;)
+    {
+        SDL_SemWait(worker->mSem);
+        if (worker->mQuit)
+            break;
+        worker->processJobs();
+    }
+    return 0;
+}
+
+void TextChunkWorker::processJobs()
+{
+    // font lock taken before job picked, so font of cancelled job
+    // can be closed after lock
+    MutexLocker fontLock(&mFontMutex);
+    TextChunkJob *job = nullptr;
+    {
+        MutexLocker lock(&mMutex);
+        while (!mJobs.empty())
+        {
+            job = mJobs.front();
+            mJobs.pop_front();
+            if (!job->cancelled)
+                break;
+            delete job;
+            job = nullptr;
+        }
+        if (!job)
+            return;
+    }
+
+    const char *const str = getSafeUtf8String(job->text);
+    SDL_Surface *const surface = TextChunk::renderUtf8(job->font,
+        str, job->color, job->color2, true);
+    delete [] str;
+
+    MutexLocker lock(&mMutex);
+    job->surface = surface;
+    job->done = true;
+    if (job->cancelled)
+        deleteJob(job);
+}
@@ -0,0 +1,142 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GUI_FONTS_TEXTCHUNKWORKER_H
+#define GUI_FONTS_TEXTCHUNKWORKER_H
+
+#include "gui/color.h"
+
+#include "utils/mutex.h"
+
+#include <SDL_ttf.h>
+
+#include <list>
+#include <string>
+
+#include "localconsts.h"
+
+struct SDL_Thread;
+
+#ifdef UNITTESTS
+extern int textChunkJobCnt;
+#endif
+
+/**
+ * Text waiting for rendering in worker thread.
+ */
+struct TextChunkJob final
+{
+    TextChunkJob(TTF_Font *const font0,
+                 const std::string &text0,
+                 const Color &color0,
+                 const Color &color1) :
+        font(font0),
+        text(text0),
+        color(color0),
+        color2(color1),
+        surface(nullptr),
+        done(false),
+        cancelled(false)
+    {
+#ifdef UNITTESTS
+        textChunkJobCnt ++;
+#endif
+    }
+
+    A_DELETE_COPY(TextChunkJob)
+
+#ifdef UNITTESTS
+    ~TextChunkJob()
+    {
+        textChunkJobCnt --;
+    }
+#endif
+
+    TTF_Font *font;
+    std::string text;
+    Color color;
+    Color color2;
+    SDL_Surface *surface;
+    bool done;
+    bool cancelled;
+};
+
+/**
+ * Renders text surfaces in separate thread. Surfaces converted to images
+ * on main thread by Font.
+ * Worker use same FreeType library as main thread, so fonts must be
+ * opened and closed only with font mutex locked.
+ */
+class TextChunkWorker final
+{
+    public:
+        TextChunkWorker();
+
+        A_DELETE_COPY(TextChunkWorker)
+
+        ~TextChunkWorker();
+
+        /**
+         * Queue text for rendering. Font must be used only by worker.
+         */
+        TextChunkJob *addJob(TTF_Font *const font,
+                             const std::string &text,
+                             const Color &color,
+                             const Color &color2) A_WARN_UNUSED;
+
+        /**
+         * If job done, return its surface and delete job.
+         */
+        bool getResult(TextChunkJob *const job,
+                       SDL_Surface *&surface) A_WARN_UNUSED;
+
+        /**
+         * Forget job. Job deleted now or after rendering.
+         */
+        void cancelJob(TextChunkJob *const job);
+
+        /**
+         * Locked by worker while it render job. Font can be closed with
+         * this mutex locked, after all jobs with font was cancelled.
+         */
+        Mutex *getFontMutex() A_WARN_UNUSED
+        { return &mFontMutex; }
+
+        bool isStarted() const A_WARN_UNUSED
+        { return mThread != nullptr; }
+
+    private:
+        static int SDLCALL workerThread(void *ptr);
+
+        void processJobs();
+
+        static void deleteJob(TextChunkJob *const job);
+
+        std::list<TextChunkJob*> mJobs;
+        SDL_Thread *mThread;
+        SDL_sem *mSem;
+        Mutex mMutex;
+        Mutex mFontMutex;
+        volatile bool mQuit;
+};
+
+extern TextChunkWorker *textChunkWorker;
+
+#endif  // GUI_FONTS_TEXTCHUNKWORKER_H
@@ -0,0 +1,46 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gui/fonts/textplate.h"
+
+#include "gui/fonts/textchunk.h"
+
+#include "utils/delete2.h"
+
+#include "debug.h"
+
+TextPlate::TextPlate() :
+    chunk(nullptr),
+    font(nullptr),
+    generation(0)
+{
+}
+
+TextPlate::~TextPlate()
+{
+    clear();
+}
+
+void TextPlate::clear()
+{
+    delete2(chunk);
+    font = nullptr;
+    generation = 0;
+}
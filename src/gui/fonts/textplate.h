@@ -1,6 +1,6 @@
 /*
  *  The ManaPlus Client
- *  Copyright (C) 2012-2014  The ManaPlus Developers
+ *  Copyright (C) 2014  The ManaPlus Developers
  *
  *  This file is part of The ManaPlus Client.
  *
@@ -18,37 +18,32 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-#ifndef ANIMATIONDELAYLOAD_H
-#define ANIMATIONDELAYLOAD_H
-
-#include <string>
+#ifndef GUI_FONTS_TEXTPLATE_H
+#define GUI_FONTS_TEXTPLATE_H
 
 #include "localconsts.h"
 
-class AnimatedSprite;
+class Font;
+class TextChunk;
 
-class AnimationDelayLoad final
+/**
+ * Text image owned by one object instead of font cache.
+ * Regenerated only if text, colors or font changed.
+ */
+class TextPlate final
 {
     public:
-        AnimationDelayLoad(const std::string &fileName,
-                           const int variant, AnimatedSprite *const sprite);
-
-        A_DELETE_COPY(AnimationDelayLoad)
-
-        ~AnimationDelayLoad();
+        TextPlate();
 
-        void clearSprite();
+        A_DELETE_COPY(TextPlate)
 
-        void load();
+        ~TextPlate();
 
-        void setAction(const std::string &action)
-        { mAction = action; }
+        void clear();
 
-    private:
-        std::string mFileName;
-        int mVariant;
-        AnimatedSprite *mSprite;
-        std::string mAction;
+        TextChunk *chunk;
+        const Font *font;
+        uint32_t generation;
 };
 
-#endif  // ANIMATIONDELAYLOAD_H
+#endif  // GUI_FONTS_TEXTPLATE_H
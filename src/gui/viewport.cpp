@@ -144,6 +144,9 @@ void Viewport::draw(Graphics *graphics)
     if (tick_time < lastTick)
         lastTick = tick_time;
 
+    const int oldViewX = mPixelViewX;
+    const int oldViewY = mPixelViewY;
+
     // Calculate viewpoint
     const int midTileX = (graphics->mWidth + mScrollCenterOffsetX) / 2;
     const int midTileY = (graphics->mHeight + mScrollCenterOffsetY) / 2;
@@ -234,6 +237,10 @@ void Viewport::draw(Graphics *graphics)
     if (mPixelViewY > viewYmax)
         mPixelViewY = viewYmax;
 
+    // map scroll moves whole screen
+    if (mPixelViewX != oldViewX || mPixelViewY != oldViewY)
+        graphics->invalidateScreen();
+
     // Draw tiles and sprites
     mMap->draw(graphics, mPixelViewX, mPixelViewY);
 
@@ -75,7 +75,7 @@ BrowserBox::BrowserBox(const Widget2 *const widget,
     MouseListener(),
     mTextRows(),
     mTextRowLinksCount(),
-    mLineParts(),
+    mRowLayouts(),
     mLinks(),
     mLinkHandler(nullptr),
     mSkin(nullptr),
@@ -91,8 +91,17 @@ BrowserBox::BrowserBox(const Widget2 *const widget,
     mNewLinePadding(15),
     mItemPadding(0),
     mDataWidth(0),
+    mLayoutFont(nullptr),
+    mLayoutWidth(-1),
+    mLayoutMaxWidth(0),
+    mLayoutY(0),
+    mLayoutOffset(0),
+    mLayoutLink(0),
+    mLayoutWrappedLines(0),
+    mLayoutMoreHeight(0),
     mHighlightColor(getThemeColor(Theme::HIGHLIGHT)),
     mHyperLinkColor(getThemeColor(Theme::HYPERLINK)),
+    mLayoutColor(),
     mOpaque(opaque),
     mUseLinksAndUserColors(true),
     mUseEmotes(true),
@@ -298,6 +307,7 @@ void BrowserBox::addRow(const std::string &row, const bool atTop)
     {
         mTextRows.push_front(newRow);
         mTextRowLinksCount.push_front(linksCount);
+        invalidateLayout();
     }
     else
     {
@@ -311,7 +321,8 @@ void BrowserBox::addRow(const std::string &row, const bool atTop)
         while (mTextRows.size() > static_cast<size_t>(mMaxRows))
         {
             mTextRows.pop_front();
-            int cnt = mTextRowLinksCount.front();
+            const int linksCount = mTextRowLinksCount.front();
+            int cnt = linksCount;
             mTextRowLinksCount.pop_front();
 
             while (cnt && !mLinks.empty())
@@ -319,6 +330,7 @@ void BrowserBox::addRow(const std::string &row, const bool atTop)
                 mLinks.erase(mLinks.begin());
                 cnt --;
             }
+            removeFirstRowLayout(linksCount);
         }
     }
 
@@ -339,61 +351,6 @@ void BrowserBox::addRow(const std::string &row, const bool atTop)
             setWidth(w);
     }
 
-    const int fontHeight = font->getHeight();
-    if (mMode == AUTO_WRAP)
-    {
-        unsigned int y = 0;
-        unsigned int nextChar;
-        const char *const hyphen = "~";
-        const int hyphenWidth = font->getWidth(hyphen);
-        unsigned x = 0;
-
-        FOR_EACH (TextRowCIter, i, mTextRows)
-        {
-            std::string tempRow = *i;
-            for (unsigned int j = 0, sz = static_cast<unsigned int>(
-                 tempRow.size()); j < sz; j++)
-            {
-                const std::string character = tempRow.substr(j, 1);
-                x += font->getWidth(character);
-                nextChar = j + 1;
-
-                // Wraping between words (at blank spaces)
-                if (nextChar < sz && tempRow.at(nextChar) == ' ')
-                {
-                    int nextSpacePos = static_cast<int>(
-                        tempRow.find(" ", (nextChar + 1)));
-                    if (nextSpacePos <= 0)
-                        nextSpacePos = static_cast<int>(sz) - 1;
-
-                    const unsigned nextWordWidth = font->getWidth(
-                        tempRow.substr(nextChar,
-                        (nextSpacePos - nextChar)));
-
-                    if ((x + nextWordWidth + 10)
-                        > static_cast<unsigned>(getWidth()))
-                    {
-                        x = mNewLinePadding;  // Ident in new line
-                        y += 1;
-                        j ++;
-                    }
-                }
-                // Wrapping looong lines (brutal force)
-                else if ((x + 2 * hyphenWidth)
-                         > static_cast<unsigned>(getWidth()))
-                {
-                    x = mNewLinePadding;  // Ident in new line
-                    y += 1;
-                }
-            }
-        }
-
-        setHeight(fontHeight * (static_cast<int>(mTextRows.size()) + y));
-    }
-    else
-    {
-        setHeight(fontHeight * static_cast<int>(mTextRows.size()));
-    }
     mUpdateTime = 0;
     updateHeight();
 }
@@ -418,6 +375,7 @@ void BrowserBox::clearRows()
     mTextRows.clear();
     mTextRowLinksCount.clear();
     mLinks.clear();
+    invalidateLayout();
     setWidth(0);
     setHeight(0);
     mSelectedLink = -1;
@@ -501,100 +459,170 @@ void BrowserBox::draw(Graphics *graphics)
 
     Font *const font = getFont();
 
-    FOR_EACH (LinePartCIter, i, mLineParts)
+    // draw only rows visible in clip area
+    FOR_EACH (RowLayoutIterator, r, mRowLayouts)
     {
-        const LinePart &part = *i;
-        if (part.mY + 50 < mYStart)
+        BrowserRowLayout &rowLayout = *r;
+        const int rowY = rowLayout.y - mLayoutOffset;
+        if (rowY + rowLayout.height < mYStart)
             continue;
-        if (part.mY > yEnd)
+        if (rowY > yEnd)
             break;
-        if (!part.mType)
-        {
-            graphics->setColorAll(part.mColor, part.mColor2);
-            if (part.mBold)
-                boldFont->drawString(graphics, part.mText, part.mX, part.mY);
-            else
-                font->drawString(graphics, part.mText, part.mX, part.mY);
-        }
-        else if (part.mImage)
+
+        FOR_EACH (LinePartIterator, i, rowLayout.parts)
         {
-            graphics->drawImage(part.mImage, part.mX, part.mY);
+            LinePart &part = *i;
+            const int partY = rowY + part.mY;
+            if (partY > yEnd)
+                break;
+            if (!part.mType)
+            {
+                graphics->setColorAll(part.mColor, part.mColor2);
+                if (part.mBold)
+                {
+                    boldFont->drawString(graphics, part.mText, part.mX, partY,
+                        part.mTextHandle);
+                }
+                else
+                {
+                    font->drawString(graphics, part.mText, part.mX, partY,
+                        part.mTextHandle);
+                }
+            }
+            else if (part.mImage)
+            {
+                graphics->drawImage(part.mImage, part.mX, partY);
+            }
         }
     }
 
     BLOCK_END("BrowserBox::draw")
 }
 
-int BrowserBox::calcHeight()
+void BrowserBox::resetLayout(const int width, const Font *const font)
 {
-    unsigned int y = mPadding;
-    int wrappedLines = 0;
-    int moreHeight = 0;
-    int maxWidth = getWidth() - mPadding;
-    int link = 0;
-    bool bold = false;
-    unsigned int wWidth = maxWidth;
+    mRowLayouts.clear();
+    mLayoutFont = font;
+    mLayoutWidth = width;
+    mLayoutMaxWidth = width;
+    mLayoutY = mPadding;
+    mLayoutOffset = 0;
+    mLayoutLink = 0;
+    mLayoutWrappedLines = 0;
+    mLayoutMoreHeight = 0;
+    mLayoutColor[0] = mForegroundColor;
+    mLayoutColor[1] = mForegroundColor2;
+}
 
-    if (maxWidth < 0)
-        return 1;
+void BrowserBox::invalidateLayout()
+{
+    mRowLayouts.clear();
+    mLayoutWidth = -1;
+}
 
-    const Font *const font = getFont();
-    const int fontHeight = font->getHeight() + 2 * mItemPadding;
-    const int fontWidthMinus = font->getWidth("-");
-    const char *const hyphen = "~";
-    const int hyphenWidth = font->getWidth(hyphen);
+void BrowserBox::removeFirstRowLayout(const int linksCount)
+{
+    if (mRowLayouts.empty())
+        return;
 
-    Color selColor[2] = {mForegroundColor, mForegroundColor2};
-    const Color textColor[2] = {mForegroundColor, mForegroundColor2};
-    ResourceManager *const resman = ResourceManager::getInstance();
+    const BrowserRowLayout &row = mRowLayouts.front();
+    // images can change box width, so need full layout
+    if (row.links != linksCount || row.moreHeight)
+    {
+        invalidateLayout();
+        return;
+    }
+    mLayoutLink -= row.links;
+    mLayoutWrappedLines -= row.wrappedLines;
+    mLayoutMoreHeight -= row.moreHeight;
+    mRowLayouts.pop_front();
 
-    mLineParts.clear();
+    if (mRowLayouts.empty())
+    {
+        invalidateLayout();
+        return;
+    }
+
+    // colors can continue from previous row
+    const BrowserRowLayout &first = mRowLayouts.front();
+    if (first.color[0] != mForegroundColor
+        || first.color[1] != mForegroundColor2)
+    {
+        invalidateLayout();
+        return;
+    }
 
-    FOR_EACH (TextRowCIter, i, mTextRows)
+    const int shift = first.y - mPadding - mLayoutOffset;
+    mLayoutOffset += shift;
+    const int sz = std::min(mLayoutLink, static_cast<int>(mLinks.size()));
+    for (int f = 0; f < sz; f ++)
     {
-        unsigned int x = mPadding;
-        const std::string row = *(i);
-        bool wrapped = false;
-        int objects = 0;
+        BrowserLink &link = mLinks[f];
+        link.y1 -= shift;
+        link.y2 -= shift;
+    }
+}
 
-        // Check for separator lines
-        if (row.find("---", 0) == 0)
-        {
-            const int dashWidth = fontWidthMinus;
-            for (x = mPadding; x < wWidth; x ++)
-            {
-                mLineParts.push_back(LinePart(x, y + mItemPadding,
-                    selColor[0], selColor[1], "-", false));
-                x += dashWidth - 2;
-            }
+void BrowserBox::layoutRow(const std::string &row,
+                           BrowserRowLayout &rowLayout,
+                           const int fontHeight)
+{
+    const Font *const font = getFont();
+    const unsigned int wWidth = mLayoutWidth;
+    const int rowY = mLayoutY - mLayoutOffset;
+    LinePartList &parts = rowLayout.parts;
+    unsigned int y = 0;
+    unsigned int x = mPadding;
+    int link = mLayoutLink;
+    bool wrapped = false;
+    bool bold = false;
+    int objects = 0;
 
-            y += fontHeight;
-            continue;
+    Color selColor[2] = {mLayoutColor[0], mLayoutColor[1]};
+    const Color textColor[2] = {mForegroundColor, mForegroundColor2};
+    rowLayout.color[0] = selColor[0];
+    rowLayout.color[1] = selColor[1];
+    rowLayout.y = mLayoutY;
+
+    // Check for separator lines
+    if (row.find("---", 0) == 0)
+    {
+        const int dashWidth = font->getWidth("-");
+        for (x = mPadding; x < wWidth; x ++)
+        {
+            parts.push_back(LinePart(x, y + mItemPadding,
+                selColor[0], selColor[1], "-", false));
+            x += dashWidth - 2;
         }
-        else if (mEnableImages && row.find("~~~", 0) == 0)
+
+        y += fontHeight;
+    }
+    else if (mEnableImages && row.find("~~~", 0) == 0)
+    {
+        std::string str = row.substr(3);
+        const size_t sz = str.size();
+        if (sz > 2 && str.substr(sz - 1) == "~")
+            str = str.substr(0, sz - 1);
+        Image *const img = ResourceManager::getInstance()->getImage(str);
+        if (img)
         {
-            std::string str = row.substr(3);
-            const size_t sz = str.size();
-            if (sz > 2 && str.substr(sz - 1) == "~")
-                str = str.substr(0, sz - 1);
-            Image *const img = resman->getImage(str);
-            if (img)
-            {
-                img->incRef();
-                mLineParts.push_back(LinePart(x, y + mItemPadding,
-                    selColor[0], selColor[1], img));
-                y += img->getHeight() + 2;
-                moreHeight += img->getHeight();
-                if (img->getWidth() > maxWidth)
-                    maxWidth = img->getWidth() + 2;
-            }
-            continue;
+            img->incRef();
+            parts.push_back(LinePart(x, y + mItemPadding,
+                selColor[0], selColor[1], img));
+            y += img->getHeight() + 2;
+            rowLayout.moreHeight = img->getHeight();
+            if (img->getWidth() > mLayoutMaxWidth)
+                mLayoutMaxWidth = img->getWidth() + 2;
         }
+    }
+    else
+    {
+        const char *const hyphen = "~";
+        const int hyphenWidth = font->getWidth(hyphen);
 
         Color prevColor[2];
         prevColor[0] = selColor[0];
         prevColor[1] = selColor[1];
-        bold = false;
 
         for (size_t start = 0, end = std::string::npos;
              start != std::string::npos;
@@ -720,9 +748,9 @@ int BrowserBox::calcHeight()
                             font->getWidth(mLinks[link].caption) + 1;
 
                         mLinks[link].x1 = x;
-                        mLinks[link].y1 = y;
+                        mLinks[link].y1 = rowY + static_cast<int>(y);
                         mLinks[link].x2 = mLinks[link].x1 + size;
-                        mLinks[link].y2 = y + fontHeight - 1;
+                        mLinks[link].y2 = mLinks[link].y1 + fontHeight - 1;
                         link++;
                     }
 
@@ -750,7 +778,7 @@ int BrowserBox::calcHeight()
                                     Image *const img = mEmotes->get(cid);
                                     if (img)
                                     {
-                                        mLineParts.push_back(LinePart(
+                                        parts.push_back(LinePart(
                                             x, y + mItemPadding,
                                             selColor[0], selColor[1], img));
                                         x += 18;
@@ -823,7 +851,7 @@ int BrowserBox::calcHeight()
                 if (forced)
                 {
                     x -= hyphenWidth;  // Remove the wrap-notifier accounting
-                    mLineParts.push_back(LinePart(
+                    parts.push_back(LinePart(
                         wWidth - hyphenWidth, y + mItemPadding,
                         selColor[0], selColor[1], hyphen, bold));
                     end++;  // Skip to the next character
@@ -834,16 +862,13 @@ int BrowserBox::calcHeight()
                 }
 
                 wrapped = true;
-                wrappedLines++;
+                rowLayout.wrappedLines ++;
             }
 
-            mLineParts.push_back(LinePart(x, y + mItemPadding,
+            parts.push_back(LinePart(x, y + mItemPadding,
                 selColor[0], selColor[1], part.c_str(), bold));
 
-            if (bold)
-                width = boldFont->getWidth(part);
-            else
-                width = font->getWidth(part);
+            // width already measured for this part above
 
             if (mMode == AUTO_WRAP && (width == 0 && !processed))
                 break;
@@ -854,11 +879,48 @@ int BrowserBox::calcHeight()
         }
         y += fontHeight;
     }
-    if (static_cast<signed>(wWidth) != maxWidth)
-        setWidth(maxWidth);
 
-    return (static_cast<int>(mTextRows.size()) + wrappedLines)
-        * fontHeight + moreHeight + 2 * mPadding;
+    rowLayout.height = y;
+    rowLayout.links = link - mLayoutLink;
+    mLayoutLink = link;
+    mLayoutY += y;
+    mLayoutWrappedLines += rowLayout.wrappedLines;
+    mLayoutMoreHeight += rowLayout.moreHeight;
+    mLayoutColor[0] = selColor[0];
+    mLayoutColor[1] = selColor[1];
+}
+
+int BrowserBox::calcHeight()
+{
+    const int maxWidth = getWidth() - mPadding;
+    if (maxWidth < 0)
+        return 1;
+
+    const Font *const font = getFont();
+    const int fontHeight = font->getHeight() + 2 * mItemPadding;
+
+    if (mLayoutWidth != maxWidth || mLayoutFont != font
+        || mRowLayouts.size() > mTextRows.size())
+    {
+        resetLayout(maxWidth, font);
+    }
+
+    // lay out only rows added after previous call
+    TextRowCIter i = mTextRows.end();
+    for (size_t f = mTextRows.size() - mRowLayouts.size(); f > 0; f --)
+        -- i;
+    const TextRowCIter i_end = mTextRows.end();
+    for (; i != i_end; ++ i)
+    {
+        mRowLayouts.push_back(BrowserRowLayout());
+        layoutRow(*i, mRowLayouts.back(), fontHeight);
+    }
+
+    if (mLayoutMaxWidth != mLayoutWidth)
+        setWidth(mLayoutMaxWidth);
+
+    return (static_cast<int>(mTextRows.size()) + mLayoutWrappedLines)
+        * fontHeight + mLayoutMoreHeight + 2 * mPadding;
 }
 
 void BrowserBox::updateHeight()
@@ -886,22 +948,31 @@ std::string BrowserBox::getTextAtPos(const int x, const int y) const
     std::string str;
     int lastY = 0;
 
-    FOR_EACH (LinePartCIter, i, mLineParts)
+    FOR_EACH (RowLayoutCIter, r, mRowLayouts)
     {
-        const LinePart &part = *i;
-        if (part.mY + 50 < mYStart)
+        const BrowserRowLayout &rowLayout = *r;
+        const int rowY = rowLayout.y - mLayoutOffset;
+        if (rowY + rowLayout.height < mYStart)
             continue;
-        if (part.mY > textY)
-            break;
 
-        if (part.mY > lastY)
+        FOR_EACH (LinePartCIter, i, rowLayout.parts)
         {
-            str = part.mText;
-            lastY = part.mY;
-        }
-        else
-        {
-            str.append(part.mText);
+            const LinePart &part = *i;
+            const int partY = rowY + part.mY;
+            if (partY + 50 < mYStart)
+                continue;
+            if (partY > textY)
+                return str;
+
+            if (partY > lastY)
+            {
+                str = part.mText;
+                lastY = partY;
+            }
+            else
+            {
+                str.append(part.mText);
+            }
         }
     }
 
@@ -913,4 +984,5 @@ void BrowserBox::setForegroundColorAll(const Color &color1,
 {
     mForegroundColor = color1;
     mForegroundColor2 = color2;
+    invalidateLayout();
 }
@@ -34,6 +34,7 @@
 
 #include "localconsts.h"
 
+class Font;
 class LinkHandler;
 
 struct BrowserLink final
@@ -56,6 +57,30 @@ struct BrowserLink final
     std::string caption;
 };
 
+/**
+ * Cached layout of one BrowserBox row.
+ */
+struct BrowserRowLayout final
+{
+    BrowserRowLayout() :
+        parts(),
+        y(0),
+        height(0),
+        wrappedLines(0),
+        moreHeight(0),
+        links(0)
+    {
+    }
+
+    std::vector<LinePart> parts;  /**< Parts with y relative to row. */
+    Color color[2];               /**< Selected colors at row start. */
+    int y;
+    int height;
+    int wrappedLines;
+    int moreHeight;
+    int links;
+};
+
 /**
  * A simple browser box able to handle links and forward events to the
  * parent conteiner.
@@ -177,7 +202,10 @@ class BrowserBox final : public Widget,
         { mProcessVersion = n; }
 
         void setEnableImages(bool n)
-        { mEnableImages = n; }
+        {
+            mEnableImages = n;
+            invalidateLayout();
+        }
 
         void setEnableKeys(bool n)
         { mEnableKeys = n; }
@@ -196,9 +224,24 @@ class BrowserBox final : public Widget,
         int getDataWidth() const
         { return mDataWidth; }
 
+#ifdef UNITTESTS
+        const std::list<BrowserRowLayout> &getRowLayouts() const
+        { return mRowLayouts; }
+#endif
+
     private:
         int calcHeight() A_WARN_UNUSED;
 
+        void resetLayout(const int width, const Font *const font);
+
+        void invalidateLayout();
+
+        void removeFirstRowLayout(const int linksCount);
+
+        void layoutRow(const std::string &row,
+                       BrowserRowLayout &rowLayout,
+                       const int fontHeight);
+
         typedef TextRows::iterator TextRowIterator;
         typedef TextRows::const_iterator TextRowCIter;
         TextRows mTextRows;
@@ -207,7 +250,11 @@ class BrowserBox final : public Widget,
         typedef std::vector<LinePart> LinePartList;
         typedef LinePartList::iterator LinePartIterator;
         typedef LinePartList::const_iterator LinePartCIter;
-        LinePartList mLineParts;
+
+        typedef std::list<BrowserRowLayout> RowLayouts;
+        typedef RowLayouts::iterator RowLayoutIterator;
+        typedef RowLayouts::const_iterator RowLayoutCIter;
+        RowLayouts mRowLayouts;
 
         typedef std::vector<BrowserLink> Links;
         typedef Links::iterator LinkIterator;
@@ -228,9 +275,20 @@ class BrowserBox final : public Widget,
         int mItemPadding;
         unsigned int mDataWidth;
 
+        // state of layout after last laid out row
+        const Font *mLayoutFont;
+        int mLayoutWidth;
+        int mLayoutMaxWidth;
+        int mLayoutY;
+        int mLayoutOffset;
+        int mLayoutLink;
+        int mLayoutWrappedLines;
+        int mLayoutMoreHeight;
+
         Color mHighlightColor;
         Color mHyperLinkColor;
         Color mColors[2][COLORS_MAX];
+        Color mLayoutColor[2];
 
         bool mOpaque;
         bool mUseLinksAndUserColors;
@@ -22,6 +22,7 @@
 
 #include "client.h"
 
+#include "gui/gui.h"
 #include "gui/theme.h"
 
 #include "gui/fonts/font.h"
@@ -30,6 +31,8 @@
 
 #include "resources/sdlimagehelper.h"
 
+#include "utils/delete2.h"
+
 #include "gtest/gtest.h"
 
 #include <physfs.h>
@@ -151,3 +154,37 @@ TEST(browserbox, test1)
     delete client;
     client = nullptr;
 }
+
+TEST(browserbox, bold)
+{
+    PHYSFS_init("manaplus");
+    dirSeparator = "/";
+    client = new Client;
+    logger = new Logger();
+    imageHelper = new SDLImageHelper();
+    theme = new Theme;
+    Widget::setGlobalFont(new Font("/usr/share/fonts/truetype/"
+        "ttf-dejavu/DejaVuSans-Oblique.ttf", 18));
+    boldFont = new Font("/usr/share/fonts/truetype/"
+        "ttf-dejavu/DejaVuSans-Oblique.ttf", 18, TTF_STYLE_BOLD);
+    BrowserBox *box = new BrowserBox(nullptr, BrowserBox::AUTO_SIZE,
+        true, "");
+    box->setWidth(500);
+    box->addRow("normal##Bbold##bnormal2");
+
+    const std::list<BrowserRowLayout> &layouts = box->getRowLayouts();
+    ASSERT_EQ(1U, layouts.size());
+    const std::vector<LinePart> &parts = layouts.front().parts;
+    ASSERT_EQ(3U, parts.size());
+    EXPECT_EQ("normal", parts[0].mText);
+    EXPECT_FALSE(parts[0].mBold);
+    EXPECT_EQ("bold", parts[1].mText);
+    EXPECT_TRUE(parts[1].mBold);
+    EXPECT_EQ("normal2", parts[2].mText);
+    EXPECT_FALSE(parts[2].mBold);
+
+    delete box;
+    delete2(boldFont);
+    delete client;
+    client = nullptr;
+}
@@ -77,6 +77,7 @@ int Label::mInstances = 0;
 Label::Label(const Widget2 *const widget) :
     Widget(widget),
     mCaption(),
+    mTextHandle(),
     mAlignment(Graphics::LEFT),
     mPadding(0)
 {
@@ -87,6 +88,7 @@ Label::Label(const Widget2 *const widget,
              const std::string &caption) :
     Widget(widget),
     mCaption(caption),
+    mTextHandle(),
     mAlignment(Graphics::LEFT),
     mPadding(0)
 {
@@ -156,7 +158,7 @@ void Label::draw(Graphics* graphics)
     }
 
     graphics->setColorAll(mForegroundColor, mForegroundColor2);
-    font->drawString(graphics, mCaption, textX, textY);
+    font->drawString(graphics, mCaption, textX, textY, mTextHandle);
     BLOCK_END("Label::draw")
 }
 
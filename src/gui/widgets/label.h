@@ -65,6 +65,8 @@
 #ifndef GUI_WIDGETS_LABEL_H
 #define GUI_WIDGETS_LABEL_H
 
+#include "gui/fonts/textchunkhandle.h"
+
 #include "gui/widgets/widget.h"
 
 #include "localconsts.h"
@@ -130,7 +132,10 @@ class Label final : public Widget
          * @see getCaption, adjustSize
          */
         void setCaption(const std::string& caption)
-        { mCaption = caption; }
+        {
+            mCaption = caption;
+            mTextHandle.reset();
+        }
 
         /**
          * Sets the alignment of the caption. The alignment is relative
@@ -162,6 +167,8 @@ class Label final : public Widget
          */
         std::string mCaption;
 
+        TextChunkHandle mTextHandle;
+
         /**
          * Holds the alignment of the caption.
          */
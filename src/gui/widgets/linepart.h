@@ -24,6 +24,8 @@
 
 #include "gui/color.h"
 
+#include "gui/fonts/textchunkhandle.h"
+
 #include <string>
 
 #include "localconsts.h"
@@ -43,6 +45,7 @@ class LinePart final
             mText(text),
             mType(0),
             mImage(nullptr),
+            mTextHandle(),
             mBold(bold)
         {
         }
@@ -56,6 +59,7 @@ class LinePart final
             mText(),
             mType(1),
             mImage(image),
+            mTextHandle(),
             mBold(false)
         {
         }
@@ -68,6 +72,7 @@ class LinePart final
         std::string mText;
         unsigned char mType;
         Image *mImage;
+        TextChunkHandle mTextHandle;
         bool mBold;
 };
 
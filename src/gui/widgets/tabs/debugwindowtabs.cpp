@@ -35,6 +35,7 @@
 #include "gui/widgets/layoutcell.h"
 #include "gui/widgets/layouthelper.h"
 
+#include "resources/delayedmanager.h"
 #include "resources/imagehelper.h"
 
 #include "resources/map/map.h"
@@ -64,6 +65,9 @@ MapDebugTab::MapDebugTab(const Widget2 *const widget) :
     mMapActorCountLabel(new Label(this, strprintf("%s %d",
         // TRANSLATORS: debug window label
         _("Map actors count:"), 88888))),
+    mDelayedLoadLabel(new Label(this, strprintf("%s %d (%d ms)",
+        // TRANSLATORS: debug window label
+        _("Delayed loads:"), 88888, 88888))),
     // TRANSLATORS: debug window label
     mXYLabel(new Label(this, strprintf("%s (?,?)", _("Player Position:")))),
     mTexturesLabel(nullptr),
@@ -132,10 +136,11 @@ MapDebugTab::MapDebugTab(const Widget2 *const widget) :
     place(0, 6, mTileMouseLabel, 2);
     place(0, 7, mParticleCountLabel, 2);
     place(0, 8, mMapActorCountLabel, 2);
+    place(0, 9, mDelayedLoadLabel, 2);
 #ifdef USE_OPENGL
 #if defined (DEBUG_OPENGL_LEAKS) || defined(DEBUG_DRAW_CALLS) \
     || defined(DEBUG_BIND_TEXTURE)
-    int n = 9;
+    int n = 10;
 #endif
 #ifdef DEBUG_OPENGL_LEAKS
     mTexturesLabel = new Label(this, strprintf("%s %s",
@@ -206,6 +211,10 @@ void MapDebugTab::logic()
                 // TRANSLATORS: debug window label
                 strprintf("%s %d", _("Map actors count:"),
                 map->getActorsCount()));
+            mDelayedLoadLabel->setCaption(strprintf("%s %d (%d ms)",
+                // TRANSLATORS: debug window label
+                _("Delayed loads:"), DelayedManager::getQueueSize(),
+                DelayedManager::getLatency()));
 #ifdef USE_OPENGL
 #ifdef DEBUG_OPENGL_LEAKS
             mTexturesLabel->setCaption(strprintf("%s %d",
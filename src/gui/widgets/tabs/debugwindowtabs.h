@@ -65,6 +65,7 @@ class MapDebugTab final : public DebugTab
         Label *mTileMouseLabel;
         Label *mParticleCountLabel;
         Label *mMapActorCountLabel;
+        Label *mDelayedLoadLabel;
         Label *mXYLabel;
         Label *mTexturesLabel;
         int mUpdateTime;
@@ -83,14 +83,61 @@ Setup_Perfomance::Setup_Perfomance(const Widget2 *const widget) :
     new SetupItemCheckBox(_("Enable compound sprite delay (Software)"), "",
         "enableCompoundSpriteDelay", this, "enableCompoundSpriteDelayEvent");
 
+    // TRANSLATORS: settings option
+    new SetupItemIntTextField(_("Software render threads (0 - disabled)"),
+        "", "softwareRenderThreads", this, "softwareRenderThreadsEvent",
+        0, 16);
+
+    // TRANSLATORS: settings option
+    new SetupItemIntTextField(_("Unused resources cache size (MB)"), "",
+        "resourceCacheSize", this, "resourceCacheSizeEvent", 1, 1024);
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Unpack updates for faster loading (need "
+        "additional disk space)"), "", "useDataPacks", this,
+        "useDataPacksEvent");
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Cache dyed images on disk"), "",
+        "useDyeCache", this, "useDyeCacheEvent");
+
+    // TRANSLATORS: settings option
+    new SetupItemIntTextField(_("Dyed images cache size (MB)"), "",
+        "dyeCacheSize", this, "dyeCacheSizeEvent", 1, 1024);
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Cache parsed items and monsters databases"), "",
+        "useDbCache", this, "useDbCacheEvent");
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Update only changed screen parts (Software)"),
+        "", "softwareDirtyRects", this, "softwareDirtyRectsEvent");
+
+    // TRANSLATORS: settings option
+    new SetupItemIntTextField(_("Image decoding threads (0 - disabled)"),
+        "", "imageDecodeThreads", this, "imageDecodeThreadsEvent",
+        0, 16);
+
     // TRANSLATORS: settings option
     new SetupItemCheckBox(_("Enable delayed images load (OpenGL)"), "",
         "enableDelayedAnimations", this, "enableDelayedAnimationsEvent");
 
+    // TRANSLATORS: settings option
+    new SetupItemIntTextField(_("Delayed load time per frame (ms)"), "",
+        "delayedLoadBudget", this, "delayedLoadBudgetEvent", 1, 100);
+
     // TRANSLATORS: settings option
     new SetupItemCheckBox(_("Enable texture sampler (OpenGL)"), "",
         "useTextureSampler", this, "useTextureSamplerEvent");
 
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Draw text from glyph atlas (OpenGL)"), "",
+        "useGlyphAtlas", this, "useGlyphAtlasEvent");
+
+    // TRANSLATORS: settings option
+    new SetupItemCheckBox(_("Render text in separate thread"), "",
+        "asyncFontRender", this, "asyncFontRenderEvent");
+
 
     // TRANSLATORS: settings option
     new SetupItemLabel(_("Better quality (disable for better performance)"),
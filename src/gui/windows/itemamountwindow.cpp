@@ -385,6 +385,16 @@ void ItemAmountWindow::action(const ActionEvent &event)
     }
 }
 
+void ItemAmountWindow::logic()
+{
+    BLOCK_START("ItemAmountWindow::logic")
+    Window::logic();
+    // item icon can be still loading
+    if (mItem && !mItemIcon->getImage())
+        mItemIcon->setImage(mItem->getImage());
+    BLOCK_END("ItemAmountWindow::logic")
+}
+
 void ItemAmountWindow::close()
 {
     keyboard.setEnabled(mEnabledKeyboard);
@@ -84,6 +84,8 @@ class ItemAmountWindow final : public Window,
 
         void keyReleased(KeyEvent &event) override final;
 
+        void logic() override final;
+
         /**
          * Creates the dialog, or bypass it if there aren't enough items.
          */
@@ -46,6 +46,7 @@
 
 #include "resources/db/moddb.h"
 
+#include "utils/datapack.h"
 #include "utils/delete2.h"
 #include "utils/files.h"
 #include "utils/physfstools.h"
@@ -624,6 +625,29 @@ void UpdaterWindow::download()
     mDownload->start();
 }
 
+static void loadDataPacks(const std::string &restrict dir,
+                          const std::string &restrict fixPath,
+                          const std::vector<UpdateFile> &updateFiles)
+{
+    if (!config.getBoolValue("useDataPacks"))
+        return;
+
+    StringVect archives;
+    FOR_EACH (std::vector<UpdateFile>::const_iterator, it, updateFiles)
+    {
+        const UpdateFile &file = *it;
+        if (!file.group.empty())
+            continue;
+        const std::string fixFile = std::string(fixPath).append(
+            "/").append(file.name);
+        struct stat statbuf;
+        if (!stat(fixFile.c_str(), &statbuf))
+            archives.push_back(fixFile);
+        archives.push_back(std::string(dir).append("/").append(file.name));
+    }
+    DataPack::loadPacks(archives);
+}
+
 void UpdaterWindow::loadUpdates()
 {
     const ResourceManager *const resman = ResourceManager::getInstance();
@@ -651,6 +675,7 @@ void UpdaterWindow::loadUpdates()
         UpdaterWindow::addUpdateFile(resman, mUpdatesDir,
             fixPath, file.name, false);
     }
+    loadDataPacks(mUpdatesDir, fixPath, mUpdateFiles);
     loadManaPlusUpdates(mUpdatesDir, resman);
     loadMods(mUpdatesDir, resman, mUpdateFiles);
 }
@@ -681,6 +706,7 @@ void UpdaterWindow::loadLocalUpdates(const std::string &dir)
         UpdaterWindow::addUpdateFile(resman, dir,
             fixPath, file.name, false);
     }
+    loadDataPacks(dir, fixPath, updateFiles);
     loadManaPlusUpdates(dir, resman);
     loadMods(dir, resman, updateFiles);
 }
@@ -701,8 +727,10 @@ void UpdaterWindow::unloadUpdates(const std::string &dir)
     for (unsigned int updateIndex = 0, sz = static_cast<unsigned int>(
          updateFiles.size()); updateIndex < sz; updateIndex ++)
     {
-        UpdaterWindow::removeUpdateFile(resman, dir, fixPath,
-            updateFiles[updateIndex].name);
+        const std::string &name = updateFiles[updateIndex].name;
+        UpdaterWindow::removeUpdateFile(resman, dir, fixPath, name);
+        DataPack::unload(std::string(dir).append("/").append(name));
+        DataPack::unload(std::string(fixPath).append("/").append(name));
     }
     unloadManaPlusUpdates(dir, resman);
 }
@@ -43,6 +43,9 @@ public:
     bool play(const std::string &action A_UNUSED) override final
     { return false; }
 
+    bool play(const int actionId A_UNUSED) override final
+    { return false; }
+
     bool update(const int time A_UNUSED) override final
     { return false; }
 
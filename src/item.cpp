@@ -23,14 +23,18 @@
 #include "item.h"
 
 #include "dragdrop.h"
+#include "game.h"
 
 #include "gui/theme.h"
 
 #include "resources/image.h"
 #include "resources/iteminfo.h"
+#include "resources/resourcehandle.h"
 #include "resources/resourcemanager.h"
 #include "configuration.h"
 
+#include "utils/delete2.h"
+
 #include "debug.h"
 
 extern int serverVersion;
@@ -44,6 +48,7 @@ Item::Item(const int id, const int quantity, const int refine,
     mColor(0),
     mQuantity(quantity),
     mImage(nullptr),
+    mImageHandle(nullptr),
     mDescription(),
     mTags(),
     mRefine(refine),
@@ -57,6 +62,7 @@ Item::Item(const int id, const int quantity, const int refine,
 
 Item::~Item()
 {
+    delete2(mImageHandle);
     if (mImage)
     {
         mImage->decRef();
@@ -74,7 +80,11 @@ void Item::setId(const int id, const unsigned char color)
     mEquipment = id && static_cast<int>(getInfo().getType()) >= 2;
 
     if (mImage)
+    {
         mImage->decRef();
+        mImage = nullptr;
+    }
+    delete2(mImageHandle);
 
     ResourceManager *const resman = ResourceManager::getInstance();
     const ItemInfo &info = getInfo();
@@ -83,8 +93,26 @@ void Item::setId(const int id, const unsigned char color)
     const std::string dye = combineDye2(paths.getStringValue(
         "itemIcons").append(info.getDisplay().image),
         info.getDyeColorsString(color));
-    mImage = resman->getImage(dye);
+    // delayed loads processed only by game loop.
+    // icon not drawn until image loaded.
+    if (Game::instance())
+        mImage = resman->getImageAsync(dye, this, mImageHandle);
+    else
+        mImage = resman->getImage(dye);
+
+    if (!mImage && !mImageHandle)
+    {
+        mImage = Theme::getImageFromTheme(paths.getValue("unknownItemFile",
+                                          "unknown-item.png"));
+    }
+}
 
+void Item::resourceLoaded(ResourceHandle *const handle A_UNUSED,
+                          Resource *const resource)
+{
+    // handle will be deleted by DelayedManager
+    mImageHandle = nullptr;
+    mImage = static_cast<Image*>(resource);
     if (!mImage)
     {
         mImage = Theme::getImageFromTheme(paths.getValue("unknownItemFile",
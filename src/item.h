@@ -23,6 +23,8 @@
 #ifndef ITEM_H
 #define ITEM_H
 
+#include "listeners/resourcelistener.h"
+
 #include "resources/db/itemdb.h"
 
 #include <map>
@@ -34,7 +36,7 @@ class Image;
 /**
  * Represents one or more instances of a certain item type.
  */
-class Item notfinal
+class Item notfinal : public ResourceListener
 {
     public:
         /**
@@ -160,6 +162,9 @@ class Item notfinal
 
         bool isHaveTag(const int tagId) const A_WARN_UNUSED;
 
+        void resourceLoaded(ResourceHandle *const handle,
+                            Resource *const resource) override;
+
         unsigned char getColor() const A_WARN_UNUSED
         { return mColor; }
 
@@ -172,6 +177,7 @@ class Item notfinal
 
     protected:
         Image *mImage;        /**< Item image. */
+        ResourceHandle *mImageHandle;  /**< Not yet loaded item image. */
         std::string mDescription;
         std::map <int, int> mTags;
         int mRefine;          /**< Item refine level. */
@@ -0,0 +1,51 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LISTENERS_RESOURCELISTENER_H
+#define LISTENERS_RESOURCELISTENER_H
+
+#include "localconsts.h"
+
+class Resource;
+class ResourceHandle;
+
+/**
+ * The listener interface for receiving resources requested by async
+ * ResourceManager calls.
+ */
+class ResourceListener notfinal
+{
+    public:
+        /**
+         * Destructor.
+         */
+        virtual ~ResourceListener()
+        { }
+
+        /**
+         * Called when resource loaded. Resource is nullptr if loading
+         * failed, else listener owns one reference to it. Handle deleted
+         * by caller after this call.
+         */
+        virtual void resourceLoaded(ResourceHandle *const handle,
+                                    Resource *const resource) = 0;
+};
+
+#endif  // LISTENERS_RESOURCELISTENER_H
@@ -0,0 +1,487 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/bandrenderer.h"
+
+#include "render/graphics.h"
+
+#include "utils/sdlhelper.h"
+#include "utils/sdlpixel.h"
+
+#include <cstring>
+
+#include "debug.h"
+
+namespace
+{
+    // more bands than threads for balance between full and empty rows
+    const int bandsPerThread = 4;
+}  // namespace
+
+BandRenderer::BandRenderer() :
+    mCommands(),
+    mThreads(),
+    mTarget(nullptr),
+    mStartSem(SDL_CreateSemaphore(0)),
+    mDoneSem(SDL_CreateSemaphore(0)),
+    mBandMutex(),
+    mNextBand(0),
+    mBandsCount(0),
+    mBandHeight(0),
+    mQuit(false)
+{
+}
+
+BandRenderer::~BandRenderer()
+{
+    stopThreads();
+    SDL_DestroySemaphore(mStartSem);
+    SDL_DestroySemaphore(mDoneSem);
+}
+
+void BandRenderer::setThreads(int threads)
+{
+    if (threads > 16)
+        threads = 16;
+    if (threads < 2)
+        threads = 1;
+    if (static_cast<int>(mThreads.size()) == threads - 1)
+        return;
+
+    flush();
+    stopThreads();
+    mQuit = false;
+    for (int f = 1; f < threads; f ++)
+    {
+        SDL_Thread *const thread = SDL::createThread(
+            &BandRenderer::workerThread, "bandrenderer", this);
+        if (!thread)
+        {
+            logger->log("Error: band renderer thread creation failed");
+            break;
+        }
+        mThreads.push_back(thread);
+    }
+    logger->log("Software band renderer threads: %d",
+        static_cast<int>(mThreads.size()) + 1);
+}
+
+void BandRenderer::stopThreads()
+{
+    if (mThreads.empty())
+        return;
+
+    mQuit = true;
+    const size_t sz = mThreads.size();
+    for (size_t f = 0; f < sz; f ++)
+        SDL_SemPost(mStartSem);
+    FOR_EACH (std::vector<SDL_Thread*>::iterator, it, mThreads)
+        SDL_WaitThread(*it, nullptr);
+    mThreads.clear();
+}
+
+int BandRenderer::workerThread(void *ptr)
+{
+    BandRenderer *const renderer = static_cast<BandRenderer *const>(ptr);
+    if (!renderer)
+        return 0;
+
+    for (;;)
+    {
+        SDL_SemWait(renderer->mStartSem);
+        if (renderer->mQuit)
+            break;
+        renderer->drawBands();
+        SDL_SemPost(renderer->mDoneSem);
+    }
+    return 0;
+}
+
+void BandRenderer::addBlit(SDL_Surface *const src,
+                           const SDL_Rect &srcRect,
+                           const SDL_Rect &dstRect)
+{
+    BandCommand cmd;
+    cmd.src = src;
+    cmd.srcRect = srcRect;
+    cmd.dstRect = dstRect;
+    // SDL_LowerBlit use size from source rect
+    cmd.dstRect.w = srcRect.w;
+    cmd.dstRect.h = srcRect.h;
+    cmd.pixel = 0;
+    cmd.alpha = 255;
+#ifdef USE_SDL2
+    cmd.type = blitType(src, cmd.alpha);
+#else  // USE_SDL2
+
+    cmd.type = BandCommand::BLIT;
+#endif  // USE_SDL2
+    mCommands.push_back(cmd);
+}
+
+void BandRenderer::addFill(const SDL_Rect &rect,
+                           const uint32_t pixel)
+{
+    BandCommand cmd;
+    cmd.src = nullptr;
+    cmd.srcRect = rect;
+    cmd.dstRect = rect;
+    cmd.pixel = pixel;
+    cmd.alpha = 255;
+    cmd.type = BandCommand::FILL;
+    mCommands.push_back(cmd);
+}
+
+void BandRenderer::addAlphaFill(const SDL_Rect &rect,
+                                const Color &color)
+{
+    if (!mTarget)
+        return;
+
+    BandCommand cmd;
+    cmd.src = nullptr;
+    cmd.srcRect = rect;
+    cmd.dstRect = rect;
+    cmd.pixel = SDL_MapRGB(mTarget->format,
+        static_cast<uint8_t>(color.r),
+        static_cast<uint8_t>(color.g),
+        static_cast<uint8_t>(color.b));
+    cmd.alpha = static_cast<uint8_t>(color.a);
+    cmd.type = BandCommand::FILL_ALPHA;
+    mCommands.push_back(cmd);
+}
+
+void BandRenderer::flush()
+{
+    if (mCommands.empty())
+        return;
+    if (!mTarget)
+    {
+        mCommands.clear();
+        return;
+    }
+
+    BLOCK_START("BandRenderer::flush")
+    // surfaces what need locking cant be shared between threads
+    bool parallel = !SDL_MUSTLOCK(mTarget);
+    // blit mapping must be done before workers start
+    const SDL_Surface *oldSrc = nullptr;
+    FOR_EACH (BandCommands::const_iterator, it, mCommands)
+    {
+        const BandCommand &cmd = *it;
+        if (cmd.type == BandCommand::BLIT && cmd.src != oldSrc)
+        {
+#ifdef USE_SDL2
+            // SDL2 soft blit store blit parameters in source surface map,
+            // so same source cant be blitted by SDL from many threads
+            parallel = false;
+#else  // USE_SDL2
+
+            // locking RLE source decode it and change lock counter
+            if (SDL_MUSTLOCK(cmd.src))
+                parallel = false;
+#endif  // USE_SDL2
+
+            SDL_Rect srcRect = { 0, 0, 0, 0 };
+            SDL_Rect dstRect = { 0, 0, 0, 0 };
+            SDL_LowerBlit(cmd.src, &srcRect, mTarget, &dstRect);
+            oldSrc = cmd.src;
+        }
+    }
+
+    SDL_Rect oldClip;
+    SDL_GetClipRect(mTarget, &oldClip);
+    SDL_SetClipRect(mTarget, nullptr);
+
+    const int threads = parallel ? static_cast<int>(mThreads.size()) : 0;
+    if (threads)
+    {
+        mBandsCount = (threads + 1) * bandsPerThread;
+        mBandHeight = (mTarget->h + mBandsCount - 1) / mBandsCount;
+        if (mBandHeight < 1)
+            mBandHeight = 1;
+        mNextBand = 0;
+        for (int f = 0; f < threads; f ++)
+            SDL_SemPost(mStartSem);
+        drawBands();
+        for (int f = 0; f < threads; f ++)
+            SDL_SemWait(mDoneSem);
+    }
+    else
+    {
+        drawBand(0, mTarget->h);
+    }
+
+    SDL_SetClipRect(mTarget, &oldClip);
+    mCommands.clear();
+    BLOCK_END("BandRenderer::flush")
+}
+
+void BandRenderer::drawBands()
+{
+    for (;;)
+    {
+        int band;
+        {
+            MutexLocker lock(&mBandMutex);
+            band = mNextBand ++;
+        }
+        if (band >= mBandsCount)
+            return;
+        const int y1 = band * mBandHeight;
+        int y2 = y1 + mBandHeight;
+        if (y2 > mTarget->h)
+            y2 = mTarget->h;
+        if (y1 < y2)
+            drawBand(y1, y2);
+    }
+}
+
+void BandRenderer::drawBand(const int y1, const int y2) const
+{
+    FOR_EACH (BandCommands::const_iterator, it, mCommands)
+    {
+        const BandCommand &cmd = *it;
+        const int top = cmd.dstRect.y;
+        const int bottom = top + cmd.dstRect.h;
+        if (bottom <= y1 || top >= y2)
+            continue;
+
+        const int dy = top < y1 ? y1 - top : 0;
+        const int h = (bottom < y2 ? bottom : y2) - top - dy;
+        SDL_Rect dstRect = cmd.dstRect;
+        dstRect.y = static_cast<RectPos>(top + dy);
+        dstRect.h = static_cast<RectSize>(h);
+
+        switch (cmd.type)
+        {
+            case BandCommand::BLIT:
+            {
+                SDL_Rect srcRect = cmd.srcRect;
+                srcRect.y = static_cast<RectPos>(srcRect.y + dy);
+                srcRect.h = static_cast<RectSize>(h);
+                SDL_LowerBlit(cmd.src, &srcRect, mTarget, &dstRect);
+                break;
+            }
+#ifdef USE_SDL2
+            case BandCommand::COPY32:
+            case BandCommand::BLEND32:
+            {
+                SDL_Rect srcRect = cmd.srcRect;
+                srcRect.y = static_cast<RectPos>(srcRect.y + dy);
+                srcRect.h = static_cast<RectSize>(h);
+                blit32(cmd, srcRect, dstRect);
+                break;
+            }
+#endif  // USE_SDL2
+            case BandCommand::FILL:
+                SDL_FillRect(mTarget, &dstRect, cmd.pixel);
+                break;
+            case BandCommand::FILL_ALPHA:
+                drawAlphaRect(dstRect, cmd.pixel, cmd.alpha);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+void BandRenderer::drawAlphaRect(const SDL_Rect &rect,
+                                 const uint32_t pixel,
+                                 const uint8_t alpha) const
+{
+    const int bpp = mTarget->format->BytesPerPixel;
+    const int x1 = rect.x;
+    const int x2 = rect.x + rect.w;
+    const int y2 = rect.y + rect.h;
+    const int pitch = mTarget->pitch;
+
+    switch (bpp)
+    {
+        case 1:
+            for (int y = rect.y; y < y2; y ++)
+            {
+                uint8_t *const p = static_cast<uint8_t *>(mTarget->pixels)
+                    + y * pitch;
+                for (int x = x1; x < x2; x ++)
+                    *(p + x) = static_cast<uint8_t>(pixel);
+            }
+            break;
+        case 2:
+            for (int y = rect.y; y < y2; y ++)
+            {
+                uint16_t *const p = reinterpret_cast<uint16_t*>(
+                    static_cast<uint8_t *>(mTarget->pixels) + y * pitch);
+                for (int x = x1; x < x2; x ++)
+                {
+                    p[x] = SDLAlpha16(static_cast<uint16_t>(pixel),
+                        p[x], alpha, mTarget->format);
+                }
+            }
+            break;
+        case 3:
+        {
+            uint8_t r;
+            uint8_t g;
+            uint8_t b;
+            SDL_GetRGB(pixel, mTarget->format, &r, &g, &b);
+            const int ca = 255 - alpha;
+            const int cr = r * alpha;
+            const int cg = g * alpha;
+            const int cb = b * alpha;
+            for (int y = rect.y; y < y2; y ++)
+            {
+                uint8_t *const p0 = static_cast<uint8_t *>(mTarget->pixels)
+                    + y * pitch;
+                for (int x = x1; x < x2; x ++)
+                {
+                    uint8_t *const p = p0 + x * 3;
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+                    p[2] = static_cast<uint8_t>((p[2] * ca + cb) >> 8);
+                    p[1] = static_cast<uint8_t>((p[1] * ca + cg) >> 8);
+                    p[0] = static_cast<uint8_t>((p[0] * ca + cr) >> 8);
+#else
+                    p[0] = static_cast<uint8_t>((p[0] * ca + cb) >> 8);
+                    p[1] = static_cast<uint8_t>((p[1] * ca + cg) >> 8);
+                    p[2] = static_cast<uint8_t>((p[2] * ca + cr) >> 8);
+#endif
+                }
+            }
+            break;
+        }
+        case 4:
+            for (int y = rect.y; y < y2; y ++)
+            {
+                uint32_t *const p = reinterpret_cast<uint32_t*>(
+                    static_cast<uint8_t *>(mTarget->pixels) + y * pitch);
+                for (int x = x1; x < x2; x ++)
+                    p[x] = SDLAlpha32(pixel, p[x], alpha);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+#ifdef USE_SDL2
+uint8_t BandRenderer::blitType(SDL_Surface *const src,
+                               uint8_t &alpha) const
+{
+    if (!mTarget || !src || SDL_MUSTLOCK(src))
+        return BandCommand::BLIT;
+    const SDL_PixelFormat *const srcFormat = src->format;
+    const SDL_PixelFormat *const dstFormat = mTarget->format;
+    // blender works with 8 bit channels, green in second byte
+    if (srcFormat->BytesPerPixel != 4
+        || dstFormat->BytesPerPixel != 4
+        || srcFormat->Rmask != dstFormat->Rmask
+        || srcFormat->Gmask != 0x0000ff00U
+        || dstFormat->Gmask != 0x0000ff00U
+        || srcFormat->Bmask != dstFormat->Bmask
+        || (srcFormat->Rmask | srcFormat->Bmask) != 0x00ff00ffU)
+    {
+        return BandCommand::BLIT;
+    }
+    uint32_t key = 0;
+    if (!SDL_GetColorKey(src, &key))
+        return BandCommand::BLIT;
+    uint8_t r = 0;
+    uint8_t g = 0;
+    uint8_t b = 0;
+    SDL_GetSurfaceColorMod(src, &r, &g, &b);
+    if (r != 255 || g != 255 || b != 255)
+        return BandCommand::BLIT;
+    SDL_BlendMode mode = SDL_BLENDMODE_NONE;
+    SDL_GetSurfaceBlendMode(src, &mode);
+    if (mode == SDL_BLENDMODE_NONE)
+    {
+        if (srcFormat->Amask != dstFormat->Amask)
+            return BandCommand::BLIT;
+        return BandCommand::COPY32;
+    }
+    if (mode != SDL_BLENDMODE_BLEND)
+        return BandCommand::BLIT;
+    SDL_GetSurfaceAlphaMod(src, &alpha);
+    return BandCommand::BLEND32;
+}
+
+void BandRenderer::blit32(const BandCommand &cmd,
+                          const SDL_Rect &srcRect,
+                          const SDL_Rect &dstRect) const
+{
+    const SDL_Surface *const src = cmd.src;
+    const SDL_PixelFormat *const srcFormat = src->format;
+    const uint32_t srcAmask = srcFormat->Amask;
+    const uint32_t srcAshift = srcFormat->Ashift;
+    const uint32_t dstAmask = mTarget->format->Amask;
+    const uint32_t dstAshift = mTarget->format->Ashift;
+    const uint32_t alpha = cmd.alpha;
+    const bool copy = cmd.type == BandCommand::COPY32;
+    const int w = srcRect.w;
+    const int h = srcRect.h;
+    const uint8_t *srcLine = static_cast<const uint8_t*>(src->pixels)
+        + srcRect.y * src->pitch + srcRect.x * 4;
+    uint8_t *dstLine = static_cast<uint8_t*>(mTarget->pixels)
+        + dstRect.y * mTarget->pitch + dstRect.x * 4;
+
+    for (int y = 0; y < h; y ++)
+    {
+        if (copy)
+        {
+            memcpy(dstLine, srcLine, w * 4);
+        }
+        else
+        {
+            const uint32_t *const srcRow
+                = reinterpret_cast<const uint32_t*>(srcLine);
+            uint32_t *const dstRow = reinterpret_cast<uint32_t*>(dstLine);
+            for (int x = 0; x < w; x ++)
+            {
+                const uint32_t s = srcRow[x];
+                uint32_t a = srcAmask
+                    ? (s & srcAmask) >> srcAshift : 255U;
+                if (alpha != 255)
+                    a = (a * alpha) / 255;
+                if (!a)
+                    continue;
+                const uint32_t d = dstRow[x];
+                const uint32_t da = (d & dstAmask) >> dstAshift;
+                if (a == 255)
+                {
+                    dstRow[x] = (s & 0x00ffffffU) | dstAmask;
+                    continue;
+                }
+                // same packed formula as SDL blitter
+                uint32_t rb = d & 0xff00ffU;
+                uint32_t g = d & 0x00ff00U;
+                rb = (rb + ((((s & 0xff00ffU) - rb) * a) >> 8))
+                    & 0xff00ffU;
+                g = (g + ((((s & 0x00ff00U) - g) * a) >> 8))
+                    & 0x00ff00U;
+                dstRow[x] = rb | g
+                    | (((a + da - ((a * da) / 255)) << dstAshift)
+                    & dstAmask);
+            }
+        }
+        srcLine += src->pitch;
+        dstLine += mTarget->pitch;
+    }
+}
+#endif  // USE_SDL2
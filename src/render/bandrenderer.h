@@ -0,0 +1,143 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RENDER_BANDRENDERER_H
+#define RENDER_BANDRENDERER_H
+
+#include "gui/color.h"
+
+#include "utils/mutex.h"
+
+#include <SDL_video.h>
+
+#include <vector>
+
+#include "localconsts.h"
+
+struct SDL_Thread;
+
+/**
+ * Recorded software draw command. Rectangles are already clipped to the
+ * clip area active at record time.
+ */
+struct BandCommand final
+{
+    enum Type
+    {
+        BLIT = 0,
+        FILL,
+        FILL_ALPHA,
+        COPY32,
+        BLEND32
+    };
+
+    SDL_Surface *src;
+    SDL_Rect srcRect;
+    SDL_Rect dstRect;
+    uint32_t pixel;
+    uint8_t alpha;
+    uint8_t type;
+};
+
+typedef std::vector<BandCommand> BandCommands;
+
+/**
+ * Executes recorded software draw commands in parallel. Screen split to
+ * horizontal bands, and each band replays all commands clipped to it,
+ * so commands order inside band is same as record order.
+ * SDL blits share blit map stored in source surface, so on SDL2 only
+ * 32 bit sources in target pixel format blitted in parallel, by own
+ * blender. Frames with other blits on SDL2, and with blits from RLE
+ * sources on SDL 1.2, replayed in main thread only.
+ */
+class BandRenderer final
+{
+    public:
+        BandRenderer();
+
+        A_DELETE_COPY(BandRenderer)
+
+        ~BandRenderer();
+
+        /**
+         * Sets number of threads used for drawing, including main thread.
+         * Values below 2 disable recording.
+         */
+        void setThreads(int threads);
+
+        bool isEnabled() const A_WARN_UNUSED
+        { return !mThreads.empty(); }
+
+        void setTarget(SDL_Surface *const target)
+        { mTarget = target; }
+
+        void addBlit(SDL_Surface *const src,
+                     const SDL_Rect &srcRect,
+                     const SDL_Rect &dstRect);
+
+        void addFill(const SDL_Rect &rect,
+                     const uint32_t pixel);
+
+        void addAlphaFill(const SDL_Rect &rect,
+                          const Color &color);
+
+        /**
+         * Draws all recorded commands to target surface.
+         */
+        void flush();
+
+        void clear()
+        { mCommands.clear(); }
+
+    private:
+        static int SDLCALL workerThread(void *ptr);
+
+        void stopThreads();
+
+        void drawBands();
+
+        void drawBand(const int y1, const int y2) const;
+
+        void drawAlphaRect(const SDL_Rect &rect,
+                           const uint32_t pixel,
+                           const uint8_t alpha) const;
+
+#ifdef USE_SDL2
+        uint8_t blitType(SDL_Surface *const src,
+                         uint8_t &alpha) const A_WARN_UNUSED;
+
+        void blit32(const BandCommand &cmd,
+                    const SDL_Rect &srcRect,
+                    const SDL_Rect &dstRect) const;
+#endif  // USE_SDL2
+
+        BandCommands mCommands;
+        std::vector<SDL_Thread*> mThreads;
+        SDL_Surface *mTarget;
+        SDL_sem *mStartSem;
+        SDL_sem *mDoneSem;
+        Mutex mBandMutex;
+        int mNextBand;
+        int mBandsCount;
+        int mBandHeight;
+        volatile bool mQuit;
+};
+
+#endif  // RENDER_BANDRENDERER_H
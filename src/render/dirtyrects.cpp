@@ -0,0 +1,327 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/dirtyrects.h"
+
+#ifdef DEBUG_DIRTYRECTS
+#include "logger.h"
+#endif  // DEBUG_DIRTYRECTS
+
+#include "render/graphics.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "debug.h"
+
+namespace
+{
+    const int tileWidth = 64;
+    const int tileHeight = 32;
+    // if changed more than this percent of screen, do full update
+    const int fullUpdatePercent = 60;
+    const uint32_t hashSeed = 2166136261U;
+
+    inline uint32_t mix(const uint32_t hash, const uint32_t value)
+    {
+        return (hash ^ value) * 16777619U;
+    }
+
+    inline uint32_t surfaceKey(SDL_Surface *const src)
+    {
+        const uintptr_t ptr = reinterpret_cast<uintptr_t>(src);
+        uint32_t key = mix(hashSeed, static_cast<uint32_t>(ptr));
+        key = mix(key, static_cast<uint32_t>(
+            static_cast<uint64_t>(ptr) >> 32));
+        // alpha changed by Image::setAlpha without changing surface
+#ifdef USE_SDL2
+        uint8_t alpha = 255;
+        SDL_GetSurfaceAlphaMod(src, &alpha);
+        return mix(key, alpha);
+#else  // USE_SDL2
+
+        return mix(key, src->format->alpha);
+#endif  // USE_SDL2
+    }
+}  // namespace
+
+DirtyRects::DirtyRects() :
+    mRects(),
+    mHashes(),
+    mOldHashes(),
+    mDirtyTiles(),
+#ifdef DEBUG_DIRTYRECTS
+    mShadow(nullptr),
+    mPitch(0),
+#endif  // DEBUG_DIRTYRECTS
+    mWidth(0),
+    mHeight(0),
+    mCols(0),
+    mRows(0),
+    mEnabled(false),
+    mFull(false)
+{
+}
+
+DirtyRects::~DirtyRects()
+{
+    reset();
+}
+
+void DirtyRects::setEnabled(const bool enabled)
+{
+    mEnabled = enabled;
+    reset();
+}
+
+void DirtyRects::reset()
+{
+#ifdef DEBUG_DIRTYRECTS
+    delete [] mShadow;
+    mShadow = nullptr;
+    mPitch = 0;
+#endif  // DEBUG_DIRTYRECTS
+    mWidth = 0;
+    mHeight = 0;
+    mCols = 0;
+    mRows = 0;
+    mFull = false;
+    mRects.clear();
+    mHashes.clear();
+    mOldHashes.clear();
+    mDirtyTiles.clear();
+}
+
+void DirtyRects::addDraw(const SDL_Rect &rect, uint32_t key)
+{
+    const int x = rect.x;
+    const int y = rect.y;
+    const int w = rect.w;
+    const int h = rect.h;
+    const int x1 = x > 0 ? x : 0;
+    const int y1 = y > 0 ? y : 0;
+    const int x2 = x + w < mWidth ? x + w : mWidth;
+    const int y2 = y + h < mHeight ? y + h : mHeight;
+    if (x1 >= x2 || y1 >= y2)
+        return;
+
+    key = mix(key, static_cast<uint32_t>(x));
+    key = mix(key, static_cast<uint32_t>(y));
+    key = mix(key, static_cast<uint32_t>(w));
+    key = mix(key, static_cast<uint32_t>(h));
+
+    const int tx1 = x1 / tileWidth;
+    const int tx2 = (x2 - 1) / tileWidth;
+    const int ty2 = (y2 - 1) / tileHeight;
+    for (int ty = y1 / tileHeight; ty <= ty2; ty ++)
+    {
+        uint32_t *const row = &mHashes[ty * mCols];
+        for (int tx = tx1; tx <= tx2; tx ++)
+            row[tx] = mix(row[tx], key);
+    }
+}
+
+void DirtyRects::addBlit(SDL_Surface *const src,
+                         const SDL_Rect &srcRect,
+                         const SDL_Rect &dstRect)
+{
+    if (!mCols || !src)
+        return;
+
+    uint32_t key = surfaceKey(src);
+    key = mix(key, static_cast<uint32_t>(srcRect.x));
+    key = mix(key, static_cast<uint32_t>(srcRect.y));
+    // SDL_LowerBlit use size from source rect
+    const SDL_Rect rect =
+    {
+        dstRect.x,
+        dstRect.y,
+        srcRect.w,
+        srcRect.h
+    };
+    addDraw(rect, key);
+}
+
+void DirtyRects::addScaledBlit(SDL_Surface *const src,
+                               const SDL_Rect &srcRect,
+                               const int scaledWidth,
+                               const int scaledHeight,
+                               const int dstX,
+                               const int dstY,
+                               const SDL_Rect &rect)
+{
+    if (!mCols || !src)
+        return;
+
+    uint32_t key = surfaceKey(src);
+    key = mix(key, static_cast<uint32_t>(srcRect.x));
+    key = mix(key, static_cast<uint32_t>(srcRect.y));
+    key = mix(key, static_cast<uint32_t>(srcRect.w));
+    key = mix(key, static_cast<uint32_t>(srcRect.h));
+    key = mix(key, static_cast<uint32_t>(scaledWidth));
+    key = mix(key, static_cast<uint32_t>(scaledHeight));
+    key = mix(key, static_cast<uint32_t>(dstX));
+    key = mix(key, static_cast<uint32_t>(dstY));
+    addDraw(rect, key);
+}
+
+void DirtyRects::addFill(const SDL_Rect &rect,
+                         const Color &color,
+                         const bool alpha)
+{
+    if (!mCols)
+        return;
+
+    uint32_t key = mix(hashSeed, alpha ? 1U : 0U);
+    key = mix(key, (color.r << 24) | (color.g << 16)
+        | (color.b << 8) | color.a);
+    addDraw(rect, key);
+}
+
+bool DirtyRects::calcRects(SDL_Surface *const surface)
+{
+    mRects.clear();
+    if (!mEnabled || !surface)
+        return false;
+
+    BLOCK_START("DirtyRects::calcRects")
+    const int width = surface->w;
+    const int height = surface->h;
+    if (width != mWidth || height != mHeight)
+    {
+        // draws of this frame was not recorded
+        reset();
+        mWidth = width;
+        mHeight = height;
+        mCols = (width + tileWidth - 1) / tileWidth;
+        mRows = (height + tileHeight - 1) / tileHeight;
+        const size_t size = static_cast<size_t>(mCols * mRows);
+        mHashes.assign(size, hashSeed);
+        mOldHashes.assign(size, hashSeed);
+        mDirtyTiles.assign(size, true);
+        BLOCK_END("DirtyRects::calcRects")
+        return false;
+    }
+
+    const int size = mCols * mRows;
+    int dirtyTiles = 0;
+    for (int f = 0; f < size; f ++)
+        mDirtyTiles[f] = mHashes[f] != mOldHashes[f];
+
+#ifdef DEBUG_DIRTYRECTS
+    checkPixels(surface);
+#endif  // DEBUG_DIRTYRECTS
+
+    mHashes.swap(mOldHashes);
+    std::fill(mHashes.begin(), mHashes.end(), hashSeed);
+    if (mFull)
+    {
+        mFull = false;
+        BLOCK_END("DirtyRects::calcRects")
+        return false;
+    }
+
+    for (int ty = 0; ty < mRows; ty ++)
+    {
+        const int y1 = ty * tileHeight;
+        const int y2 = y1 + tileHeight < height ? y1 + tileHeight : height;
+        const int row = ty * mCols;
+
+        // merge neighbour dirty tiles in one rect
+        int tx = 0;
+        while (tx < mCols)
+        {
+            if (!mDirtyTiles[row + tx])
+            {
+                tx ++;
+                continue;
+            }
+            const int start = tx;
+            while (tx < mCols && mDirtyTiles[row + tx])
+                tx ++;
+            dirtyTiles += tx - start;
+            const int x1 = start * tileWidth;
+            const int x2 = tx * tileWidth < width ? tx * tileWidth : width;
+            const SDL_Rect rect =
+            {
+                static_cast<RectPos>(x1),
+                static_cast<RectPos>(y1),
+                static_cast<RectSize>(x2 - x1),
+                static_cast<RectSize>(y2 - y1)
+            };
+            mRects.push_back(rect);
+        }
+    }
+
+    BLOCK_END("DirtyRects::calcRects")
+    return dirtyTiles * 100 <= size * fullUpdatePercent;
+}
+
+#ifdef DEBUG_DIRTYRECTS
+void DirtyRects::checkPixels(SDL_Surface *const surface)
+{
+    if (SDL_MUSTLOCK(surface))
+        SDL_LockSurface(surface);
+
+    const int pitch = surface->pitch;
+    const uint8_t *const pixels = static_cast<const uint8_t*>(
+        surface->pixels);
+    const size_t size = static_cast<size_t>(pitch * mHeight);
+    if (!mShadow || pitch != mPitch)
+    {
+        delete [] mShadow;
+        mShadow = new uint8_t[size];
+        memcpy(mShadow, pixels, size);
+        mPitch = pitch;
+        if (SDL_MUSTLOCK(surface))
+            SDL_UnlockSurface(surface);
+        return;
+    }
+
+    // compare with previous frame and report tiles missed by draw hashes
+    const int bpp = surface->format->BytesPerPixel;
+    const size_t tileBytes = static_cast<size_t>(tileWidth * bpp);
+    for (int y = 0; y < mHeight; y ++)
+    {
+        const uint8_t *const src = pixels + y * pitch;
+        uint8_t *const dst = mShadow + y * pitch;
+        const int row = (y / tileHeight) * mCols;
+        for (int tx = 0; tx < mCols; tx ++)
+        {
+            const size_t offset = tx * tileBytes;
+            const size_t len = tx == mCols - 1
+                ? static_cast<size_t>(mWidth * bpp) - offset : tileBytes;
+            if (memcmp(src + offset, dst + offset, len))
+            {
+                memcpy(dst + offset, src + offset, len);
+                if (!mDirtyTiles[row + tx] && !mFull)
+                {
+                    logger->log("DirtyRects: missed tile %d,%d",
+                        tx, y / tileHeight);
+                }
+                mDirtyTiles[row + tx] = true;
+            }
+        }
+    }
+
+    if (SDL_MUSTLOCK(surface))
+        SDL_UnlockSurface(surface);
+}
+#endif  // DEBUG_DIRTYRECTS
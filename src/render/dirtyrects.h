@@ -0,0 +1,125 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RENDER_DIRTYRECTS_H
+#define RENDER_DIRTYRECTS_H
+
+#include "gui/color.h"
+
+#include <SDL_video.h>
+
+#include <vector>
+
+#include "localconsts.h"
+
+/**
+ * Finds screen parts changed since previous frame, for partial screen
+ * updates in software modes. Gui redraws all widgets every frame, so
+ * damage collected from draw calls: each screen tile keeps hash of all
+ * draws what touch it, and tile changed if its hash differs from
+ * previous frame. Changes not visible in draw calls, like surface
+ * changed in place, reported by invalidate().
+ */
+class DirtyRects final
+{
+    public:
+        DirtyRects();
+
+        A_DELETE_COPY(DirtyRects)
+
+        ~DirtyRects();
+
+        void setEnabled(const bool enabled);
+
+        bool isEnabled() const A_WARN_UNUSED
+        { return mEnabled; }
+
+        /**
+         * Forgets previous frame. Next update will be full.
+         */
+        void reset();
+
+        /**
+         * Marks whole screen as changed in current frame.
+         */
+        void invalidate()
+        { mFull = true; }
+
+        /**
+         * Records blit with already clipped rects.
+         */
+        void addBlit(SDL_Surface *const src,
+                     const SDL_Rect &srcRect,
+                     const SDL_Rect &dstRect);
+
+        /**
+         * Records blit of source scaled to given size, placed at dstX,
+         * dstY and clipped to rect.
+         */
+        void addScaledBlit(SDL_Surface *const src,
+                           const SDL_Rect &srcRect,
+                           const int scaledWidth,
+                           const int scaledHeight,
+                           const int dstX,
+                           const int dstY,
+                           const SDL_Rect &rect);
+
+        /**
+         * Records fill or line drawing with given color inside rect.
+         */
+        void addFill(const SDL_Rect &rect,
+                     const Color &color,
+                     const bool alpha);
+
+        /**
+         * Finds tiles changed since previous frame and fills changed rects.
+         *
+         * @return true if partial update can be used, false if full
+         *         surface must be updated.
+         */
+        bool calcRects(SDL_Surface *const surface);
+
+        std::vector<SDL_Rect> &getRects() A_WARN_UNUSED
+        { return mRects; }
+
+    private:
+        void addDraw(const SDL_Rect &rect, uint32_t key);
+
+#ifdef DEBUG_DIRTYRECTS
+        void checkPixels(SDL_Surface *const surface);
+#endif  // DEBUG_DIRTYRECTS
+
+        std::vector<SDL_Rect> mRects;
+        std::vector<uint32_t> mHashes;
+        std::vector<uint32_t> mOldHashes;
+        std::vector<bool> mDirtyTiles;
+#ifdef DEBUG_DIRTYRECTS
+        uint8_t *mShadow;
+        int mPitch;
+#endif  // DEBUG_DIRTYRECTS
+        int mWidth;
+        int mHeight;
+        int mCols;
+        int mRows;
+        bool mEnabled;
+        bool mFull;
+};
+
+#endif  // RENDER_DIRTYRECTS_H
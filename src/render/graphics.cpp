@@ -72,6 +72,7 @@
 #include "logger.h"
 
 #include "render/mglxinit.h"
+#include "render/rendertrace.h"
 
 #include "resources/imagehelper.h"
 #include "resources/openglimagehelper.h"
@@ -566,6 +567,9 @@ void Graphics::setWindowSize(const int width A_UNUSED,
 
 void Graphics::pushClipArea(const Rect &area)
 {
+    if (renderTrace && this == mainGraphics)
+        renderTrace->pushClip(area);
+
     // Ignore area with a negate width or height
     // by simple pushing an empty clip area
     // to the stack.
@@ -628,6 +632,8 @@ void Graphics::popClipArea()
     if (mClipStack.empty())
         return;
 
+    if (renderTrace && this == mainGraphics)
+        renderTrace->popClip();
     mClipStack.pop();
 }
 
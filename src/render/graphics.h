@@ -474,6 +474,18 @@ class Graphics notfinal
         virtual void screenResized()
         { }
 
+        /**
+         * Draws all postponed draw commands.
+         */
+        virtual void flushCommands()
+        { }
+
+        /**
+         * Marks whole screen as changed for partial screen updates.
+         */
+        virtual void invalidateScreen()
+        { }
+
         int mWidth;
         int mHeight;
         int mActualWidth;
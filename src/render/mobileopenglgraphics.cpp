@@ -32,6 +32,7 @@
 #include "logger.h"
 
 #include "render/mgl.h"
+#include "render/rendertrace.h"
 
 #include "resources/image.h"
 #include "resources/imagerect.h"
@@ -243,6 +244,8 @@ static inline void drawRescaledQuad(const Image *const image,
 void MobileOpenGLGraphics::drawImage(const Image *const image,
                                      int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
@@ -268,12 +271,16 @@ void MobileOpenGLGraphics::drawImageInline(const Image *const image,
 void MobileOpenGLGraphics::copyImage(const Image *const image,
                                      int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
 void MobileOpenGLGraphics::drawImageCached(const Image *const image,
                                            int x, int y)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, x, y);
     if (!image)
         return;
 
@@ -329,6 +336,8 @@ void MobileOpenGLGraphics::drawPatternCached(const Image *const image,
                                              const int x, const int y,
                                              const int w, const int h)
 {
+    if (renderTrace)
+        renderTrace->addPattern(image, x, y, w, h);
     if (!image)
         return;
 
@@ -408,6 +417,11 @@ void MobileOpenGLGraphics::drawRescaledImage(const Image *const image,
                                              const int desiredWidth,
                                              const int desiredHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledImage(image, dstX, dstY,
+            desiredWidth, desiredHeight);
+    }
     FUNC_BLOCK("Graphics::drawRescaledImage", 1)
     if (!image)
         return;
@@ -437,6 +451,8 @@ void MobileOpenGLGraphics::drawPattern(const Image *const image,
                                        const int x, const int y,
                                        const int w, const int h)
 {
+    if (renderTrace)
+        renderTrace->addPattern(image, x, y, w, h);
     drawPatternInline(image, x, y, w, h);
 }
 
@@ -512,6 +528,11 @@ void MobileOpenGLGraphics::drawRescaledPattern(const Image *const image,
                                                const int scaledWidth,
                                                const int scaledHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledPattern(image, x, y,
+            w, h, scaledWidth, scaledHeight);
+    }
     if (!image)
         return;
 
@@ -1036,12 +1057,10 @@ void MobileOpenGLGraphics::popClipArea()
         clipArea.height * mScale);
 }
 
-#ifdef ANDROID
-void MobileOpenGLGraphics::drawPoint(int x A_UNUSED, int y A_UNUSED)
-#else
 void MobileOpenGLGraphics::drawPoint(int x, int y)
-#endif
 {
+    if (renderTrace)
+        renderTrace->addPoint(x, y, mColor);
     setTexturingAndBlending(false);
     restoreColor();
 
@@ -1056,6 +1075,8 @@ void MobileOpenGLGraphics::drawPoint(int x, int y)
 
 void MobileOpenGLGraphics::drawLine(int x1, int y1, int x2, int y2)
 {
+    if (renderTrace)
+        renderTrace->addLine(x1, y1, x2, y2, mColor);
     setTexturingAndBlending(false);
     restoreColor();
 
@@ -1069,11 +1090,15 @@ void MobileOpenGLGraphics::drawLine(int x1, int y1, int x2, int y2)
 
 void MobileOpenGLGraphics::drawRectangle(const Rect& rect)
 {
+    if (renderTrace)
+        renderTrace->addRect(rect, mColor);
     drawRectangle(rect, false);
 }
 
 void MobileOpenGLGraphics::fillRectangle(const Rect& rect)
 {
+    if (renderTrace)
+        renderTrace->addFillRect(rect, mColor);
     drawRectangle(rect, true);
 }
 
@@ -1323,6 +1348,8 @@ void MobileOpenGLGraphics::drawImageRect(const int x, const int y,
                                          const int w, const int h,
                                          const ImageRect &imgRect)
 {
+    if (renderTrace)
+        renderTrace->addImageRect(x, y, w, h, imgRect);
     #include "render/graphics_drawImageRect.hpp"
 }
 
@@ -32,6 +32,7 @@
 #include "logger.h"
 
 #include "render/mgl.h"
+#include "render/rendertrace.h"
 
 #include "render/shaders/shaderprogram.h"
 #include "render/shaders/shadersmanager.h"
@@ -325,6 +326,8 @@ void ModernOpenGLGraphics::drawRescaledQuad(const Image *const image A_UNUSED,
 void ModernOpenGLGraphics::drawImage(const Image *const image,
                                      int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
@@ -354,6 +357,8 @@ void ModernOpenGLGraphics::drawImageInline(const Image *const image,
 void ModernOpenGLGraphics::copyImage(const Image *const image,
                                      int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
@@ -403,6 +408,11 @@ void ModernOpenGLGraphics::drawRescaledImage(const Image *const image,
                                              const int desiredWidth,
                                              const int desiredHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledImage(image, dstX, dstY,
+            desiredWidth, desiredHeight);
+    }
     if (!image)
         return;
 
@@ -436,6 +446,8 @@ void ModernOpenGLGraphics::drawPattern(const Image *const image,
                                        const int x, const int y,
                                        const int w, const int h)
 {
+    if (renderTrace)
+        renderTrace->addPattern(image, x, y, w, h);
     drawPatternInline(image, x, y, w, h);
 }
 
@@ -505,6 +517,11 @@ void ModernOpenGLGraphics::drawRescaledPattern(const Image *const image,
                                                const int scaledWidth,
                                                const int scaledHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledPattern(image, x, y,
+            w, h, scaledWidth, scaledHeight);
+    }
     if (!image)
         return;
 
@@ -949,6 +966,8 @@ void ModernOpenGLGraphics::popClipArea()
 
 void ModernOpenGLGraphics::drawPoint(int x, int y)
 {
+    if (renderTrace)
+        renderTrace->addPoint(x, y, mColor);
     setTexturingAndBlending(false);
     bindArrayBufferAndAttributes(mVbo);
     const ClipRect &clipArea = mClipStack.top();
@@ -967,6 +986,8 @@ void ModernOpenGLGraphics::drawPoint(int x, int y)
 
 void ModernOpenGLGraphics::drawLine(int x1, int y1, int x2, int y2)
 {
+    if (renderTrace)
+        renderTrace->addLine(x1, y1, x2, y2, mColor);
     setTexturingAndBlending(false);
     bindArrayBufferAndAttributes(mVbo);
     const ClipRect &clipArea = mClipStack.top();
@@ -986,6 +1007,8 @@ void ModernOpenGLGraphics::drawLine(int x1, int y1, int x2, int y2)
 
 void ModernOpenGLGraphics::drawRectangle(const Rect& rect)
 {
+    if (renderTrace)
+        renderTrace->addRect(rect, mColor);
     setTexturingAndBlending(false);
     bindArrayBufferAndAttributes(mVbo);
     const ClipRect &clipArea = mClipStack.top();
@@ -1012,6 +1035,8 @@ void ModernOpenGLGraphics::drawRectangle(const Rect& rect)
 
 void ModernOpenGLGraphics::fillRectangle(const Rect& rect)
 {
+    if (renderTrace)
+        renderTrace->addFillRect(rect, mColor);
     setTexturingAndBlending(false);
     bindArrayBufferAndAttributes(mVbo);
     const ClipRect &clipArea = mClipStack.top();
@@ -1252,6 +1277,8 @@ void ModernOpenGLGraphics::drawImageRect(const int x, const int y,
                                          const int w, const int h,
                                          const ImageRect &imgRect)
 {
+    if (renderTrace)
+        renderTrace->addImageRect(x, y, w, h, imgRect);
     #include "render/graphics_drawImageRect.hpp"
 }
 
@@ -31,6 +31,7 @@
 #include "logger.h"
 
 #include "render/mgl.h"
+#include "render/rendertrace.h"
 
 #include "resources/image.h"
 #include "resources/imagerect.h"
@@ -333,6 +334,8 @@ static inline void drawRescaledQuad(const Image *const image,
 void NormalOpenGLGraphics::drawImage(const Image *const image,
                                      int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
@@ -358,6 +361,8 @@ void NormalOpenGLGraphics::drawImageInline(const Image *const image,
 void NormalOpenGLGraphics::copyImage(const Image *const image,
                                      int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
@@ -416,6 +421,8 @@ void NormalOpenGLGraphics::testDraw()
 void NormalOpenGLGraphics::drawImageCached(const Image *const image,
                                            int x, int y)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, x, y);
     if (!image)
         return;
 
@@ -489,6 +496,8 @@ void NormalOpenGLGraphics::drawPatternCached(const Image *const image,
                                              const int x, const int y,
                                              const int w, const int h)
 {
+    if (renderTrace)
+        renderTrace->addPattern(image, x, y, w, h);
     FUNC_BLOCK("Graphics::drawPatternCached", 1)
     if (!image)
         return;
@@ -596,6 +605,11 @@ void NormalOpenGLGraphics::drawRescaledImage(const Image *const image,
                                              const int desiredWidth,
                                              const int desiredHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledImage(image, dstX, dstY,
+            desiredWidth, desiredHeight);
+    }
     FUNC_BLOCK("Graphics::drawRescaledImage", 1)
     if (!image)
         return;
@@ -625,6 +639,8 @@ void NormalOpenGLGraphics::drawPattern(const Image *const image,
                                        const int x, const int y,
                                        const int w, const int h)
 {
+    if (renderTrace)
+        renderTrace->addPattern(image, x, y, w, h);
     drawPatternInline(image, x, y, w, h);
 }
 
@@ -724,6 +740,11 @@ void NormalOpenGLGraphics::drawRescaledPattern(const Image *const image,
                                                const int scaledWidth,
                                                const int scaledHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledPattern(image, x, y,
+            w, h, scaledWidth, scaledHeight);
+    }
     if (!image)
         return;
 
@@ -1375,6 +1396,8 @@ void NormalOpenGLGraphics::popClipArea()
 
 void NormalOpenGLGraphics::drawPoint(int x, int y)
 {
+    if (renderTrace)
+        renderTrace->addPoint(x, y, mColor);
     setTexturingAndBlending(false);
     restoreColor();
 
@@ -1389,6 +1412,8 @@ void NormalOpenGLGraphics::drawPoint(int x, int y)
 
 void NormalOpenGLGraphics::drawLine(int x1, int y1, int x2, int y2)
 {
+    if (renderTrace)
+        renderTrace->addLine(x1, y1, x2, y2, mColor);
     setTexturingAndBlending(false);
     restoreColor();
 
@@ -1402,11 +1427,15 @@ void NormalOpenGLGraphics::drawLine(int x1, int y1, int x2, int y2)
 
 void NormalOpenGLGraphics::drawRectangle(const Rect& rect)
 {
+    if (renderTrace)
+        renderTrace->addRect(rect, mColor);
     drawRectangle(rect, false);
 }
 
 void NormalOpenGLGraphics::fillRectangle(const Rect& rect)
 {
+    if (renderTrace)
+        renderTrace->addFillRect(rect, mColor);
     drawRectangle(rect, true);
 }
 
@@ -1677,6 +1706,8 @@ void NormalOpenGLGraphics::drawImageRect(const int x, const int y,
                                          const int w, const int h,
                                          const ImageRect &imgRect)
 {
+    if (renderTrace)
+        renderTrace->addImageRect(x, y, w, h, imgRect);
     #include "render/graphics_drawImageRect.hpp"
 }
 
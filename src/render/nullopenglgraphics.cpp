@@ -32,6 +32,8 @@
 #include "logger.h"
 #endif
 
+#include "render/rendertrace.h"
+
 #include "resources/image.h"
 #include "resources/imagerect.h"
 #include "resources/openglimagehelper.h"
@@ -154,12 +156,16 @@ static inline void drawRescaledQuad(const Image *const image A_UNUSED,
 void NullOpenGLGraphics::drawImage(const Image *const image,
                                    int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
 void NullOpenGLGraphics::copyImage(const Image *const image,
                                    int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
@@ -204,6 +210,11 @@ void NullOpenGLGraphics::drawRescaledImage(const Image *const image,
                                            const int desiredWidth,
                                            const int desiredHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledImage(image, dstX, dstY,
+            desiredWidth, desiredHeight);
+    }
     FUNC_BLOCK("Graphics::drawRescaledImage", 1)
     if (!image)
         return;
@@ -233,6 +244,8 @@ void NullOpenGLGraphics::drawPattern(const Image *const image,
                                      const int x, const int y,
                                      const int w, const int h)
 {
+    if (renderTrace)
+        renderTrace->addPattern(image, x, y, w, h);
     drawPatternInline(image, x, y, w, h);
 }
 
@@ -374,6 +387,11 @@ void NullOpenGLGraphics::drawRescaledPattern(const Image *const image,
                                              const int scaledWidth,
                                              const int scaledHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledPattern(image, x, y,
+            w, h, scaledWidth, scaledHeight);
+    }
     if (!image)
         return;
 
@@ -979,8 +997,10 @@ void NullOpenGLGraphics::popClipArea()
         return;
 }
 
-void NullOpenGLGraphics::drawPoint(int x A_UNUSED, int y A_UNUSED)
+void NullOpenGLGraphics::drawPoint(int x, int y)
 {
+    if (renderTrace)
+        renderTrace->addPoint(x, y, mColor);
     setTexturingAndBlending(false);
     restoreColor();
 }
@@ -988,6 +1008,8 @@ void NullOpenGLGraphics::drawPoint(int x A_UNUSED, int y A_UNUSED)
 void NullOpenGLGraphics::drawLine(int x1, int y1,
                                   int x2, int y2)
 {
+    if (renderTrace)
+        renderTrace->addLine(x1, y1, x2, y2, mColor);
     setTexturingAndBlending(false);
     restoreColor();
 
@@ -1001,11 +1023,15 @@ void NullOpenGLGraphics::drawLine(int x1, int y1,
 
 void NullOpenGLGraphics::drawRectangle(const Rect& rect)
 {
+    if (renderTrace)
+        renderTrace->addRect(rect, mColor);
     drawRectangle(rect, false);
 }
 
 void NullOpenGLGraphics::fillRectangle(const Rect& rect)
 {
+    if (renderTrace)
+        renderTrace->addFillRect(rect, mColor);
     drawRectangle(rect, true);
 }
 
@@ -1179,6 +1205,8 @@ void NullOpenGLGraphics::drawImageRect(const int x, const int y,
                                        const int w, const int h,
                                        const ImageRect &imgRect)
 {
+    if (renderTrace)
+        renderTrace->addImageRect(x, y, w, h, imgRect);
     #include "render/graphics_drawImageRect.hpp"
 }
 
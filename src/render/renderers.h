@@ -23,8 +23,13 @@
 
 #include "render/rendertype.h"
 
+class RenderTrace;
+
+extern RenderTrace *renderTrace;
+
 RenderType intToRenderType(const int mode);
 
-#define isBatchDrawRenders(val) ((val) != RENDER_SAFE_OPENGL)
+// cached vertexes can't be recorded, so while recording trace draw directly
+#define isBatchDrawRenders(val) ((val) != RENDER_SAFE_OPENGL && !renderTrace)
 
 #endif  // RENDER_RENDERERS_H
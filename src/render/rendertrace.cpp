@@ -0,0 +1,618 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "render/rendertrace.h"
+
+#include "logger.h"
+
+#include "gui/color.h"
+
+#include "render/graphics.h"
+
+#include "resources/image.h"
+#include "resources/imagehelper.h"
+#include "resources/imagerect.h"
+#include "resources/resourcemanager.h"
+
+#include "utils/dtor.h"
+#include "utils/stringutils.h"
+
+#include <fstream>
+
+#include "debug.h"
+
+RenderTrace *renderTrace = nullptr;
+
+static const char traceMagic[4] = {'M', 'P', 'R', 'T'};
+static const int traceVersion = 1;
+
+RenderTrace::RenderTrace(const std::string &fileName, const int frames) :
+    mData(),
+    mImageIds(),
+    mFileName(fileName),
+    mFrames(frames),
+    mFrame(0)
+{
+    mData.reserve(1024 * 1024);
+    mData.insert(mData.end(), traceMagic, traceMagic + 4);
+    addInt(traceVersion);
+}
+
+RenderTrace::~RenderTrace()
+{
+    save();
+}
+
+void RenderTrace::start(const std::string &fileName, const int frames)
+{
+    if (renderTrace)
+        return;
+    logger->log("Start recording %d frames into %s",
+        frames, fileName.c_str());
+    logger->log1("Cached widget batches will not be recorded");
+    renderTrace = new RenderTrace(fileName, frames);
+}
+
+void RenderTrace::addCommand(const uint8_t type)
+{
+    mData.push_back(type);
+}
+
+void RenderTrace::addInt(const int val)
+{
+    const uint32_t val2 = static_cast<uint32_t>(val);
+    mData.push_back(static_cast<uint8_t>(val2 & 0xff));
+    mData.push_back(static_cast<uint8_t>((val2 >> 8) & 0xff));
+    mData.push_back(static_cast<uint8_t>((val2 >> 16) & 0xff));
+    mData.push_back(static_cast<uint8_t>((val2 >> 24) & 0xff));
+}
+
+void RenderTrace::addColor(const Color &color)
+{
+    mData.push_back(static_cast<uint8_t>(color.r));
+    mData.push_back(static_cast<uint8_t>(color.g));
+    mData.push_back(static_cast<uint8_t>(color.b));
+    mData.push_back(static_cast<uint8_t>(color.a));
+}
+
+int RenderTrace::defineImage(const Image *const image)
+{
+    if (!image)
+        return -1;
+
+    std::string path = image->getIdPath();
+    if (path.empty())
+        path = image->getSource();
+    const SDL_Rect &bounds = image->mBounds;
+    const std::string key = strprintf("%s %d %d %d %d", path.c_str(),
+        bounds.x, bounds.y, bounds.w, bounds.h);
+
+    const ImageIds::const_iterator it = mImageIds.find(key);
+    if (it != mImageIds.end())
+        return (*it).second;
+
+    const int id = static_cast<int>(mImageIds.size());
+    mImageIds[key] = id;
+    addCommand(RenderTraceCommand::IMAGE_DEF);
+    addInt(id);
+    addInt(bounds.x);
+    addInt(bounds.y);
+    addInt(bounds.w);
+    addInt(bounds.h);
+    addInt(static_cast<int>(path.size()));
+    mData.insert(mData.end(), path.begin(), path.end());
+    return id;
+}
+
+void RenderTrace::addImageId(const int id, const Image *const image)
+{
+    addInt(id);
+    if (image)
+        mData.push_back(static_cast<uint8_t>(image->getAlpha() * 255.0F));
+    else
+        mData.push_back(0);
+}
+
+void RenderTrace::addImage(const Image *const image,
+                           const int x, const int y)
+{
+    if (!image)
+        return;
+    const int id = defineImage(image);
+    addCommand(RenderTraceCommand::IMAGE);
+    addImageId(id, image);
+    addInt(x);
+    addInt(y);
+}
+
+void RenderTrace::addRescaledImage(const Image *const image,
+                                   const int x, const int y,
+                                   const int width, const int height)
+{
+    if (!image)
+        return;
+    const int id = defineImage(image);
+    addCommand(RenderTraceCommand::IMAGE_RESCALED);
+    addImageId(id, image);
+    addInt(x);
+    addInt(y);
+    addInt(width);
+    addInt(height);
+}
+
+void RenderTrace::addPattern(const Image *const image,
+                             const int x, const int y,
+                             const int w, const int h)
+{
+    if (!image)
+        return;
+    const int id = defineImage(image);
+    addCommand(RenderTraceCommand::PATTERN);
+    addImageId(id, image);
+    addInt(x);
+    addInt(y);
+    addInt(w);
+    addInt(h);
+}
+
+void RenderTrace::addRescaledPattern(const Image *const image,
+                                     const int x, const int y,
+                                     const int w, const int h,
+                                     const int scaledWidth,
+                                     const int scaledHeight)
+{
+    if (!image)
+        return;
+    const int id = defineImage(image);
+    addCommand(RenderTraceCommand::PATTERN_RESCALED);
+    addImageId(id, image);
+    addInt(x);
+    addInt(y);
+    addInt(w);
+    addInt(h);
+    addInt(scaledWidth);
+    addInt(scaledHeight);
+}
+
+void RenderTrace::addImageRect(const int x, const int y,
+                               const int w, const int h,
+                               const ImageRect &imgRect)
+{
+    int ids[9];
+    for (int f = 0; f < 9; f ++)
+        ids[f] = defineImage(imgRect.grid[f]);
+    addCommand(RenderTraceCommand::IMAGE_RECT);
+    for (int f = 0; f < 9; f ++)
+        addImageId(ids[f], imgRect.grid[f]);
+    addInt(x);
+    addInt(y);
+    addInt(w);
+    addInt(h);
+}
+
+void RenderTrace::addFillRect(const Rect &rect, const Color &color)
+{
+    addCommand(RenderTraceCommand::FILL_RECT);
+    addColor(color);
+    addInt(rect.x);
+    addInt(rect.y);
+    addInt(rect.width);
+    addInt(rect.height);
+}
+
+void RenderTrace::addRect(const Rect &rect, const Color &color)
+{
+    addCommand(RenderTraceCommand::RECT);
+    addColor(color);
+    addInt(rect.x);
+    addInt(rect.y);
+    addInt(rect.width);
+    addInt(rect.height);
+}
+
+void RenderTrace::addLine(const int x1, const int y1,
+                          const int x2, const int y2,
+                          const Color &color)
+{
+    addCommand(RenderTraceCommand::LINE);
+    addColor(color);
+    addInt(x1);
+    addInt(y1);
+    addInt(x2);
+    addInt(y2);
+}
+
+void RenderTrace::addPoint(const int x, const int y, const Color &color)
+{
+    addCommand(RenderTraceCommand::POINT);
+    addColor(color);
+    addInt(x);
+    addInt(y);
+}
+
+void RenderTrace::pushClip(const Rect &rect)
+{
+    addCommand(RenderTraceCommand::PUSH_CLIP);
+    addInt(rect.x);
+    addInt(rect.y);
+    addInt(rect.width);
+    addInt(rect.height);
+}
+
+void RenderTrace::popClip()
+{
+    addCommand(RenderTraceCommand::POP_CLIP);
+}
+
+bool RenderTrace::endFrame()
+{
+    addCommand(RenderTraceCommand::FRAME);
+    mFrame ++;
+    return mFrame >= mFrames;
+}
+
+void RenderTrace::save()
+{
+    std::ofstream file;
+    file.open(mFileName.c_str(), std::ios::out | std::ios::binary);
+    if (!file.is_open())
+    {
+        logger->log("Error saving render trace: %s", mFileName.c_str());
+        return;
+    }
+    if (!mData.empty())
+    {
+        file.write(reinterpret_cast<const char*>(&mData[0]),
+            mData.size());
+    }
+    file.close();
+    logger->log("Saved render trace: %s, frames: %d, images: %u, size: %u",
+        mFileName.c_str(), mFrame,
+        static_cast<unsigned int>(mImageIds.size()),
+        static_cast<unsigned int>(mData.size()));
+}
+
+
+RenderTracePlayer::RenderTracePlayer() :
+    mData(),
+    mImages(),
+    mOwnImages(),
+    mPathImages(),
+    mPos(0),
+    mStart(0),
+    mFrames(0)
+{
+}
+
+RenderTracePlayer::~RenderTracePlayer()
+{
+    delete_all(mOwnImages);
+    mOwnImages.clear();
+    FOR_EACH (std::vector<Image*>::iterator, it, mPathImages)
+        (*it)->decRef();
+    mPathImages.clear();
+}
+
+bool RenderTracePlayer::load(const std::string &fileName)
+{
+    std::ifstream file;
+    file.open(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        logger->log("Error loading render trace: %s", fileName.c_str());
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    const int size = static_cast<int>(file.tellg());
+    file.seekg(0, std::ios::beg);
+    if (size < 8)
+    {
+        logger->log("Wrong render trace file: %s", fileName.c_str());
+        return false;
+    }
+    mData.resize(size);
+    file.read(reinterpret_cast<char*>(&mData[0]), size);
+    file.close();
+
+    if (memcmp(&mData[0], traceMagic, 4))
+    {
+        logger->log("Wrong render trace file: %s", fileName.c_str());
+        return false;
+    }
+    mPos = 4;
+    if (readInt() != traceVersion)
+    {
+        logger->log("Wrong render trace version: %s", fileName.c_str());
+        return false;
+    }
+    mStart = mPos;
+
+    mFrames = 0;
+    while (drawFrame(nullptr))
+        mFrames ++;
+    rewind();
+    logger->log("Loaded render trace: %s, frames: %d",
+        fileName.c_str(), mFrames);
+    return true;
+}
+
+uint8_t RenderTracePlayer::readByte()
+{
+    if (mPos >= mData.size())
+        return RenderTraceCommand::FRAME;
+    return mData[mPos ++];
+}
+
+int RenderTracePlayer::readInt()
+{
+    if (mPos + 4 > mData.size())
+    {
+        mPos = mData.size();
+        return 0;
+    }
+    const uint8_t *const ptr = &mData[mPos];
+    mPos += 4;
+    return static_cast<int>(static_cast<uint32_t>(ptr[0])
+        | (static_cast<uint32_t>(ptr[1]) << 8)
+        | (static_cast<uint32_t>(ptr[2]) << 16)
+        | (static_cast<uint32_t>(ptr[3]) << 24));
+}
+
+Color RenderTracePlayer::readColor()
+{
+    const unsigned int r = readByte();
+    const unsigned int g = readByte();
+    const unsigned int b = readByte();
+    const unsigned int a = readByte();
+    return Color(r, g, b, a);
+}
+
+Rect RenderTracePlayer::readRect()
+{
+    const int x = readInt();
+    const int y = readInt();
+    const int w = readInt();
+    const int h = readInt();
+    return Rect(x, y, w, h);
+}
+
+void RenderTracePlayer::readImageDef(const bool resolve)
+{
+    const int id = readInt();
+    const int x = readInt();
+    const int y = readInt();
+    const int w = readInt();
+    const int h = readInt();
+    const int len = readInt();
+    if (len < 0 || mPos + static_cast<size_t>(len) > mData.size())
+    {
+        mPos = mData.size();
+        return;
+    }
+    const std::string path(reinterpret_cast<const char*>(&mData[mPos]),
+        static_cast<size_t>(len));
+    mPos += static_cast<size_t>(len);
+
+    if (!resolve || id < 0)
+        return;
+    const size_t idx = static_cast<size_t>(id);
+    if (idx >= mImages.size())
+        mImages.resize(idx + 1, nullptr);
+    // definitions seen again after rewind
+    if (!mImages[idx])
+        mImages[idx] = loadImage(path, x, y, w, h);
+}
+
+Image *RenderTracePlayer::loadImage(const std::string &path,
+                                    const int x, const int y,
+                                    const int w, const int h)
+{
+    if (w <= 0 || h <= 0)
+        return nullptr;
+
+    if (!path.empty())
+    {
+        ResourceManager *const resman = ResourceManager::getInstance();
+        Image *const base = resman->getImage(path);
+        if (base)
+        {
+            mPathImages.push_back(base);
+            const SDL_Rect &bounds = base->mBounds;
+            if (bounds.x == x && bounds.y == y
+                && bounds.w == w && bounds.h == h)
+            {
+                return base;
+            }
+            const int x1 = x - bounds.x;
+            const int y1 = y - bounds.y;
+            if (x1 >= 0 && y1 >= 0 && x1 + w <= bounds.w
+                && y1 + h <= bounds.h)
+            {
+                Image *const image = base->getSubImage(x1, y1, w, h);
+                if (image)
+                {
+                    mOwnImages.push_back(image);
+                    return image;
+                }
+            }
+        }
+    }
+
+    // generated images like text replaced by placeholders of same size
+    SDL_Surface *const surface = imageHelper->create32BitSurface(w, h);
+    if (!surface)
+        return nullptr;
+    SDL_FillRect(surface, nullptr,
+        SDL_MapRGBA(surface->format, 128, 128, 128, 200));
+    Image *const image = imageHelper->load(surface);
+    SDL_FreeSurface(surface);
+    if (image)
+        mOwnImages.push_back(image);
+    return image;
+}
+
+Image *RenderTracePlayer::readImage()
+{
+    const int id = readInt();
+    const float alpha = static_cast<float>(readByte()) / 255.0F;
+    if (id < 0 || static_cast<size_t>(id) >= mImages.size())
+        return nullptr;
+    Image *const image = mImages[static_cast<size_t>(id)];
+    if (image && image->getAlpha() != alpha)
+        image->setAlpha(alpha);
+    return image;
+}
+
+bool RenderTracePlayer::drawFrame(Graphics *const graphics)
+{
+    const size_t sz = mData.size();
+    while (mPos < sz)
+    {
+        const uint8_t type = readByte();
+        switch (type)
+        {
+            case RenderTraceCommand::FRAME:
+                return true;
+            case RenderTraceCommand::IMAGE_DEF:
+                readImageDef(graphics != nullptr);
+                break;
+            case RenderTraceCommand::IMAGE:
+            {
+                const Image *const image = readImage();
+                const int x = readInt();
+                const int y = readInt();
+                if (graphics && image)
+                    graphics->drawImage(image, x, y);
+                break;
+            }
+            case RenderTraceCommand::IMAGE_RESCALED:
+            {
+                const Image *const image = readImage();
+                const Rect rect = readRect();
+                if (graphics && image)
+                {
+                    graphics->drawRescaledImage(image, rect.x, rect.y,
+                        rect.width, rect.height);
+                }
+                break;
+            }
+            case RenderTraceCommand::PATTERN:
+            {
+                const Image *const image = readImage();
+                const Rect rect = readRect();
+                if (graphics && image)
+                {
+                    graphics->drawPattern(image, rect.x, rect.y,
+                        rect.width, rect.height);
+                }
+                break;
+            }
+            case RenderTraceCommand::PATTERN_RESCALED:
+            {
+                const Image *const image = readImage();
+                const Rect rect = readRect();
+                const int scaledWidth = readInt();
+                const int scaledHeight = readInt();
+                if (graphics && image)
+                {
+                    graphics->drawRescaledPattern(image, rect.x, rect.y,
+                        rect.width, rect.height, scaledWidth, scaledHeight);
+                }
+                break;
+            }
+            case RenderTraceCommand::IMAGE_RECT:
+            {
+                ImageRect imgRect;
+                for (int f = 0; f < 9; f ++)
+                    imgRect.grid[f] = readImage();
+                const Rect rect = readRect();
+                if (graphics)
+                {
+                    graphics->drawImageRect(rect.x, rect.y,
+                        rect.width, rect.height, imgRect);
+                }
+                break;
+            }
+            case RenderTraceCommand::FILL_RECT:
+            {
+                const Color color = readColor();
+                const Rect rect = readRect();
+                if (graphics)
+                {
+                    graphics->setColor(color);
+                    graphics->fillRectangle(rect);
+                }
+                break;
+            }
+            case RenderTraceCommand::RECT:
+            {
+                const Color color = readColor();
+                const Rect rect = readRect();
+                if (graphics)
+                {
+                    graphics->setColor(color);
+                    graphics->drawRectangle(rect);
+                }
+                break;
+            }
+            case RenderTraceCommand::LINE:
+            {
+                const Color color = readColor();
+                const Rect rect = readRect();
+                if (graphics)
+                {
+                    graphics->setColor(color);
+                    graphics->drawLine(rect.x, rect.y,
+                        rect.width, rect.height);
+                }
+                break;
+            }
+            case RenderTraceCommand::POINT:
+            {
+                const Color color = readColor();
+                const int x = readInt();
+                const int y = readInt();
+                if (graphics)
+                {
+                    graphics->setColor(color);
+                    graphics->drawPoint(x, y);
+                }
+                break;
+            }
+            case RenderTraceCommand::PUSH_CLIP:
+            {
+                const Rect rect = readRect();
+                if (graphics)
+                    graphics->pushClipArea(rect);
+                break;
+            }
+            case RenderTraceCommand::POP_CLIP:
+                if (graphics)
+                    graphics->popClipArea();
+                break;
+            default:
+                logger->log("Unknown render trace command: %d",
+                    static_cast<int>(type));
+                mPos = sz;
+                break;
+        }
+    }
+    return false;
+}
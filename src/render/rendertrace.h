@@ -0,0 +1,200 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RENDER_RENDERTRACE_H
+#define RENDER_RENDERTRACE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "localconsts.h"
+
+class Color;
+class Graphics;
+class Image;
+class ImageRect;
+class Rect;
+
+namespace RenderTraceCommand
+{
+    enum Type
+    {
+        FRAME = 0,
+        IMAGE_DEF,
+        IMAGE,
+        IMAGE_RESCALED,
+        PATTERN,
+        PATTERN_RESCALED,
+        IMAGE_RECT,
+        FILL_RECT,
+        RECT,
+        LINE,
+        POINT,
+        PUSH_CLIP,
+        POP_CLIP
+    };
+}  // namespace RenderTraceCommand
+
+/**
+ * Records draw commands of game frames into binary trace file.
+ * Images stored by id path and bounds. Trace can be played back by
+ * RenderTracePlayer with any graphics backend.
+ * Cached batches drawn by drawTileCollection and drawTileVertexes
+ * (widget skins, emotes, avatars) not recorded, so replay draw less
+ * than real frame. Map layers drawn without batches while recording.
+ */
+class RenderTrace final
+{
+    public:
+        RenderTrace(const std::string &fileName, const int frames);
+
+        A_DELETE_COPY(RenderTrace)
+
+        ~RenderTrace();
+
+        void addImage(const Image *const image,
+                      const int x, const int y);
+
+        void addRescaledImage(const Image *const image,
+                              const int x, const int y,
+                              const int width, const int height);
+
+        void addPattern(const Image *const image,
+                        const int x, const int y,
+                        const int w, const int h);
+
+        void addRescaledPattern(const Image *const image,
+                                const int x, const int y,
+                                const int w, const int h,
+                                const int scaledWidth,
+                                const int scaledHeight);
+
+        void addImageRect(const int x, const int y,
+                          const int w, const int h,
+                          const ImageRect &imgRect);
+
+        void addFillRect(const Rect &rect, const Color &color);
+
+        void addRect(const Rect &rect, const Color &color);
+
+        void addLine(const int x1, const int y1,
+                     const int x2, const int y2,
+                     const Color &color);
+
+        void addPoint(const int x, const int y, const Color &color);
+
+        void pushClip(const Rect &rect);
+
+        void popClip();
+
+        /**
+         * Marks end of frame.
+         *
+         * @return true if all requested frames recorded.
+         */
+        bool endFrame();
+
+        /**
+         * Starts recording if not started yet.
+         */
+        static void start(const std::string &fileName, const int frames);
+
+    private:
+        int defineImage(const Image *const image);
+
+        void addImageId(const int id, const Image *const image);
+
+        void addCommand(const uint8_t type);
+
+        void addInt(const int val);
+
+        void addColor(const Color &color);
+
+        void save();
+
+        typedef std::map<std::string, int> ImageIds;
+
+        std::vector<uint8_t> mData;
+        ImageIds mImageIds;
+        std::string mFileName;
+        int mFrames;
+        int mFrame;
+};
+
+/**
+ * Plays recorded trace with current graphics backend.
+ */
+class RenderTracePlayer final
+{
+    public:
+        RenderTracePlayer();
+
+        A_DELETE_COPY(RenderTracePlayer)
+
+        ~RenderTracePlayer();
+
+        bool load(const std::string &fileName);
+
+        /**
+         * Draws next frame from trace.
+         *
+         * @return false if no more frames.
+         */
+        bool drawFrame(Graphics *const graphics);
+
+        void rewind()
+        { mPos = mStart; }
+
+        int getFramesCount() const A_WARN_UNUSED
+        { return mFrames; }
+
+    private:
+        void readImageDef(const bool resolve);
+
+        Image *loadImage(const std::string &path,
+                         const int x, const int y,
+                         const int w, const int h) A_WARN_UNUSED;
+
+        int readInt() A_WARN_UNUSED;
+
+        uint8_t readByte() A_WARN_UNUSED;
+
+        Image *readImage() A_WARN_UNUSED;
+
+        Color readColor() A_WARN_UNUSED;
+
+        Rect readRect() A_WARN_UNUSED;
+
+        std::vector<uint8_t> mData;
+        // images by trace id
+        std::vector<Image*> mImages;
+        // sub images and placeholders
+        std::vector<Image*> mOwnImages;
+        // images from resource manager
+        std::vector<Image*> mPathImages;
+        size_t mPos;
+        size_t mStart;
+        int mFrames;
+};
+
+extern RenderTrace *renderTrace;
+
+#endif  // RENDER_RENDERTRACE_H
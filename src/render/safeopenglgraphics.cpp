@@ -29,6 +29,7 @@
 #include "graphicsmanager.h"
 
 #include "render/mgl.h"
+#include "render/rendertrace.h"
 
 #include "resources/image.h"
 #include "resources/imagerect.h"
@@ -152,6 +153,8 @@ static inline void drawRescaledQuad(const Image *const image,
 void SafeOpenGLGraphics::drawImage(const Image *const image,
                                    int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
@@ -177,6 +180,8 @@ void SafeOpenGLGraphics::drawImageInline(const Image *const image,
 void SafeOpenGLGraphics::copyImage(const Image *const image,
                                    int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
@@ -213,6 +218,8 @@ void SafeOpenGLGraphics::testDraw()
 void SafeOpenGLGraphics::drawImageCached(const Image *const image,
                                          int x, int y)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, x, y);
     FUNC_BLOCK("Graphics::drawImageCached", 1)
     if (!image)
         return;
@@ -232,6 +239,8 @@ void SafeOpenGLGraphics::drawPatternCached(const Image *const image,
                                            const int x, const int y,
                                            const int w, const int h)
 {
+    if (renderTrace)
+        renderTrace->addPattern(image, x, y, w, h);
     FUNC_BLOCK("Graphics::drawPatternCached", 1)
     if (!image)
         return;
@@ -276,6 +285,11 @@ void SafeOpenGLGraphics::drawRescaledImage(const Image *const image,
                                            const int desiredWidth,
                                            const int desiredHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledImage(image, dstX, dstY,
+            desiredWidth, desiredHeight);
+    }
     FUNC_BLOCK("Graphics::drawRescaledImage", 1)
     if (!image)
         return;
@@ -304,6 +318,8 @@ void SafeOpenGLGraphics::drawPattern(const Image *const image,
                                      const int x, const int y,
                                      const int w, const int h)
 {
+    if (renderTrace)
+        renderTrace->addPattern(image, x, y, w, h);
     drawPatternInline(image, x, y, w, h);
 }
 
@@ -352,6 +368,11 @@ void SafeOpenGLGraphics::drawRescaledPattern(const Image *const image,
                                              const int scaledWidth,
                                              const int scaledHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledPattern(image, x, y,
+            w, h, scaledWidth, scaledHeight);
+    }
     if (!image)
         return;
 
@@ -611,6 +632,8 @@ void SafeOpenGLGraphics::popClipArea()
 
 void SafeOpenGLGraphics::drawPoint(int x, int y)
 {
+    if (renderTrace)
+        renderTrace->addPoint(x, y, mColor);
     setTexturingAndBlending(false);
     restoreColor();
 
@@ -647,6 +670,8 @@ void SafeOpenGLGraphics::drawNet(const int x1, const int y1,
 
 void SafeOpenGLGraphics::drawLine(int x1, int y1, int x2, int y2)
 {
+    if (renderTrace)
+        renderTrace->addLine(x1, y1, x2, y2, mColor);
     setTexturingAndBlending(false);
     restoreColor();
 
@@ -658,11 +683,15 @@ void SafeOpenGLGraphics::drawLine(int x1, int y1, int x2, int y2)
 
 void SafeOpenGLGraphics::drawRectangle(const Rect& rect)
 {
+    if (renderTrace)
+        renderTrace->addRect(rect, mColor);
     drawRectangle(rect, false);
 }
 
 void SafeOpenGLGraphics::fillRectangle(const Rect& rect)
 {
+    if (renderTrace)
+        renderTrace->addFillRect(rect, mColor);
     drawRectangle(rect, true);
 }
 
@@ -767,6 +796,8 @@ void SafeOpenGLGraphics::drawImageRect(const int x, const int y,
                                        const int w, const int h,
                                        const ImageRect &imgRect)
 {
+    if (renderTrace)
+        renderTrace->addImageRect(x, y, w, h, imgRect);
     #include "render/graphics_drawImageRect.hpp"
 }
 
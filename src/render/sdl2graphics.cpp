@@ -74,6 +74,8 @@
 #include "graphicsvertexes.h"
 #include "logger.h"
 
+#include "render/rendertrace.h"
+
 #include "resources/image.h"
 #include "resources/imagehelper.h"
 #include "resources/imagerect.h"
@@ -146,6 +148,11 @@ void SDLGraphics::drawRescaledImage(const Image *const image,
                                     const int desiredWidth,
                                     const int desiredHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledImage(image, dstX, dstY,
+            desiredWidth, desiredHeight);
+    }
     FUNC_BLOCK("Graphics::drawRescaledImage", 1)
     // Check that preconditions for blitting are met.
     if (!mWindow || !image || !image->mTexture)
@@ -174,6 +181,8 @@ void SDLGraphics::drawRescaledImage(const Image *const image,
 void SDLGraphics::drawImage(const Image *const image,
                             int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
@@ -212,12 +221,16 @@ void SDLGraphics::drawImageInline(const Image *const image,
 void SDLGraphics::copyImage(const Image *const image,
                             int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
 void SDLGraphics::drawImageCached(const Image *const image,
                                   int x, int y)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, x, y);
     FUNC_BLOCK("Graphics::drawImageCached", 1)
     // Check that preconditions for blitting are met.
     if (!mWindow || !image || !image->mTexture)
@@ -251,6 +264,8 @@ void SDLGraphics::drawPatternCached(const Image *const image,
                                     const int x, const int y,
                                     const int w, const int h)
 {
+    if (renderTrace)
+        renderTrace->addPattern(image, x, y, w, h);
     FUNC_BLOCK("Graphics::drawPatternCached", 1)
     // Check that preconditions for blitting are met.
     if (!mWindow || !image)
@@ -302,6 +317,8 @@ void SDLGraphics::drawPattern(const Image *const image,
                               const int x, const int y,
                               const int w, const int h)
 {
+    if (renderTrace)
+        renderTrace->addPattern(image, x, y, w, h);
     drawPatternInline(image, x, y, w, h);
 }
 
@@ -358,6 +375,11 @@ void SDLGraphics::drawRescaledPattern(const Image *const image,
                                       const int scaledWidth,
                                       const int scaledHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledPattern(image, x, y,
+            w, h, scaledWidth, scaledHeight);
+    }
     // Check that preconditions for blitting are met.
     if (!mWindow || !image)
         return;
@@ -451,9 +473,9 @@ void SDLGraphics::calcPatternInline(ImageVertexes* const vert,
             const int dw = (px + iw >= w) ? w - px : iw;
             const int dstX = px + xOffset;
 
-            DoubleRect *const r = new DoubleRect();
-            SDL_Rect &dstRect = r->dst;
-            SDL_Rect &srcRect = r->src;
+            DoubleRect r;
+            SDL_Rect &dstRect = r.dst;
+            SDL_Rect &srcRect = r.src;
             srcRect.x = static_cast<int32_t>(srcX);
             srcRect.y = static_cast<int32_t>(srcY);
             srcRect.w = static_cast<int32_t>(dw);
@@ -522,9 +544,9 @@ void SDLGraphics::calcTileSDL(ImageVertexes *const vert, int x, int y) const
     x += top.xOffset;
     y += top.yOffset;
 
-    DoubleRect *rect = new DoubleRect();
-    SDL_Rect &dstRect = rect->dst;
-    SDL_Rect &srcRect = rect->src;
+    DoubleRect rect;
+    SDL_Rect &dstRect = rect.dst;
+    SDL_Rect &srcRect = rect.src;
 
     srcRect.x = static_cast<int32_t>(bounds.x);
     srcRect.y = static_cast<int32_t>(bounds.y);
@@ -572,7 +594,7 @@ void SDLGraphics::drawTileCollection(const ImageCollection
         while (it2 != it2_end)
         {
             MSDL_RenderCopy(mRenderer, img->mTexture,
-                &(*it2)->src, &(*it2)->dst);
+                &(*it2).src, &(*it2).dst);
             ++ it2;
         }
     }
@@ -587,7 +609,7 @@ void SDLGraphics::drawTileVertexes(const ImageVertexes *const vert)
     const DoubleRects::const_iterator it_end = rects->end();
     while (it != it_end)
     {
-        MSDL_RenderCopy(mRenderer, img->mTexture, &(*it)->src, &(*it)->dst);
+        MSDL_RenderCopy(mRenderer, img->mTexture, &(*it).src, &(*it).dst);
         ++ it;
     }
 }
@@ -646,6 +668,8 @@ void SDLGraphics::calcWindow(ImageCollection *const vertCol,
 
 void SDLGraphics::fillRectangle(const Rect &rectangle)
 {
+    if (renderTrace)
+        renderTrace->addFillRect(rectangle, mColor);
     const ClipRect &top = mClipStack.top();
     const SDL_Rect rect =
     {
@@ -692,6 +716,8 @@ void SDLGraphics::popClipArea()
 
 void SDLGraphics::drawPoint(int x, int y)
 {
+    if (renderTrace)
+        renderTrace->addPoint(x, y, mColor);
     if (mClipStack.empty())
         return;
 
@@ -716,6 +742,8 @@ void SDLGraphics::drawPoint(int x, int y)
 
 void SDLGraphics::drawRectangle(const Rect &rectangle)
 {
+    if (renderTrace)
+        renderTrace->addRect(rectangle, mColor);
     const ClipRect &top = mClipStack.top();
     setRenderDrawColor(mColor);
 
@@ -737,6 +765,8 @@ void SDLGraphics::drawRectangle(const Rect &rectangle)
 
 void SDLGraphics::drawLine(int x1, int y1, int x2, int y2)
 {
+    if (renderTrace)
+        renderTrace->addLine(x1, y1, x2, y2, mColor);
     const ClipRect &top = mClipStack.top();
     setRenderDrawColor(mColor);
 
@@ -785,6 +815,8 @@ void SDLGraphics::drawImageRect(const int x, const int y,
                                 const int w, const int h,
                                 const ImageRect &imgRect)
 {
+    if (renderTrace)
+        renderTrace->addImageRect(x, y, w, h, imgRect);
     #include "render/graphics_drawImageRect.hpp"
 }
 
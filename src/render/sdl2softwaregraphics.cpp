@@ -31,6 +31,8 @@
 #include "graphicsvertexes.h"
 #include "logger.h"
 
+#include "render/rendertrace.h"
+
 #include "resources/image.h"
 #include "resources/imagehelper.h"
 #include "resources/imagerect.h"
@@ -62,7 +64,9 @@ SDL2SoftwareGraphics::SDL2SoftwareGraphics() :
     mRendererFlags(SDL_RENDERER_SOFTWARE),
     mSurface(nullptr),
     mOldPixel(0),
-    mOldAlpha(0)
+    mOldAlpha(0),
+    mBands(),
+    mDirtyRects()
 {
     mOpenGL = RENDER_SOFTWARE;
     mName = "Software";
@@ -77,6 +81,11 @@ void SDL2SoftwareGraphics::drawRescaledImage(const Image *const image,
                                              const int desiredWidth,
                                              const int desiredHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledImage(image, dstX, dstY,
+            desiredWidth, desiredHeight);
+    }
     FUNC_BLOCK("Graphics::drawRescaledImage", 1)
     // Check that preconditions for blitting are met.
     if (!mSurface || !image || !image->mSDLSurface)
@@ -107,13 +116,73 @@ void SDL2SoftwareGraphics::drawRescaledImage(const Image *const image,
         0
     };
 
+    mBands.flush();
     SDL_BlitSurface(tmpImage->mSDLSurface, &srcRect, mSurface, &dstRect);
+    mDirtyRects.addScaledBlit(image->mSDLSurface, srcRect,
+        desiredWidth, desiredHeight,
+        dstX + top.xOffset, dstY + top.yOffset, dstRect);
     delete tmpImage;
 }
 
+void inline SDL2SoftwareGraphics::blitSurface(SDL_Surface *const src,
+                                              const SDL_Rect &srcRect,
+                                              const SDL_Rect &dstRect)
+{
+    mDirtyRects.addBlit(src, srcRect, dstRect);
+    if (mBands.isEnabled())
+    {
+        mBands.addBlit(src, srcRect, dstRect);
+    }
+    else
+    {
+        SDL_Rect srcRect2 = srcRect;
+        SDL_Rect dstRect2 = dstRect;
+        SDL_LowerBlit(src, &srcRect2, mSurface, &dstRect2);
+    }
+}
+
+void SDL2SoftwareGraphics::addDirtyRect(const int x, const int y,
+                                        const int w, const int h)
+{
+    const SDL_Rect rect =
+    {
+        static_cast<RectPos>(x),
+        static_cast<RectPos>(y),
+        static_cast<RectSize>(w),
+        static_cast<RectSize>(h)
+    };
+    mDirtyRects.addFill(rect, mColor, mAlpha);
+}
+
+void SDL2SoftwareGraphics::addBandRect(const int x, const int y,
+                                       const int w, const int h)
+{
+    const SDL_Rect rect =
+    {
+        static_cast<RectPos>(x),
+        static_cast<RectPos>(y),
+        static_cast<RectSize>(w),
+        static_cast<RectSize>(h)
+    };
+    if (mAlpha)
+    {
+        mBands.addAlphaFill(rect, mColor);
+    }
+    else
+    {
+        mBands.addFill(rect, SDL_MapRGBA(mSurface->format,
+            static_cast<uint8_t>(mColor.r),
+            static_cast<uint8_t>(mColor.g),
+            static_cast<uint8_t>(mColor.b),
+            static_cast<uint8_t>(mColor.a)));
+    }
+}
+
 void SDL2SoftwareGraphics::drawImage(const Image *const image,
                                      int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
@@ -200,19 +269,23 @@ void SDL2SoftwareGraphics::drawImageInline(const Image *const image,
             static_cast<uint16_t>(h)
         };
 
-        SDL_LowerBlit(src, &srcRect, mSurface, &dstRect);
+        blitSurface(src, srcRect, dstRect);
     }
 }
 
 void SDL2SoftwareGraphics::copyImage(const Image *const image,
                                      int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
 void SDL2SoftwareGraphics::drawImageCached(const Image *const image,
                                            int x, int y)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, x, y);
     FUNC_BLOCK("Graphics::drawImageCached", 1)
     // Check that preconditions for blitting are met.
     if (!mSurface || !image || !image->mSDLSurface)
@@ -293,7 +366,7 @@ void SDL2SoftwareGraphics::drawImageCached(const Image *const image,
             static_cast<uint16_t>(h)
         };
 
-        SDL_LowerBlit(src, &srcRect, mSurface, &dstRect);
+        blitSurface(src, srcRect, dstRect);
     }
 }
 
@@ -301,6 +374,8 @@ void SDL2SoftwareGraphics::drawPatternCached(const Image *const image,
                                              const int x, const int y,
                                              const int w, const int h)
 {
+    if (renderTrace)
+        renderTrace->addPattern(image, x, y, w, h);
     FUNC_BLOCK("Graphics::drawPatternCached", 1)
     // Check that preconditions for blitting are met.
     if (!mSurface || !image)
@@ -398,7 +473,7 @@ void SDL2SoftwareGraphics::drawPatternCached(const Image *const image,
                         static_cast<uint16_t>(h2)
                     };
 
-                    SDL_LowerBlit(src, &srcRect, mSurface, &dstRect);
+                    blitSurface(src, srcRect, dstRect);
                 }
 
 //            SDL_BlitSurface(image->mSDLSurface, &srcRect, mWindow, &dstRect);
@@ -415,6 +490,8 @@ void SDL2SoftwareGraphics::drawPattern(const Image *const image,
                                        const int x, const int y,
                                        const int w, const int h)
 {
+    if (renderTrace)
+        renderTrace->addPattern(image, x, y, w, h);
     drawPatternInline(image, x, y, w, h);
 }
 
@@ -519,7 +596,7 @@ void SDL2SoftwareGraphics::drawPatternInline(const Image *const image,
                         static_cast<uint16_t>(h2)
                     };
 
-                    SDL_LowerBlit(src, &srcRect, mSurface, &dstRect);
+                    blitSurface(src, srcRect, dstRect);
                 }
 
 //            SDL_BlitSurface(image->mSDLSurface, &srcRect, mWindow, &dstRect);
@@ -534,6 +611,11 @@ void SDL2SoftwareGraphics::drawRescaledPattern(const Image *const image,
                                                const int scaledWidth,
                                                const int scaledHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledPattern(image, x, y,
+            w, h, scaledWidth, scaledHeight);
+    }
     // Check that preconditions for blitting are met.
     if (!mSurface || !image)
         return;
@@ -586,8 +668,11 @@ void SDL2SoftwareGraphics::drawRescaledPattern(const Image *const image,
                 0
             };
 
+            mBands.flush();
             SDL_BlitSurface(tmpImage->mSDLSurface, &srcRect,
                             mSurface, &dstRect);
+            mDirtyRects.addScaledBlit(image->mSDLSurface, srcRect,
+                scaledWidth, scaledHeight, dstX, dstY, dstRect);
         }
     }
 
@@ -633,13 +718,13 @@ void SDL2SoftwareGraphics::calcPatternInline(ImageVertexes* const vert,
             const int dw = (px + iw >= w) ? w - px : iw;
             const int dstX = px + xOffset;
 
-            DoubleRect *const r = new DoubleRect();
-            SDL_Rect &srcRect = r->src;
+            DoubleRect r;
+            SDL_Rect &srcRect = r.src;
             srcRect.x = static_cast<int16_t>(srcX);
             srcRect.y = static_cast<int16_t>(srcY);
             srcRect.w = static_cast<uint16_t>(dw);
             srcRect.h = static_cast<uint16_t>(dh);
-            SDL_Rect &dstRect = r->dst;
+            SDL_Rect &dstRect = r.dst;
             dstRect.x = static_cast<int16_t>(dstX);
             dstRect.y = static_cast<int16_t>(dstY);
 
@@ -648,10 +733,6 @@ void SDL2SoftwareGraphics::calcPatternInline(ImageVertexes* const vert,
             {
                 vert->sdl.push_back(r);
             }
-            else
-            {
-                delete r;
-            }
         }
     }
 }
@@ -705,22 +786,18 @@ void SDL2SoftwareGraphics::calcTileSDL(ImageVertexes *const vert,
     const ClipRect &top = mClipStack.top();
     const SDL_Rect &bounds = image->mBounds;
 
-    DoubleRect *rect = new DoubleRect();
-    rect->src.x = static_cast<int16_t>(bounds.x);
-    rect->src.y = static_cast<int16_t>(bounds.y);
-    rect->src.w = static_cast<uint16_t>(bounds.w);
-    rect->src.h = static_cast<uint16_t>(bounds.h);
-    rect->dst.x = static_cast<int16_t>(x + top.xOffset);
-    rect->dst.y = static_cast<int16_t>(y + top.yOffset);
-    if (SDL_FakeUpperBlit(image->mSDLSurface, &rect->src,
-        mSurface, &rect->dst) == 1)
+    DoubleRect rect;
+    rect.src.x = static_cast<int16_t>(bounds.x);
+    rect.src.y = static_cast<int16_t>(bounds.y);
+    rect.src.w = static_cast<uint16_t>(bounds.w);
+    rect.src.h = static_cast<uint16_t>(bounds.h);
+    rect.dst.x = static_cast<int16_t>(x + top.xOffset);
+    rect.dst.y = static_cast<int16_t>(y + top.yOffset);
+    if (SDL_FakeUpperBlit(image->mSDLSurface, &rect.src,
+        mSurface, &rect.dst) == 1)
     {
         vert->sdl.push_back(rect);
     }
-    else
-    {
-        delete rect;
-    }
 }
 
 void SDL2SoftwareGraphics::calcTileCollection(ImageCollection *const vertCol,
@@ -756,8 +833,7 @@ void SDL2SoftwareGraphics::drawTileCollection(const ImageCollection
         const DoubleRects::const_iterator it2_end = rects->end();
         while (it2 != it2_end)
         {
-            SDL_LowerBlit(img->mSDLSurface, &(*it2)->src,
-                mSurface, &(*it2)->dst);
+            blitSurface(img->mSDLSurface, (*it2).src, (*it2).dst);
             ++ it2;
         }
     }
@@ -772,7 +848,7 @@ void SDL2SoftwareGraphics::drawTileVertexes(const ImageVertexes *const vert)
     const DoubleRects::const_iterator it_end = rects->end();
     while (it != it_end)
     {
-        SDL_LowerBlit(img->mSDLSurface, &(*it)->src, mSurface, &(*it)->dst);
+        blitSurface(img->mSDLSurface, (*it).src, (*it).dst);
         ++ it;
     }
 }
@@ -780,12 +856,26 @@ void SDL2SoftwareGraphics::drawTileVertexes(const ImageVertexes *const vert)
 void SDL2SoftwareGraphics::updateScreen()
 {
     BLOCK_START("Graphics::updateScreen")
-    SDL_UpdateWindowSurfaceRects(mWindow, &mRect, 1);
+    mBands.flush();
+    if (mDirtyRects.calcRects(mSurface))
+    {
+        const std::vector<SDL_Rect> &rects = mDirtyRects.getRects();
+        if (!rects.empty())
+        {
+            SDL_UpdateWindowSurfaceRects(mWindow, &rects[0],
+                static_cast<int>(rects.size()));
+        }
+    }
+    else
+    {
+        SDL_UpdateWindowSurfaceRects(mWindow, &mRect, 1);
+    }
     BLOCK_END("Graphics::updateScreen")
 }
 
 SDL_Surface *SDL2SoftwareGraphics::getScreenshot()
 {
+    mBands.flush();
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
     const int rmask = 0xff000000;
     const int gmask = 0x00ff0000;
@@ -912,6 +1002,8 @@ int SDL2SoftwareGraphics::SDL_FakeUpperBlit(const SDL_Surface *const src,
 
 void SDL2SoftwareGraphics::fillRectangle(const Rect &rectangle)
 {
+    if (renderTrace)
+        renderTrace->addFillRect(rectangle, mColor);
     FUNC_BLOCK("Graphics::fillRectangle", 1)
     if (mClipStack.empty())
         return;
@@ -925,14 +1017,22 @@ void SDL2SoftwareGraphics::fillRectangle(const Rect &rectangle)
     if (!area.isIntersecting(top))
         return;
 
+    const int x1 = area.x > top.x ? area.x : top.x;
+    const int y1 = area.y > top.y ? area.y : top.y;
+    const int x2 = area.x + area.width < top.x + top.width ?
+        area.x + area.width : top.x + top.width;
+    const int y2 = area.y + area.height < top.y + top.height ?
+        area.y + area.height : top.y + top.height;
+    addDirtyRect(x1, y1, x2 - x1, y2 - y1);
+
+    if (mBands.isEnabled())
+    {
+        addBandRect(x1, y1, x2 - x1, y2 - y1);
+        return;
+    }
+
     if (mAlpha)
     {
-        const int x1 = area.x > top.x ? area.x : top.x;
-        const int y1 = area.y > top.y ? area.y : top.y;
-        const int x2 = area.x + area.width < top.x + top.width ?
-            area.x + area.width : top.x + top.width;
-        const int y2 = area.y + area.height < top.y + top.height ?
-            area.y + area.height : top.y + top.height;
         int x, y;
 
         SDL_LockSurface(mSurface);
@@ -1134,6 +1234,8 @@ void SDL2SoftwareGraphics::popClipArea()
 
 void SDL2SoftwareGraphics::drawPoint(int x, int y)
 {
+    if (renderTrace)
+        renderTrace->addPoint(x, y, mColor);
     if (mClipStack.empty())
         return;
 
@@ -1145,7 +1247,10 @@ void SDL2SoftwareGraphics::drawPoint(int x, int y)
     if (!top.isPointInRect(x, y))
         return;
 
-    if (mAlpha)
+    addDirtyRect(x, y, 1, 1);
+    if (mBands.isEnabled())
+        addBandRect(x, y, 1, 1);
+    else if (mAlpha)
         SDLputPixelAlpha(mSurface, x, y, mColor);
     else
         SDLputPixel(mSurface, x, y, mColor);
@@ -1192,6 +1297,13 @@ void SDL2SoftwareGraphics::drawHLine(int x1, int y, int x2)
         x2 = sumX -1;
     }
 
+    addDirtyRect(x1, y, x2 - x1 + 1, 1);
+    if (mBands.isEnabled())
+    {
+        addBandRect(x1, y, x2 - x1 + 1, 1);
+        return;
+    }
+
     const int bpp = mSurface->format->BytesPerPixel;
 
     SDL_LockSurface(mSurface);
@@ -1317,6 +1429,13 @@ void SDL2SoftwareGraphics::drawVLine(int x, int y1, int y2)
         y2 = sumY - 1;
     }
 
+    addDirtyRect(x, y1, 1, y2 - y1 + 1);
+    if (mBands.isEnabled())
+    {
+        addBandRect(x, y1, 1, y2 - y1 + 1);
+        return;
+    }
+
     const int bpp = mSurface->format->BytesPerPixel;
 
     SDL_LockSurface(mSurface);
@@ -1415,6 +1534,8 @@ void SDL2SoftwareGraphics::drawVLine(int x, int y1, int y2)
 
 void SDL2SoftwareGraphics::drawRectangle(const Rect &rectangle)
 {
+    if (renderTrace)
+        renderTrace->addRect(rectangle, mColor);
     const int x1 = rectangle.x;
     const int x2 = x1 + rectangle.width - 1;
     const int y1 = rectangle.y;
@@ -1429,6 +1550,8 @@ void SDL2SoftwareGraphics::drawRectangle(const Rect &rectangle)
 
 void SDL2SoftwareGraphics::drawLine(int x1, int y1, int x2, int y2)
 {
+    if (renderTrace)
+        renderTrace->addLine(x1, y1, x2, y2, mColor);
     if (x1 == x2)
     {
         drawVLine(x1, y1, y2);
@@ -1450,6 +1573,7 @@ bool SDL2SoftwareGraphics::setVideoMode(const int w, const int h,
                                         const bool noFrame)
 {
     setMainFlags(w, h, scale, bpp, fs, hwaccel, resize, noFrame);
+    mBands.clear();
 
     if (!(mWindow = graphicsManager.createWindow(w, h, bpp,
         getSoftwareFlags())))
@@ -1457,10 +1581,14 @@ bool SDL2SoftwareGraphics::setVideoMode(const int w, const int h,
         mRect.w = 0;
         mRect.h = 0;
         mSurface = nullptr;
+        mBands.setTarget(nullptr);
         return false;
     }
 
     mSurface = SDL_GetWindowSurface(mWindow);
+    mBands.setTarget(mSurface);
+    mBands.setThreads(config.getIntValue("softwareRenderThreads"));
+    mDirtyRects.setEnabled(config.getBoolValue("softwareDirtyRects"));
     ImageHelper::dumpSurfaceFormat(mSurface);
     SDL2SoftwareImageHelper::setFormat(mSurface->format);
 
@@ -1476,9 +1604,12 @@ bool SDL2SoftwareGraphics::setVideoMode(const int w, const int h,
 
 bool SDL2SoftwareGraphics::resizeScreen(const int width, const int height)
 {
+    mBands.clear();
     const bool ret = Graphics::resizeScreen(width, height);
 
     mSurface = SDL_GetWindowSurface(mWindow);
+    mBands.setTarget(mSurface);
+    mDirtyRects.reset();
     SDL2SoftwareImageHelper::setFormat(mSurface->format);
     return ret;
 }
@@ -1487,6 +1618,8 @@ void SDL2SoftwareGraphics::drawImageRect(const int x, const int y,
                                          const int w, const int h,
                                          const ImageRect &imgRect)
 {
+    if (renderTrace)
+        renderTrace->addImageRect(x, y, w, h, imgRect);
     #include "render/graphics_drawImageRect.hpp"
 }
 
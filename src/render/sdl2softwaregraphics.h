@@ -25,6 +25,8 @@
 
 #ifdef USE_SDL2
 
+#include "render/bandrenderer.h"
+#include "render/dirtyrects.h"
 #include "render/graphics.h"
 
 #include "localconsts.h"
@@ -61,6 +63,12 @@ class SDL2SoftwareGraphics final : public Graphics
 
         #include "render/softwaregraphicsdef.hpp"
 
+        void flushCommands() override final
+        { mBands.flush(); }
+
+        void invalidateScreen() override final
+        { mDirtyRects.invalidate(); }
+
         bool resizeScreen(const int width, const int height) override final;
 
     protected:
@@ -73,10 +81,22 @@ class SDL2SoftwareGraphics final : public Graphics
 
         void drawVLine(int x, int y1, int y2);
 
+        void addBandRect(const int x, const int y,
+                         const int w, const int h);
+
+        void addDirtyRect(const int x, const int y,
+                          const int w, const int h);
+
+        void inline blitSurface(SDL_Surface *const src,
+                                const SDL_Rect &srcRect,
+                                const SDL_Rect &dstRect);
+
         uint32_t mRendererFlags;
         SDL_Surface *mSurface;
         uint32_t mOldPixel;
         unsigned int mOldAlpha;
+        BandRenderer mBands;
+        DirtyRects mDirtyRects;
 };
 
 #endif  // USE_SDL2
@@ -26,6 +26,7 @@
 
 #include "main.h"
 
+#include "configuration.h"
 #include "graphicsmanager.h"
 #include "graphicsvertexes.h"
 
@@ -33,6 +34,8 @@
 
 #include "utils/sdlpixel.h"
 
+#include "render/rendertrace.h"
+
 #include "resources/image.h"
 #include "resources/imagerect.h"
 
@@ -47,7 +50,9 @@ static unsigned int *cB = nullptr;
 SDLGraphics::SDLGraphics() :
     Graphics(),
     mOldPixel(0),
-    mOldAlpha(0)
+    mOldAlpha(0),
+    mBands(),
+    mDirtyRects()
 {
     mOpenGL = RENDER_SOFTWARE;
     mName = "Software";
@@ -62,6 +67,11 @@ void SDLGraphics::drawRescaledImage(const Image *const image,
                                     const int desiredWidth,
                                     const int desiredHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledImage(image, dstX, dstY,
+            desiredWidth, desiredHeight);
+    }
     FUNC_BLOCK("Graphics::drawRescaledImage", 1)
     // Check that preconditions for blitting are met.
     if (!mWindow || !image || !image->mSDLSurface)
@@ -92,13 +102,73 @@ void SDLGraphics::drawRescaledImage(const Image *const image,
         0
     };
 
+    mBands.flush();
     SDL_BlitSurface(tmpImage->mSDLSurface, &srcRect, mWindow, &dstRect);
+    mDirtyRects.addScaledBlit(image->mSDLSurface, srcRect,
+        desiredWidth, desiredHeight,
+        dstX + top.xOffset, dstY + top.yOffset, dstRect);
     delete tmpImage;
 }
 
+void inline SDLGraphics::blitSurface(SDL_Surface *const src,
+                                     const SDL_Rect &srcRect,
+                                     const SDL_Rect &dstRect)
+{
+    mDirtyRects.addBlit(src, srcRect, dstRect);
+    if (mBands.isEnabled())
+    {
+        mBands.addBlit(src, srcRect, dstRect);
+    }
+    else
+    {
+        SDL_Rect srcRect2 = srcRect;
+        SDL_Rect dstRect2 = dstRect;
+        SDL_LowerBlit(src, &srcRect2, mWindow, &dstRect2);
+    }
+}
+
+void SDLGraphics::addDirtyRect(const int x, const int y,
+                               const int w, const int h)
+{
+    const SDL_Rect rect =
+    {
+        static_cast<RectPos>(x),
+        static_cast<RectPos>(y),
+        static_cast<RectSize>(w),
+        static_cast<RectSize>(h)
+    };
+    mDirtyRects.addFill(rect, mColor, mAlpha);
+}
+
+void SDLGraphics::addBandRect(const int x, const int y,
+                              const int w, const int h)
+{
+    const SDL_Rect rect =
+    {
+        static_cast<RectPos>(x),
+        static_cast<RectPos>(y),
+        static_cast<RectSize>(w),
+        static_cast<RectSize>(h)
+    };
+    if (mAlpha)
+    {
+        mBands.addAlphaFill(rect, mColor);
+    }
+    else
+    {
+        mBands.addFill(rect, SDL_MapRGBA(mWindow->format,
+            static_cast<uint8_t>(mColor.r),
+            static_cast<uint8_t>(mColor.g),
+            static_cast<uint8_t>(mColor.b),
+            static_cast<uint8_t>(mColor.a)));
+    }
+}
+
 void SDLGraphics::drawImage(const Image *const image,
                             int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
@@ -185,19 +255,23 @@ void SDLGraphics::drawImageInline(const Image *const image,
             static_cast<uint16_t>(h)
         };
 
-        SDL_LowerBlit(src, &srcRect, mWindow, &dstRect);
+        blitSurface(src, srcRect, dstRect);
     }
 }
 
 void SDLGraphics::copyImage(const Image *const image,
                             int dstX, int dstY)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, dstX, dstY);
     drawImageInline(image, dstX, dstY);
 }
 
 void SDLGraphics::drawImageCached(const Image *const image,
                                   int x, int y)
 {
+    if (renderTrace)
+        renderTrace->addImage(image, x, y);
     FUNC_BLOCK("Graphics::drawImageCached", 1)
     // Check that preconditions for blitting are met.
     if (!mWindow || !image || !image->mSDLSurface)
@@ -278,7 +352,7 @@ void SDLGraphics::drawImageCached(const Image *const image,
             static_cast<uint16_t>(h)
         };
 
-        SDL_LowerBlit(src, &srcRect, mWindow, &dstRect);
+        blitSurface(src, srcRect, dstRect);
     }
 }
 
@@ -286,6 +360,8 @@ void SDLGraphics::drawPatternCached(const Image *const image,
                                     const int x, const int y,
                                     const int w, const int h)
 {
+    if (renderTrace)
+        renderTrace->addPattern(image, x, y, w, h);
     FUNC_BLOCK("Graphics::drawPatternCached", 1)
     // Check that preconditions for blitting are met.
     if (!mWindow || !image)
@@ -383,7 +459,7 @@ void SDLGraphics::drawPatternCached(const Image *const image,
                         static_cast<uint16_t>(h2)
                     };
 
-                    SDL_LowerBlit(src, &srcRect, mWindow, &dstRect);
+                    blitSurface(src, srcRect, dstRect);
                 }
 
 //            SDL_BlitSurface(image->mSDLSurface, &srcRect, mWindow, &dstRect);
@@ -400,6 +476,8 @@ void SDLGraphics::drawPattern(const Image *const image,
                               const int x, const int y,
                               const int w, const int h)
 {
+    if (renderTrace)
+        renderTrace->addPattern(image, x, y, w, h);
     drawPatternInline(image, x, y, w, h);
 }
 
@@ -504,7 +582,7 @@ void SDLGraphics::drawPatternInline(const Image *const image,
                         static_cast<uint16_t>(h2)
                     };
 
-                    SDL_LowerBlit(src, &srcRect, mWindow, &dstRect);
+                    blitSurface(src, srcRect, dstRect);
                 }
 
 //            SDL_BlitSurface(image->mSDLSurface, &srcRect, mWindow, &dstRect);
@@ -519,6 +597,11 @@ void SDLGraphics::drawRescaledPattern(const Image *const image,
                                       const int scaledWidth,
                                       const int scaledHeight)
 {
+    if (renderTrace)
+    {
+        renderTrace->addRescaledPattern(image, x, y,
+            w, h, scaledWidth, scaledHeight);
+    }
     // Check that preconditions for blitting are met.
     if (!mWindow || !image)
         return;
@@ -571,8 +654,11 @@ void SDLGraphics::drawRescaledPattern(const Image *const image,
                 0
             };
 
+            mBands.flush();
             SDL_BlitSurface(tmpImage->mSDLSurface, &srcRect,
                             mWindow, &dstRect);
+            mDirtyRects.addScaledBlit(image->mSDLSurface, srcRect,
+                scaledWidth, scaledHeight, dstX, dstY, dstRect);
         }
     }
 
@@ -618,13 +704,13 @@ void SDLGraphics::calcPatternInline(ImageVertexes* const vert,
             const int dw = (px + iw >= w) ? w - px : iw;
             const int dstX = px + xOffset;
 
-            DoubleRect *const r = new DoubleRect();
-            SDL_Rect &srcRect = r->src;
+            DoubleRect r;
+            SDL_Rect &srcRect = r.src;
             srcRect.x = static_cast<int16_t>(srcX);
             srcRect.y = static_cast<int16_t>(srcY);
             srcRect.w = static_cast<uint16_t>(dw);
             srcRect.h = static_cast<uint16_t>(dh);
-            SDL_Rect &dstRect = r->dst;
+            SDL_Rect &dstRect = r.dst;
             dstRect.x = static_cast<int16_t>(dstX);
             dstRect.y = static_cast<int16_t>(dstY);
 
@@ -633,10 +719,6 @@ void SDLGraphics::calcPatternInline(ImageVertexes* const vert,
             {
                 vert->sdl.push_back(r);
             }
-            else
-            {
-                delete r;
-            }
         }
     }
 }
@@ -689,22 +771,18 @@ void SDLGraphics::calcTileSDL(ImageVertexes *const vert, int x, int y) const
     const ClipRect &top = mClipStack.top();
     const SDL_Rect &bounds = image->mBounds;
 
-    DoubleRect *rect = new DoubleRect();
-    rect->src.x = static_cast<int16_t>(bounds.x);
-    rect->src.y = static_cast<int16_t>(bounds.y);
-    rect->src.w = static_cast<uint16_t>(bounds.w);
-    rect->src.h = static_cast<uint16_t>(bounds.h);
-    rect->dst.x = static_cast<int16_t>(x + top.xOffset);
-    rect->dst.y = static_cast<int16_t>(y + top.yOffset);
-    if (SDL_FakeUpperBlit(image->mSDLSurface, &rect->src,
-        mWindow, &rect->dst) == 1)
+    DoubleRect rect;
+    rect.src.x = static_cast<int16_t>(bounds.x);
+    rect.src.y = static_cast<int16_t>(bounds.y);
+    rect.src.w = static_cast<uint16_t>(bounds.w);
+    rect.src.h = static_cast<uint16_t>(bounds.h);
+    rect.dst.x = static_cast<int16_t>(x + top.xOffset);
+    rect.dst.y = static_cast<int16_t>(y + top.yOffset);
+    if (SDL_FakeUpperBlit(image->mSDLSurface, &rect.src,
+        mWindow, &rect.dst) == 1)
     {
         vert->sdl.push_back(rect);
     }
-    else
-    {
-        delete rect;
-    }
 }
 
 void SDLGraphics::calcTileCollection(ImageCollection *const vertCol,
@@ -740,8 +818,7 @@ void SDLGraphics::drawTileCollection(const ImageCollection
         const DoubleRects::const_iterator it2_end = rects->end();
         while (it2 != it2_end)
         {
-            SDL_LowerBlit(img->mSDLSurface, &(*it2)->src,
-                mWindow, &(*it2)->dst);
+            blitSurface(img->mSDLSurface, (*it2).src, (*it2).dst);
             ++ it2;
         }
     }
@@ -756,7 +833,7 @@ void SDLGraphics::drawTileVertexes(const ImageVertexes *const vert)
     const DoubleRects::const_iterator it_end = rects->end();
     while (it != it_end)
     {
-        SDL_LowerBlit(img->mSDLSurface, &(*it)->src, mWindow, &(*it)->dst);
+        blitSurface(img->mSDLSurface, (*it).src, (*it).dst);
         ++ it;
     }
 }
@@ -764,10 +841,20 @@ void SDLGraphics::drawTileVertexes(const ImageVertexes *const vert)
 void SDLGraphics::updateScreen()
 {
     BLOCK_START("Graphics::updateScreen")
+    mBands.flush();
     if (mDoubleBuffer)
     {
         SDL_Flip(mWindow);
     }
+    else if (mDirtyRects.calcRects(mWindow))
+    {
+        std::vector<SDL_Rect> &rects = mDirtyRects.getRects();
+        if (!rects.empty())
+        {
+            SDL_UpdateRects(mWindow, static_cast<int>(rects.size()),
+                &rects[0]);
+        }
+    }
     else
     {
         SDL_UpdateRects(mWindow, 1, &mRect);
@@ -778,6 +865,7 @@ void SDLGraphics::updateScreen()
 
 SDL_Surface *SDLGraphics::getScreenshot()
 {
+    mBands.flush();
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
     const int rmask = 0xff000000;
     const int gmask = 0x00ff0000;
@@ -901,6 +989,8 @@ int SDLGraphics::SDL_FakeUpperBlit(const SDL_Surface *const src,
 
 void SDLGraphics::fillRectangle(const Rect& rectangle)
 {
+    if (renderTrace)
+        renderTrace->addFillRect(rectangle, mColor);
     FUNC_BLOCK("Graphics::fillRectangle", 1)
     if (mClipStack.empty())
         return;
@@ -914,14 +1004,22 @@ void SDLGraphics::fillRectangle(const Rect& rectangle)
     if (!area.isIntersecting(top))
         return;
 
+    const int x1 = area.x > top.x ? area.x : top.x;
+    const int y1 = area.y > top.y ? area.y : top.y;
+    const int x2 = area.x + area.width < top.x + top.width ?
+        area.x + area.width : top.x + top.width;
+    const int y2 = area.y + area.height < top.y + top.height ?
+        area.y + area.height : top.y + top.height;
+    addDirtyRect(x1, y1, x2 - x1, y2 - y1);
+
+    if (mBands.isEnabled())
+    {
+        addBandRect(x1, y1, x2 - x1, y2 - y1);
+        return;
+    }
+
     if (mAlpha)
     {
-        const int x1 = area.x > top.x ? area.x : top.x;
-        const int y1 = area.y > top.y ? area.y : top.y;
-        const int x2 = area.x + area.width < top.x + top.width ?
-            area.x + area.width : top.x + top.width;
-        const int y2 = area.y + area.height < top.y + top.height ?
-            area.y + area.height : top.y + top.height;
         int x, y;
 
         SDL_LockSurface(mWindow);
@@ -1145,6 +1243,8 @@ void SDLGraphics::popClipArea()
 
 void SDLGraphics::drawPoint(int x, int y)
 {
+    if (renderTrace)
+        renderTrace->addPoint(x, y, mColor);
     if (mClipStack.empty())
         return;
 
@@ -1156,7 +1256,10 @@ void SDLGraphics::drawPoint(int x, int y)
     if (!top.isPointInRect(x, y))
         return;
 
-    if (mAlpha)
+    addDirtyRect(x, y, 1, 1);
+    if (mBands.isEnabled())
+        addBandRect(x, y, 1, 1);
+    else if (mAlpha)
         SDLputPixelAlpha(mWindow, x, y, mColor);
     else
         SDLputPixel(mWindow, x, y, mColor);
@@ -1203,6 +1306,13 @@ void SDLGraphics::drawHLine(int x1, int y, int x2)
         x2 = sumX -1;
     }
 
+    addDirtyRect(x1, y, x2 - x1 + 1, 1);
+    if (mBands.isEnabled())
+    {
+        addBandRect(x1, y, x2 - x1 + 1, 1);
+        return;
+    }
+
     const int bpp = mWindow->format->BytesPerPixel;
 
     SDL_LockSurface(mWindow);
@@ -1328,6 +1438,13 @@ void SDLGraphics::drawVLine(int x, int y1, int y2)
         y2 = sumY - 1;
     }
 
+    addDirtyRect(x, y1, 1, y2 - y1 + 1);
+    if (mBands.isEnabled())
+    {
+        addBandRect(x, y1, 1, y2 - y1 + 1);
+        return;
+    }
+
     const int bpp = mWindow->format->BytesPerPixel;
 
     SDL_LockSurface(mWindow);
@@ -1426,6 +1543,8 @@ void SDLGraphics::drawVLine(int x, int y1, int y2)
 
 void SDLGraphics::drawRectangle(const Rect &rectangle)
 {
+    if (renderTrace)
+        renderTrace->addRect(rectangle, mColor);
     const int x1 = rectangle.x;
     const int x2 = x1 + rectangle.width - 1;
     const int y1 = rectangle.y;
@@ -1440,6 +1559,8 @@ void SDLGraphics::drawRectangle(const Rect &rectangle)
 
 void SDLGraphics::drawLine(int x1, int y1, int x2, int y2)
 {
+    if (renderTrace)
+        renderTrace->addLine(x1, y1, x2, y2, mColor);
     if (x1 == x2)
     {
         drawVLine(x1, y1, y2);
@@ -1463,15 +1584,21 @@ bool SDLGraphics::setVideoMode(const int w, const int h,
                                const bool noFrame)
 {
     setMainFlags(w, h, scale, bpp, fs, hwaccel, resize, noFrame);
+    mBands.clear();
 
     if (!(mWindow = graphicsManager.createWindow(w, h, bpp,
         getSoftwareFlags())))
     {
         mRect.w = 0;
         mRect.h = 0;
+        mBands.setTarget(nullptr);
         return false;
     }
 
+    mBands.setTarget(mWindow);
+    mBands.setThreads(config.getIntValue("softwareRenderThreads"));
+    mDirtyRects.setEnabled(config.getBoolValue("softwareDirtyRects"));
+
     mRect.w = static_cast<uint16_t>(mWindow->w);
     mRect.h = static_cast<uint16_t>(mWindow->h);
 
@@ -1482,6 +1609,8 @@ void SDLGraphics::drawImageRect(const int x, const int y,
                                 const int w, const int h,
                                 const ImageRect &imgRect)
 {
+    if (renderTrace)
+        renderTrace->addImageRect(x, y, w, h, imgRect);
     #include "render/graphics_drawImageRect.hpp"
 }
 
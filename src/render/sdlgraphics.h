@@ -28,6 +28,8 @@
 
 #else
 
+#include "render/bandrenderer.h"
+#include "render/dirtyrects.h"
 #include "render/graphics.h"
 
 #include "localconsts.h"
@@ -58,6 +60,12 @@ class SDLGraphics final : public Graphics
 
         #include "render/softwaregraphicsdef.hpp"
 
+        void flushCommands() override final
+        { mBands.flush(); }
+
+        void invalidateScreen() override final
+        { mDirtyRects.invalidate(); }
+
     protected:
         int SDL_FakeUpperBlit(const SDL_Surface *const src,
                               SDL_Rect *const srcrect,
@@ -68,8 +76,20 @@ class SDLGraphics final : public Graphics
 
         void drawVLine(int x, int y1, int y2);
 
+        void addBandRect(const int x, const int y,
+                         const int w, const int h);
+
+        void addDirtyRect(const int x, const int y,
+                          const int w, const int h);
+
+        void inline blitSurface(SDL_Surface *const src,
+                                const SDL_Rect &srcRect,
+                                const SDL_Rect &dstRect);
+
         uint32_t mOldPixel;
         unsigned int mOldAlpha;
+        BandRenderer mBands;
+        DirtyRects mDirtyRects;
 };
 
 #endif  // USE_SDL2
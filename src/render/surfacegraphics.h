@@ -35,6 +35,8 @@ struct SDL_Surface;
 
 /**
  * A central point of control for graphics.
+ * Draws immediately, without band renderer: target surface used by
+ * caller right after drawing, and there is no frame flush point.
  */
 class SurfaceGraphics final : public Graphics
 {
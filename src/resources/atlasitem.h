@@ -29,6 +29,16 @@
 
 struct AtlasItem final
 {
+    AtlasItem() :
+        image(nullptr),
+        name(),
+        x(0),
+        y(0),
+        width(0),
+        height(0)
+    {
+    }
+
     explicit AtlasItem(Image *const image0) :
         image(image0),
         name(),
@@ -25,27 +25,216 @@
 #include "resources/atlasmanager.h"
 
 #include "configuration.h"
-
-#ifdef DEBUG_IMAGES
 #include "logger.h"
-#endif
+#include "settings.h"
 
 #include "utils/mathutils.h"
-#include "utils/physfscheckutils.h"
-#include "utils/physfsrwops.h"
+#include "utils/mkdir.h"
+#include "utils/physfstools.h"
 #include "utils/sdlcheckutils.h"
+#include "utils/stringutils.h"
 
 #include "resources/atlasitem.h"
 #include "resources/atlasresource.h"
-#include "resources/dye.h"
+#include "resources/imagedecoder.h"
 #include "resources/imagehelper.h"
 #include "resources/openglimagehelper.h"
 #include "resources/resourcemanager.h"
 #include "resources/sdlimagehelper.h"
 #include "resources/textureatlas.h"
 
+#include <algorithm>
+#include <climits>
+#include <fstream>
+
+#include <zlib.h>
+
 #include "debug.h"
 
+static const char atlasCacheMagic[4] = {'M', 'P', 'A', 'C'};
+static const int atlasCacheVersion = 1;
+
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+static const unsigned int atlasRmask = 0xff000000;
+static const unsigned int atlasGmask = 0x00ff0000;
+static const unsigned int atlasBmask = 0x0000ff00;
+static const unsigned int atlasAmask = 0x000000ff;
+#else
+static const unsigned int atlasRmask = 0x000000ff;
+static const unsigned int atlasGmask = 0x0000ff00;
+static const unsigned int atlasBmask = 0x00ff0000;
+static const unsigned int atlasAmask = 0xff000000;
+#endif
+
+static class SortAtlasImageFunctor final
+{
+    public:
+        bool operator() (const Image *const image1,
+                         const Image *const image2) const
+        {
+            if (image1->mBounds.h != image2->mBounds.h)
+                return image1->mBounds.h > image2->mBounds.h;
+            return image1->mBounds.w > image2->mBounds.w;
+        }
+} atlasImageSorter;
+
+struct SkylineNode final
+{
+    SkylineNode(const int x0, const int y0, const int width0) :
+        x(x0),
+        y(y0),
+        width(width0)
+    {
+    }
+
+    int x;
+    int y;
+    int width;
+};
+
+typedef std::vector<SkylineNode> Skyline;
+
+// return y position for rect placed at node idx, or -1 if it not fit
+static int skylineFit(const Skyline &skyline,
+                      const size_t idx,
+                      const int width,
+                      const int height,
+                      const int binWidth,
+                      const int binHeight)
+{
+    const int x = skyline[idx].x;
+    if (x + width > binWidth)
+        return -1;
+    int y = 0;
+    int widthLeft = width;
+    const size_t sz = skyline.size();
+    for (size_t f = idx; f < sz && widthLeft > 0; f ++)
+    {
+        const SkylineNode &node = skyline[f];
+        if (node.y > y)
+            y = node.y;
+        if (y + height > binHeight)
+            return -1;
+        widthLeft -= node.width;
+    }
+    return y;
+}
+
+static bool skylineInsert(Skyline &skyline,
+                          const int width,
+                          const int height,
+                          const int binWidth,
+                          const int binHeight,
+                          int &outX,
+                          int &outY)
+{
+    int bestTop = INT_MAX;
+    int bestWidth = INT_MAX;
+    int bestIdx = -1;
+    const int sz = static_cast<int>(skyline.size());
+    for (int f = 0; f < sz; f ++)
+    {
+        const int y = skylineFit(skyline, static_cast<size_t>(f),
+            width, height, binWidth, binHeight);
+        if (y < 0)
+            continue;
+        const int top = y + height;
+        const int nodeWidth = skyline[f].width;
+        if (top < bestTop || (top == bestTop && nodeWidth < bestWidth))
+        {
+            bestTop = top;
+            bestWidth = nodeWidth;
+            bestIdx = f;
+            outX = skyline[f].x;
+            outY = y;
+        }
+    }
+    if (bestIdx < 0)
+        return false;
+
+    skyline.insert(skyline.begin() + bestIdx,
+        SkylineNode(outX, outY + height, width));
+
+    // cut nodes covered by new node
+    const int right = outX + width;
+    for (size_t f = static_cast<size_t>(bestIdx + 1); f < skyline.size(); )
+    {
+        SkylineNode &node = skyline[f];
+        if (node.x >= right)
+            break;
+        const int shrink = right - node.x;
+        if (node.width <= shrink)
+        {
+            skyline.erase(skyline.begin() + f);
+            continue;
+        }
+        node.x += shrink;
+        node.width -= shrink;
+        break;
+    }
+
+    // merge nodes with same height
+    for (size_t f = 0; f + 1 < skyline.size(); )
+    {
+        if (skyline[f].y == skyline[f + 1].y)
+        {
+            skyline[f].width += skyline[f + 1].width;
+            skyline.erase(skyline.begin() + f + 1);
+        }
+        else
+        {
+            f ++;
+        }
+    }
+    return true;
+}
+
+struct AtlasPlacement final
+{
+    AtlasPlacement(Image *const image0, const int x0, const int y0) :
+        image(image0),
+        x(x0),
+        y(y0)
+    {
+    }
+
+    Image *image;
+    int x;
+    int y;
+};
+
+typedef std::vector<AtlasPlacement> AtlasPlacements;
+
+// pack images into one bin. Images what not fit moved to rest.
+static int packImages(const std::vector<Image*> &images,
+                      const int binWidth,
+                      const int binHeight,
+                      AtlasPlacements &placed,
+                      std::vector<Image*> &rest)
+{
+    Skyline skyline;
+    skyline.push_back(SkylineNode(0, 0, binWidth));
+    int usedHeight = 0;
+    FOR_EACH (std::vector<Image*>::const_iterator, it, images)
+    {
+        Image *const img = *it;
+        int x = 0;
+        int y = 0;
+        if (skylineInsert(skyline, img->mBounds.w, img->mBounds.h,
+            binWidth, binHeight, x, y))
+        {
+            placed.push_back(AtlasPlacement(img, x, y));
+            if (y + img->mBounds.h > usedHeight)
+                usedHeight = y + img->mBounds.h;
+        }
+        else
+        {
+            rest.push_back(img);
+        }
+    }
+    return usedHeight;
+}
+
 AtlasManager::AtlasManager()
 {
 }
@@ -54,11 +243,6 @@ AtlasResource *AtlasManager::loadTextureAtlas(const std::string &name,
                                               const StringVect &files)
 {
     BLOCK_START("AtlasManager::loadTextureAtlas")
-    std::vector<TextureAtlas*> atlases;
-    std::vector<Image*> images;
-    AtlasResource *resource = new AtlasResource;
-
-    loadImages(files, images);
     int maxSize = OpenGLImageHelper::getTextureSize();
 #if !defined(ANDROID) && !defined(__APPLE__)
     const int sz = config.getIntValue("textureSize");
@@ -66,8 +250,23 @@ AtlasResource *AtlasManager::loadTextureAtlas(const std::string &name,
         maxSize = sz;
 #endif
 
+    const std::string cacheKey = getCacheKey(name, files, maxSize);
+    AtlasResource *resource = loadCache(name, cacheKey, files);
+    if (resource)
+    {
+        BLOCK_END("AtlasManager::loadTextureAtlas")
+        return resource;
+    }
+
+    std::vector<TextureAtlas*> atlases;
+    std::vector<Image*> images;
+    std::vector<SDL_Surface*> surfaces;
+    resource = new AtlasResource;
+
+    loadImages(files, images);
+
     // sorting images on atlases.
-    simpleSort(name, atlases, images, maxSize);
+    skylineSort(name, atlases, images, maxSize);
 
     FOR_EACH (std::vector<TextureAtlas*>::iterator, it, atlases)
     {
@@ -79,7 +278,17 @@ AtlasResource *AtlasManager::loadTextureAtlas(const std::string &name,
         SDL_Surface *const surface = createSDLAtlas(atlas);
 
         if (!surface)
+        {
+            // image will be loaded without atlas
+            FOR_EACH (std::vector<AtlasItem*>::iterator, it2, atlas->items)
+            {
+                AtlasItem *const item = *it2;
+                delete item->image;
+                delete item;
+            }
+            delete atlas;
             continue;
+        }
 
         // debug save
 //        ImageWriter::writePNG(surface, settings.tempDir
@@ -89,151 +298,156 @@ AtlasResource *AtlasManager::loadTextureAtlas(const std::string &name,
         // convert SDL images to OpenGL
         convertAtlas(atlas);
 
-        // free SDL atlas surface
-        MSDL_FreeSurface(surface);
-
+        surfaces.push_back(surface);
         resource->atlases.push_back(atlas);
     }
 
+    saveCache(name, cacheKey, resource->atlases, surfaces);
+
+    // free SDL atlas surfaces
+    FOR_EACH (std::vector<SDL_Surface*>::iterator, it, surfaces)
+        MSDL_FreeSurface(*it);
+
     BLOCK_END("AtlasManager::loadTextureAtlas")
     return resource;
 }
 
-void AtlasManager::loadImages(const StringVect &files,
-                              std::vector<Image*> &images)
+void AtlasManager::moveOldImages(const StringVect &files)
 {
-    BLOCK_START("AtlasManager::loadImages")
     ResourceManager *const resman = ResourceManager::getInstance();
 
     FOR_EACH (StringVectCIter, it, files)
     {
-        const std::string str = *it;
         // check is image with same name already in cache
         // and if yes, move it to deleted set
-        Resource *const res = resman->getTempResource(str);
+        Resource *const res = resman->getTempResource(*it);
         if (res)
         {
             // increase counter because in moveToDeleted it will be decreased.
             res->incRef();
             resman->moveToDeleted(res);
         }
+    }
+}
 
-        std::string path = str;
-        const size_t p = path.find('|');
-        Dye *d = nullptr;
-        if (p != std::string::npos)
-        {
-            d = new Dye(path.substr(p + 1));
-            path = path.substr(0, p);
-        }
+void AtlasManager::loadImages(const StringVect &files,
+                              std::vector<Image*> &images)
+{
+    BLOCK_START("AtlasManager::loadImages")
+    moveOldImages(files);
 
-        SDL_RWops *const rw = MPHYSFSRWOPS_openRead(path.c_str());
-        if (rw)
-        {
-            Image *const image = d ? surfaceImageHelper->load(rw, *d)
-                : surfaceImageHelper->load(rw);
+    // decode and dye images in parallel, upload only in this thread
+    std::vector<SDL_Surface*> surfaces;
+    ResourceManager::getInstance()->getImageDecoder()->decode(
+        surfaceImageHelper, files, surfaces);
 
-            if (image)
-            {
-                image->mIdPath = str;
+    const size_t sz = surfaces.size();
+    for (size_t f = 0; f < sz; f ++)
+    {
+        SDL_Surface *const surface = surfaces[f];
+        if (!surface)
+            continue;
+
+        Image *const image = surfaceImageHelper->load(surface);
+        MSDL_FreeSurface(surface);
+        if (image)
+        {
+            image->mIdPath = files[f];
 #ifdef DEBUG_IMAGES
-                logger->log("set name %p, %s", static_cast<void*>(image),
-                    image->mIdPath.c_str());
+            logger->log("set name %p, %s", static_cast<void*>(image),
+                image->mIdPath.c_str());
 #endif
-                images.push_back(image);
-            }
+            images.push_back(image);
         }
-        delete d;
     }
     BLOCK_END("AtlasManager::loadImages")
 }
 
-void AtlasManager::simpleSort(const std::string &restrict name,
-                              std::vector<TextureAtlas*> &restrict atlases,
-                              const std::vector<Image*> &restrict images,
-                              int size)
+static TextureAtlas *createAtlas(const std::string &name,
+                                 const AtlasPlacements &placed)
 {
-    BLOCK_START("AtlasManager::simpleSort")
-    int x = 0;
-    int y = 0;
-    int tempHeight = 0;
-    TextureAtlas *atlas = new TextureAtlas();
-    std::vector<Image*>::const_iterator it = images.begin();
-    const std::vector<Image*>::const_iterator it_end = images.end();
-    for (it = images.begin(); it != it_end; ++ it)
+    TextureAtlas *const atlas = new TextureAtlas();
+    FOR_EACH (AtlasPlacements::const_iterator, it, placed)
     {
-        const Image *const img = *it;
-        if (img)
+        const AtlasPlacement &place = *it;
+        Image *const img = place.image;
+        if (atlas->items.empty())
         {
             atlas->name = std::string("atlas_").append(name).append(
                 "_").append(img->getIdPath());
-            break;
         }
+        AtlasItem *const item = new AtlasItem(img);
+        item->name = img->getIdPath();
+        item->x = place.x;
+        item->y = place.y;
+        atlas->items.push_back(item);
+        if (item->x + item->width > atlas->width)
+            atlas->width = item->x + item->width;
+        if (item->y + item->height > atlas->height)
+            atlas->height = item->y + item->height;
     }
+    return atlas;
+}
 
-    for (it = images.begin(); it != it_end; ++ it)
+void AtlasManager::skylineSort(const std::string &restrict name,
+                               std::vector<TextureAtlas*> &restrict atlases,
+                               const std::vector<Image*> &restrict images,
+                               const int size)
+{
+    BLOCK_START("AtlasManager::skylineSort")
+    std::vector<Image*> sorted;
+    sorted.reserve(images.size());
+    int maxWidth = 1;
+    FOR_EACH (std::vector<Image*>::const_iterator, it, images)
     {
         Image *const img = *it;
         if (img)
         {
-            AtlasItem *const item = new AtlasItem(img);
-            item->name = img->getIdPath();
-            // start next line
-            if (x + img->mBounds.w > size)
-            {
-                x = 0;
-                y += tempHeight;
-                tempHeight = 0;
-            }
+            sorted.push_back(img);
+            if (img->mBounds.w > maxWidth)
+                maxWidth = img->mBounds.w;
+        }
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), atlasImageSorter);
 
-            // cant put image with this height
-            if (y + img->mBounds.h > size)
+    while (!sorted.empty())
+    {
+        // try find smallest page what can hold all images
+        int bestWidth = 0;
+        int bestArea = INT_MAX;
+        for (int width = powerOfTwo(maxWidth); width <= size; width *= 2)
+        {
+            AtlasPlacements placed;
+            std::vector<Image*> rest;
+            const int height = packImages(sorted, width, size, placed, rest);
+            if (!rest.empty())
+                continue;
+            const int area = width * powerOfTwo(height);
+            if (area < bestArea)
             {
-                x = 0;
-                y = 0;
-                atlases.push_back(atlas);
-                atlas = new TextureAtlas();
-                atlas->name = std::string("atlas_").append(name).append(
-                    "_").append(img->getIdPath());
+                bestArea = area;
+                bestWidth = width;
             }
+        }
 
-            if (img->mBounds.h > tempHeight)
-                tempHeight = img->mBounds.h;
-
-            item->x = x;
-            item->y = y;
-            atlas->items.push_back(item);
-
-            // continue put textures in line
-            x += img->mBounds.w;
-            if (x > atlas->width)
-                atlas->width = x;
-            if (y + img->mBounds.h > atlas->height)
-                atlas->height = y + img->mBounds.h;
+        AtlasPlacements placed;
+        std::vector<Image*> rest;
+        packImages(sorted, bestWidth ? bestWidth : size, size, placed, rest);
+        if (placed.empty())
+        {
+            // image bigger than texture size
+            placed.push_back(AtlasPlacement(sorted[0], 0, 0));
+            rest.assign(sorted.begin() + 1, sorted.end());
         }
+        atlases.push_back(createAtlas(name, placed));
+        sorted.swap(rest);
     }
-    if (!atlas->items.empty())
-        atlases.push_back(atlas);
-    else
-        delete atlas;
-    BLOCK_END("AtlasManager::simpleSort")
+    BLOCK_END("AtlasManager::skylineSort")
 }
 
 SDL_Surface *AtlasManager::createSDLAtlas(TextureAtlas *const atlas)
 {
     BLOCK_START("AtlasManager::createSDLAtlas")
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-    const unsigned int rmask = 0xff000000;
-    const unsigned int gmask = 0x00ff0000;
-    const unsigned int bmask = 0x0000ff00;
-    const unsigned int amask = 0x000000ff;
-#else
-    const unsigned int rmask = 0x000000ff;
-    const unsigned int gmask = 0x0000ff00;
-    const unsigned int bmask = 0x00ff0000;
-    const unsigned int amask = 0xff000000;
-#endif
-
     // do not create atlas based on only one image
     if (atlas->items.size() == 1)
     {
@@ -250,7 +464,7 @@ SDL_Surface *AtlasManager::createSDLAtlas(TextureAtlas *const atlas)
     BLOCK_START("AtlasManager::createSDLAtlas create surface")
     // temp SDL surface for atlas
     SDL_Surface *const surface = MSDL_CreateRGBSurface(SDL_SWSURFACE,
-        width, height, 32U, rmask, gmask, bmask, amask);
+        width, height, 32U, atlasRmask, atlasGmask, atlasBmask, atlasAmask);
     if (!surface)
     {
         BLOCK_END("AtlasManager::createSDLAtlas")
@@ -258,23 +472,50 @@ SDL_Surface *AtlasManager::createSDLAtlas(TextureAtlas *const atlas)
     }
     BLOCK_END("AtlasManager::createSDLAtlas create surface")
 
-    Image *image = imageHelper->load(surface);
-
-    // drawing SDL images to surface
+    // copy SDL images to atlas surface.
+    // texture uploaded once for whole atlas.
     FOR_EACH (std::vector<AtlasItem*>::iterator, it, atlas->items)
     {
-        AtlasItem *const item = *it;
-        if (image)
-        {
-            imageHelper->copySurfaceToImage(image, item->x, item->y,
-                item->image->mSDLSurface);
-        }
+        const AtlasItem *const item = *it;
+        copyToSurface(surface, item->x, item->y, item->image->mSDLSurface);
     }
-    atlas->atlasImage = image;
+    atlas->atlasImage = imageHelper->load(surface);
     BLOCK_END("AtlasManager::createSDLAtlas")
     return surface;
 }
 
+void AtlasManager::copyToSurface(SDL_Surface *const dst,
+                                 const int x, const int y,
+                                 SDL_Surface *src)
+{
+    if (!src)
+        return;
+    SDL_Surface *const oldSurface = src;
+    const SDL_PixelFormat *const format = src->format;
+    if (format->BitsPerPixel != 32
+        || format->Rmask != atlasRmask
+        || format->Gmask != atlasGmask
+        || format->Bmask != atlasBmask
+        || format->Amask != atlasAmask)
+    {
+        src = ImageHelper::convertTo32Bit(src);
+        if (!src)
+            return;
+    }
+
+    const size_t rowSize = static_cast<size_t>(src->w) * 4;
+    for (int f = 0; f < src->h; f ++)
+    {
+        memcpy(static_cast<uint8_t*>(dst->pixels) + (y + f) * dst->pitch
+            + x * 4,
+            static_cast<const uint8_t*>(src->pixels) + f * src->pitch,
+            rowSize);
+    }
+
+    if (src != oldSurface)
+        MSDL_FreeSurface(src);
+}
+
 void AtlasManager::convertAtlas(TextureAtlas *const atlas)
 {
     // no check for null pointer in atlas because it was in caller
@@ -376,4 +617,273 @@ void AtlasManager::moveToDeleted(AtlasResource *const resource)
     }
 }
 
+std::string AtlasManager::getCacheKey(const std::string &name,
+                                      const StringVect &files,
+                                      const int size)
+{
+    std::string key = strprintf("%d %d %s\n",
+        atlasCacheVersion, size, name.c_str());
+    FOR_EACH (StringVectCIter, it, files)
+    {
+        const std::string &str = *it;
+        const std::string path = str.substr(0, str.find('|'));
+        key.append(str).append(" ").append(toString(static_cast<int64_t>(
+            PhysFs::getLastModTime(path.c_str())))).append("\n");
+    }
+    return key;
+}
+
+static std::string getCacheFileName(const std::string &name)
+{
+    return settings.localDataDir + "/cache/atlas/" + name + ".bin";
+}
+
+static void writeInt(std::ofstream &file, const int val)
+{
+    const uint32_t val2 = static_cast<uint32_t>(val);
+    const char buf[4] =
+    {
+        static_cast<char>(val2 & 0xff),
+        static_cast<char>((val2 >> 8) & 0xff),
+        static_cast<char>((val2 >> 16) & 0xff),
+        static_cast<char>((val2 >> 24) & 0xff)
+    };
+    file.write(buf, 4);
+}
+
+static void writeString(std::ofstream &file, const std::string &str)
+{
+    writeInt(file, static_cast<int>(str.size()));
+    file.write(str.c_str(), str.size());
+}
+
+static int readInt(const std::vector<char> &data, size_t &pos)
+{
+    if (pos + 4 > data.size())
+    {
+        pos = data.size() + 1;
+        return 0;
+    }
+    const uint8_t *const ptr = reinterpret_cast<const uint8_t*>(&data[pos]);
+    pos += 4;
+    return static_cast<int>(static_cast<uint32_t>(ptr[0])
+        | (static_cast<uint32_t>(ptr[1]) << 8)
+        | (static_cast<uint32_t>(ptr[2]) << 16)
+        | (static_cast<uint32_t>(ptr[3]) << 24));
+}
+
+static std::string readString(const std::vector<char> &data, size_t &pos)
+{
+    const int len = readInt(data, pos);
+    if (len < 0 || pos + static_cast<size_t>(len) > data.size())
+    {
+        pos = data.size() + 1;
+        return std::string();
+    }
+    const std::string str(&data[pos], static_cast<size_t>(len));
+    pos += static_cast<size_t>(len);
+    return str;
+}
+
+void AtlasManager::saveCache(const std::string &name,
+                             const std::string &key,
+                             const std::vector<TextureAtlas*> &atlases,
+                             const std::vector<SDL_Surface*> &surfaces)
+{
+    if (atlases.empty() || atlases.size() != surfaces.size())
+        return;
+
+    BLOCK_START("AtlasManager::saveCache")
+    mkdir_r((settings.localDataDir + "/cache/atlas").c_str());
+    const std::string fileName = getCacheFileName(name);
+    std::ofstream file;
+    file.open(fileName.c_str(), std::ios::out | std::ios::binary);
+    if (!file.is_open())
+    {
+        logger->log("Error saving atlas cache: %s", fileName.c_str());
+        BLOCK_END("AtlasManager::saveCache")
+        return;
+    }
+
+    file.write(atlasCacheMagic, 4);
+    writeInt(file, atlasCacheVersion);
+    writeString(file, key);
+    writeInt(file, static_cast<int>(atlases.size()));
+
+    std::vector<uint8_t> pixels;
+    std::vector<uint8_t> packed;
+    const size_t sz = atlases.size();
+    for (size_t f = 0; f < sz; f ++)
+    {
+        const TextureAtlas *const atlas = atlases[f];
+        SDL_Surface *const surface = surfaces[f];
+        writeString(file, atlas->name);
+        writeInt(file, atlas->width);
+        writeInt(file, atlas->height);
+        writeInt(file, static_cast<int>(atlas->items.size()));
+        FOR_EACH (std::vector<AtlasItem*>::const_iterator, it, atlas->items)
+        {
+            const AtlasItem *const item = *it;
+            writeString(file, item->name);
+            writeInt(file, item->x);
+            writeInt(file, item->y);
+            writeInt(file, item->width);
+            writeInt(file, item->height);
+        }
+
+        const size_t rowSize = static_cast<size_t>(surface->w) * 4;
+        pixels.resize(rowSize * surface->h);
+        for (int y = 0; y < surface->h; y ++)
+        {
+            memcpy(&pixels[rowSize * y],
+                static_cast<const uint8_t*>(surface->pixels)
+                + y * surface->pitch,
+                rowSize);
+        }
+        uLongf packedSize = compressBound(static_cast<uLong>(pixels.size()));
+        packed.resize(packedSize);
+        if (compress2(&packed[0], &packedSize, &pixels[0],
+            static_cast<uLong>(pixels.size()), Z_BEST_SPEED) != Z_OK)
+        {
+            packedSize = 0;
+        }
+        writeInt(file, static_cast<int>(packedSize));
+        if (packedSize)
+            file.write(reinterpret_cast<const char*>(&packed[0]), packedSize);
+    }
+    file.close();
+    logger->log("Saved atlas cache: %s", fileName.c_str());
+    BLOCK_END("AtlasManager::saveCache")
+}
+
+AtlasResource *AtlasManager::loadCache(const std::string &name,
+                                       const std::string &key,
+                                       const StringVect &files)
+{
+    BLOCK_START("AtlasManager::loadCache")
+    std::ifstream file;
+    file.open(getCacheFileName(name).c_str(),
+        std::ios::in | std::ios::binary);
+    if (!file.is_open())
+    {
+        BLOCK_END("AtlasManager::loadCache")
+        return nullptr;
+    }
+    file.seekg(0, std::ios::end);
+    const int fileSize = static_cast<int>(file.tellg());
+    file.seekg(0, std::ios::beg);
+    if (fileSize < 12)
+    {
+        BLOCK_END("AtlasManager::loadCache")
+        return nullptr;
+    }
+    std::vector<char> data(fileSize);
+    file.read(&data[0], fileSize);
+    file.close();
+
+    size_t pos = 4;
+    if (memcmp(&data[0], atlasCacheMagic, 4)
+        || readInt(data, pos) != atlasCacheVersion
+        || readString(data, pos) != key)
+    {
+        // images or settings was changed
+        BLOCK_END("AtlasManager::loadCache")
+        return nullptr;
+    }
+
+    moveOldImages(files);
+
+    AtlasResource *const resource = new AtlasResource;
+    std::vector<uint8_t> pixels;
+    const int pages = readInt(data, pos);
+    int pagesLoaded = 0;
+    for (int f = 0; f < pages && pos <= data.size(); f ++)
+    {
+        TextureAtlas *const atlas = new TextureAtlas();
+        atlas->name = readString(data, pos);
+        atlas->width = readInt(data, pos);
+        atlas->height = readInt(data, pos);
+        const int itemsCount = readInt(data, pos);
+        for (int i = 0; i < itemsCount && pos <= data.size(); i ++)
+        {
+            AtlasItem *const item = new AtlasItem();
+            item->name = readString(data, pos);
+            item->x = readInt(data, pos);
+            item->y = readInt(data, pos);
+            item->width = readInt(data, pos);
+            item->height = readInt(data, pos);
+            atlas->items.push_back(item);
+        }
+        // atlas owned by resource from now, for cleanup on errors
+        resource->atlases.push_back(atlas);
+        const int packedSize = readInt(data, pos);
+        const int width = atlas->width;
+        const int height = atlas->height;
+        if (pos > data.size() || packedSize <= 0
+            || pos + static_cast<size_t>(packedSize) > data.size()
+            || width <= 0 || height <= 0 || width > 16384 || height > 16384)
+        {
+            break;
+        }
+        bool validItems = true;
+        FOR_EACH (std::vector<AtlasItem*>::const_iterator, it, atlas->items)
+        {
+            const AtlasItem *const item = *it;
+            if (item->x < 0 || item->y < 0
+                || item->width <= 0 || item->height <= 0
+                || item->x + item->width > width
+                || item->y + item->height > height)
+            {
+                validItems = false;
+                break;
+            }
+        }
+        if (!validItems)
+            break;
+
+        const size_t rowSize = static_cast<size_t>(width) * 4;
+        pixels.resize(rowSize * height);
+        uLongf pixelsSize = static_cast<uLongf>(pixels.size());
+        if (uncompress(&pixels[0], &pixelsSize,
+            reinterpret_cast<const Bytef*>(&data[pos]),
+            static_cast<uLong>(packedSize)) != Z_OK
+            || pixelsSize != pixels.size())
+        {
+            break;
+        }
+        pos += static_cast<size_t>(packedSize);
+
+        SDL_Surface *const surface = MSDL_CreateRGBSurface(SDL_SWSURFACE,
+            width, height, 32U,
+            atlasRmask, atlasGmask, atlasBmask, atlasAmask);
+        if (!surface)
+            break;
+        for (int y = 0; y < height; y ++)
+        {
+            memcpy(static_cast<uint8_t*>(surface->pixels)
+                + y * surface->pitch,
+                &pixels[rowSize * y],
+                rowSize);
+        }
+        atlas->atlasImage = imageHelper->load(surface);
+        MSDL_FreeSurface(surface);
+        if (!atlas->atlasImage)
+            break;
+        convertAtlas(atlas);
+        if (!atlas->atlasImage)
+            break;
+        pagesLoaded ++;
+    }
+    if (pagesLoaded != pages)
+    {
+        logger->log("Broken atlas cache: %s", name.c_str());
+        delete resource;
+        BLOCK_END("AtlasManager::loadCache")
+        return nullptr;
+    }
+    logger->log("Loaded atlas cache: %s", name.c_str());
+    BLOCK_END("AtlasManager::loadCache")
+    return resource;
+}
+
 #endif
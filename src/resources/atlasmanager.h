@@ -51,19 +51,38 @@ class AtlasManager final
         static void moveToDeleted(AtlasResource *const resource);
 
     private:
+        static void moveOldImages(const StringVect &files);
+
         static void loadImages(const StringVect &files,
                                std::vector<Image*> &images);
 
-        static void simpleSort(const std::string &restrict name,
-                               std::vector<TextureAtlas*> &restrict atlases,
-                               const std::vector<Image*> &restrict images,
-                               int size);
+        static void skylineSort(const std::string &restrict name,
+                                std::vector<TextureAtlas*> &restrict atlases,
+                                const std::vector<Image*> &restrict images,
+                                const int size);
 
         static SDL_Surface *createSDLAtlas(TextureAtlas *const atlas)
                                            A_WARN_UNUSED;
 
+        static void copyToSurface(SDL_Surface *const dst,
+                                  const int x, const int y,
+                                  SDL_Surface *src);
 
         static void convertAtlas(TextureAtlas *const atlas);
+
+        static std::string getCacheKey(const std::string &name,
+                                       const StringVect &files,
+                                       const int size) A_WARN_UNUSED;
+
+        static AtlasResource *loadCache(const std::string &name,
+                                        const std::string &key,
+                                        const StringVect &files)
+                                        A_WARN_UNUSED;
+
+        static void saveCache(const std::string &name,
+                              const std::string &key,
+                              const std::vector<TextureAtlas*> &atlases,
+                              const std::vector<SDL_Surface*> &surfaces);
 };
 
 #endif  // USE_OPENGL
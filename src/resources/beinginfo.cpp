@@ -30,6 +30,7 @@
 #include "resources/spritereference.h"
 
 #include "resources/db/colordb.h"
+#include "resources/db/dbcache.h"
 
 #include "resources/map/blockmask.h"
 
@@ -57,6 +58,7 @@ BeingInfo::BeingInfo() :
               | BlockMask::WATER),
     mBlockType(BlockType::CHARACTER),
     mColors(nullptr),
+    mColorList(),
     mTargetOffsetX(0),
     mTargetOffsetY(0),
     mNameOffsetX(0),
@@ -197,6 +199,7 @@ void BeingInfo::init()
 
 void BeingInfo::setColorsList(const std::string &name)
 {
+    mColorList = name;
     if (name.empty())
         mColors = nullptr;
     else
@@ -214,3 +217,175 @@ std::string BeingInfo::getColor(const int idx) const
         return std::string();
     return it->second.color;
 }
+
+void BeingInfo::writeCache(DbCacheWriter &writer) const
+{
+    writer.writeString(mDisplay.image);
+    writer.writeString(mDisplay.floor);
+    writer.writeInt(static_cast<int>(mDisplay.sprites.size()));
+    FOR_EACH (SpriteRefs, it, mDisplay.sprites)
+    {
+        writer.writeString((*it)->sprite);
+        writer.writeInt((*it)->variant);
+    }
+    writer.writeStrings(mDisplay.particles);
+
+    writer.writeString(mName);
+    writer.writeInt(static_cast<int>(mTargetCursorSize));
+    writer.writeInt(static_cast<int>(mHoverCursor));
+
+    writer.writeInt(static_cast<int>(mSounds.size()));
+    FOR_EACH (ItemSoundEvents::const_iterator, it, mSounds)
+    {
+        writer.writeInt(static_cast<int>((*it).first));
+        const SoundInfoVect *const sounds = (*it).second;
+        if (!sounds)
+        {
+            writer.writeInt(0);
+            continue;
+        }
+        writer.writeInt(static_cast<int>(sounds->size()));
+        FOR_EACHP (SoundInfoVect::const_iterator, it2, sounds)
+        {
+            writer.writeString((*it2).sound);
+            writer.writeInt((*it2).delay);
+        }
+    }
+
+    writer.writeInt(static_cast<int>(mAttacks.size()));
+    FOR_EACH (Attacks::const_iterator, it, mAttacks)
+    {
+        const Attack *const attack = (*it).second;
+        writer.writeInt((*it).first);
+        writer.writeString(attack->mAction);
+        writer.writeString(attack->mSkyAction);
+        writer.writeString(attack->mWaterAction);
+        writer.writeInt(attack->mEffectId);
+        writer.writeInt(attack->mHitEffectId);
+        writer.writeInt(attack->mCriticalHitEffectId);
+        writer.writeInt(attack->mMissEffectId);
+        writer.writeString(attack->mMissileParticle);
+    }
+
+    writer.writeInt(mWalkMask);
+    writer.writeInt(static_cast<int>(mBlockType));
+    writer.writeString(mColorList);
+    writer.writeInt(mTargetOffsetX);
+    writer.writeInt(mTargetOffsetY);
+    writer.writeInt(mNameOffsetX);
+    writer.writeInt(mNameOffsetY);
+    writer.writeInt(mHpBarOffsetX);
+    writer.writeInt(mHpBarOffsetY);
+    writer.writeInt(mMaxHP);
+    writer.writeInt(mSortOffsetY);
+    writer.writeInt(mDeadSortOffsetY);
+    writer.writeInt(mAvatarId);
+    writer.writeInt(mWidth);
+    writer.writeInt(mHeight);
+    writer.writeInt(mStartFollowDist);
+    writer.writeInt(mFollowDist);
+    writer.writeInt(mWarpDist);
+    writer.writeInt(mWalkSpeed);
+    writer.writeInt(mSitOffsetX);
+    writer.writeInt(mSitOffsetY);
+    writer.writeInt(mMoveOffsetX);
+    writer.writeInt(mMoveOffsetY);
+    writer.writeInt(mDeadOffsetX);
+    writer.writeInt(mDeadOffsetY);
+    writer.writeInt(mAttackOffsetX);
+    writer.writeInt(mAttackOffsetY);
+    writer.writeInt(mThinkTime);
+    writer.writeInt(mDirectionType);
+    writer.writeInt(mSitDirectionType);
+    writer.writeInt(mDeadDirectionType);
+    writer.writeInt(mAttackDirectionType);
+    writer.writeInt(mStaticMaxHP);
+    writer.writeInt(mTargetSelection);
+}
+
+void BeingInfo::readCache(DbCacheReader &reader)
+{
+    SpriteDisplay display;
+    display.image = reader.readString();
+    display.floor = reader.readString();
+    int cnt = reader.readCount(8);
+    for (int f = 0; f < cnt; f ++)
+    {
+        SpriteReference *const sprite = new SpriteReference;
+        sprite->sprite = reader.readString();
+        sprite->variant = reader.readInt();
+        display.sprites.push_back(sprite);
+    }
+    reader.readStrings(display.particles);
+    setDisplay(display);
+
+    mName = reader.readString();
+    mTargetCursorSize = static_cast<TargetCursorSize::Size>(
+        reader.readInt());
+    mHoverCursor = static_cast<Cursor::Cursor>(reader.readInt());
+
+    cnt = reader.readCount(8);
+    for (int f = 0; f < cnt; f ++)
+    {
+        const ItemSoundEvent::Type event = static_cast<ItemSoundEvent::Type>(
+            reader.readInt());
+        const int sounds = reader.readCount(8);
+        for (int sound = 0; sound < sounds; sound ++)
+        {
+            const std::string name = reader.readString();
+            if (mSounds.find(event) == mSounds.end())
+                mSounds[event] = new SoundInfoVect;
+            mSounds[event]->push_back(SoundInfo(name, reader.readInt()));
+        }
+    }
+
+    cnt = reader.readCount(36);
+    for (int f = 0; f < cnt; f ++)
+    {
+        const int id = reader.readInt();
+        const std::string action = reader.readString();
+        const std::string skyAction = reader.readString();
+        const std::string waterAction = reader.readString();
+        const int effectId = reader.readInt();
+        const int hitEffectId = reader.readInt();
+        const int criticalHitEffectId = reader.readInt();
+        const int missEffectId = reader.readInt();
+        addAttack(id, action, skyAction, waterAction, effectId, hitEffectId,
+            criticalHitEffectId, missEffectId, reader.readString());
+    }
+
+    mWalkMask = static_cast<unsigned char>(reader.readInt());
+    mBlockType = static_cast<BlockType::BlockType>(reader.readInt());
+    setColorsList(reader.readString());
+    mTargetOffsetX = reader.readInt();
+    mTargetOffsetY = reader.readInt();
+    mNameOffsetX = reader.readInt();
+    mNameOffsetY = reader.readInt();
+    mHpBarOffsetX = reader.readInt();
+    mHpBarOffsetY = reader.readInt();
+    mMaxHP = reader.readInt();
+    mSortOffsetY = reader.readInt();
+    mDeadSortOffsetY = reader.readInt();
+    mAvatarId = static_cast<uint16_t>(reader.readInt());
+    mWidth = reader.readInt();
+    mHeight = reader.readInt();
+    mStartFollowDist = reader.readInt();
+    mFollowDist = reader.readInt();
+    mWarpDist = reader.readInt();
+    mWalkSpeed = reader.readInt();
+    mSitOffsetX = reader.readInt();
+    mSitOffsetY = reader.readInt();
+    mMoveOffsetX = reader.readInt();
+    mMoveOffsetY = reader.readInt();
+    mDeadOffsetX = reader.readInt();
+    mDeadOffsetY = reader.readInt();
+    mAttackOffsetX = reader.readInt();
+    mAttackOffsetY = reader.readInt();
+    mThinkTime = reader.readInt();
+    mDirectionType = reader.readInt();
+    mSitDirectionType = reader.readInt();
+    mDeadDirectionType = reader.readInt();
+    mAttackDirectionType = reader.readInt();
+    mStaticMaxHP = reader.readInt() != 0;
+    mTargetSelection = reader.readInt() != 0;
+}
@@ -36,6 +36,9 @@
 
 struct Attack;
 
+class DbCacheReader;
+class DbCacheWriter;
+
 namespace ColorDB
 {
     class ItemColor;
@@ -315,6 +318,10 @@ class BeingInfo final
 
         std::string getColor(const int idx) const A_WARN_UNUSED;
 
+        void writeCache(DbCacheWriter &writer) const;
+
+        void readCache(DbCacheReader &reader);
+
         static void init();
 
         static void clear();
@@ -329,6 +336,7 @@ class BeingInfo final
         unsigned char mWalkMask;
         BlockType::BlockType mBlockType;
         const std::map <int, ColorDB::ItemColor> *mColors;
+        std::string mColorList;
         int mTargetOffsetX;
         int mTargetOffsetY;
         int mNameOffsetX;
@@ -0,0 +1,259 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/db/dbcache.h"
+
+#include "logger.h"
+#include "settings.h"
+
+#include "utils/datapack.h"
+#include "utils/files.h"
+#include "utils/langs.h"
+#include "utils/mkdir.h"
+#include "utils/physfstools.h"
+#include "utils/stringutils.h"
+
+#include "utils/translation/translationmanager.h"
+
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+#include <zlib.h>
+
+#include "debug.h"
+
+static const int dbCacheMagic = 0x4244504d;  // "MPDB"
+static const int dbCacheVersion = 2;
+
+void DbCacheWriter::writeInt(const int val)
+{
+    const uint32_t val2 = static_cast<uint32_t>(val);
+    const char buf[4] =
+    {
+        static_cast<char>(val2 & 0xff),
+        static_cast<char>((val2 >> 8) & 0xff),
+        static_cast<char>((val2 >> 16) & 0xff),
+        static_cast<char>((val2 >> 24) & 0xff)
+    };
+    mData.append(buf, 4);
+}
+
+void DbCacheWriter::writeString(const std::string &str)
+{
+    writeInt(static_cast<int>(str.size()));
+    mData.append(str);
+}
+
+void DbCacheWriter::writeStrings(const StringVect &vect)
+{
+    writeInt(static_cast<int>(vect.size()));
+    FOR_EACH (StringVectCIter, it, vect)
+        writeString(*it);
+}
+
+int DbCacheReader::readInt()
+{
+    if (!mValid || mData.size() - mPos < 4)
+    {
+        mValid = false;
+        return 0;
+    }
+    const uint8_t *const ptr = reinterpret_cast<const uint8_t*>(
+        mData.c_str() + mPos);
+    mPos += 4;
+    return static_cast<int>(static_cast<uint32_t>(ptr[0])
+        | (static_cast<uint32_t>(ptr[1]) << 8)
+        | (static_cast<uint32_t>(ptr[2]) << 16)
+        | (static_cast<uint32_t>(ptr[3]) << 24));
+}
+
+int DbCacheReader::readCount(const int minSize)
+{
+    const int cnt = readInt();
+    if (cnt < 0 || static_cast<size_t>(cnt) * minSize > mData.size() - mPos)
+    {
+        mValid = false;
+        return 0;
+    }
+    return cnt;
+}
+
+std::string DbCacheReader::readString()
+{
+    const int sz = readCount(1);
+    if (!mValid)
+        return std::string();
+    const size_t pos = mPos;
+    mPos += sz;
+    return mData.substr(pos, sz);
+}
+
+void DbCacheReader::readStrings(StringVect &vect)
+{
+    const int sz = readCount(4);
+    for (int f = 0; f < sz; f ++)
+        vect.push_back(readString());
+}
+
+static std::string getCacheDir()
+{
+    return settings.localDataDir + "/cache/db";
+}
+
+static std::string getCacheFileName(const std::string &name)
+{
+    return strprintf("%s/%s_%08x.bin", getCacheDir().c_str(), name.c_str(),
+        static_cast<unsigned int>(hashString(settings.serverName)));
+}
+
+static void getFileHash(const std::string &fileName,
+                        int &crc,
+                        int &size)
+{
+    uLong sum = crc32(0L, Z_NULL, 0);
+    int packSize = 0;
+    const char *const packData = DataPack::find(fileName.c_str(), packSize);
+    if (packData)
+    {
+        crc = static_cast<int>(crc32(sum,
+            reinterpret_cast<const Bytef*>(packData),
+            static_cast<uInt>(packSize)));
+        size = packSize;
+        return;
+    }
+
+    PHYSFS_file *const file = PhysFs::openRead(fileName.c_str());
+    if (!file)
+    {
+        crc = 0;
+        size = -1;
+        return;
+    }
+    size = 0;
+    char buf[8192];
+    PHYSFS_sint64 len;
+    while ((len = PHYSFS_read(file, buf, 1, sizeof(buf))) > 0)
+    {
+        sum = crc32(sum, reinterpret_cast<const Bytef*>(buf),
+            static_cast<uInt>(len));
+        size += static_cast<int>(len);
+    }
+    PHYSFS_close(file);
+    crc = static_cast<int>(sum);
+}
+
+namespace DbCache
+{
+    bool load(const std::string &name,
+              const std::string &key,
+              std::string &data)
+    {
+        std::ifstream file;
+        file.open(getCacheFileName(name).c_str(),
+            std::ios::in | std::ios::binary);
+        if (!file.is_open())
+            return false;
+        file.seekg(0, std::ios::end);
+        const int fileSize = static_cast<int>(file.tellg());
+        file.seekg(0, std::ios::beg);
+        if (fileSize <= 0)
+            return false;
+        std::string buf(fileSize, '\0');
+        file.read(&buf[0], fileSize);
+        file.close();
+
+        DbCacheReader reader(buf);
+        if (reader.readInt() != dbCacheMagic
+            || reader.readInt() != dbCacheVersion
+            || reader.readString() != key)
+        {
+            return false;
+        }
+
+        const int cnt = reader.readCount(12);
+        for (int f = 0; f < cnt; f ++)
+        {
+            const std::string fileName = reader.readString();
+            const int crc = reader.readInt();
+            const int size = reader.readInt();
+            int crc2 = 0;
+            int size2 = 0;
+            if (!reader.isValid())
+                return false;
+            getFileHash(fileName, crc2, size2);
+            if (crc != crc2 || size != size2)
+            {
+                logger->log("DbCache: %s changed, reloading %s",
+                    fileName.c_str(), name.c_str());
+                return false;
+            }
+        }
+        data = reader.readString();
+        return reader.isValid() && reader.isEnd();
+    }
+
+    void save(const std::string &name,
+              const std::string &key,
+              const StringVect &files,
+              const std::string &data)
+    {
+        std::set<std::string> fileSet(files.begin(), files.end());
+        // names and descriptions translated by po files
+        StringVect langFiles;
+        TranslationManager::getLangFiles(getLang(), langFiles);
+        fileSet.insert(langFiles.begin(), langFiles.end());
+        DbCacheWriter writer;
+        writer.writeInt(dbCacheMagic);
+        writer.writeInt(dbCacheVersion);
+        writer.writeString(key);
+        writer.writeInt(static_cast<int>(fileSet.size()));
+        FOR_EACH (std::set<std::string>::const_iterator, it, fileSet)
+        {
+            int crc = 0;
+            int size = 0;
+            getFileHash(*it, crc, size);
+            writer.writeString(*it);
+            writer.writeInt(crc);
+            writer.writeInt(size);
+        }
+        writer.writeString(data);
+
+        const std::string fileName = getCacheFileName(name);
+        const std::string tmpName = fileName + ".tmp";
+        std::ofstream file;
+        file.open(tmpName.c_str(), std::ios::out | std::ios::binary);
+        if (!file.is_open())
+        {
+            mkdir_r(getCacheDir().c_str());
+            file.open(tmpName.c_str(), std::ios::out | std::ios::binary);
+            if (!file.is_open())
+            {
+                logger->log("Error saving db cache: %s", fileName.c_str());
+                return;
+            }
+        }
+        const std::string &buf = writer.getData();
+        file.write(buf.c_str(), buf.size());
+        file.close();
+        if (file.fail() || Files::renameFile(tmpName, fileName))
+            ::remove(tmpName.c_str());
+    }
+}  // namespace DbCache
@@ -0,0 +1,111 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_DB_DBCACHE_H
+#define RESOURCES_DB_DBCACHE_H
+
+#include "utils/stringvector.h"
+
+#include "localconsts.h"
+
+/**
+ * Serializer for database cache.
+ */
+class DbCacheWriter final
+{
+    public:
+        DbCacheWriter() :
+            mData()
+        { }
+
+        A_DELETE_COPY(DbCacheWriter)
+
+        void writeInt(const int val);
+
+        void writeString(const std::string &str);
+
+        void writeStrings(const StringVect &vect);
+
+        const std::string &getData() const A_WARN_UNUSED
+        { return mData; }
+
+    private:
+        std::string mData;
+};
+
+/**
+ * Reader for data written by DbCacheWriter. After any read outside of
+ * data reader become invalid and return only zeros and empty strings.
+ */
+class DbCacheReader final
+{
+    public:
+        explicit DbCacheReader(const std::string &data) :
+            mData(data),
+            mPos(0),
+            mValid(true)
+        { }
+
+        A_DELETE_COPY(DbCacheReader)
+
+        int readInt() A_WARN_UNUSED;
+
+        /**
+         * Reads number of elements what follow. Each element use
+         * at least minSize bytes.
+         */
+        int readCount(const int minSize) A_WARN_UNUSED;
+
+        std::string readString() A_WARN_UNUSED;
+
+        void readStrings(StringVect &vect);
+
+        bool isValid() const A_WARN_UNUSED
+        { return mValid; }
+
+        bool isEnd() const A_WARN_UNUSED
+        { return mPos == mData.size(); }
+
+    private:
+        const std::string &mData;
+        size_t mPos;
+        bool mValid;
+};
+
+/**
+ * Disk cache for parsed xml databases. Cache valid while key, all
+ * source files and translation files stay same.
+ */
+namespace DbCache
+{
+    /**
+     * Loads cached data. Returns false if cache missing or outdated.
+     */
+    bool load(const std::string &name,
+              const std::string &key,
+              std::string &data) A_WARN_UNUSED;
+
+    void save(const std::string &name,
+              const std::string &key,
+              const StringVect &files,
+              const std::string &data);
+}  // namespace DbCache
+
+#endif  // RESOURCES_DB_DBCACHE_H
@@ -0,0 +1,226 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/db/dbcache.h"
+
+#include "resources/attack.h"
+#include "resources/beinginfo.h"
+#include "resources/iteminfo.h"
+#include "resources/spritereference.h"
+
+#include "gtest/gtest.h"
+
+#include "debug.h"
+
+TEST(DbCache, readWrite1)
+{
+    DbCacheWriter writer;
+    writer.writeInt(-5);
+    writer.writeString("test");
+    StringVect vect;
+    vect.push_back("a");
+    vect.push_back("");
+    writer.writeStrings(vect);
+
+    DbCacheReader reader(writer.getData());
+    EXPECT_EQ(-5, reader.readInt());
+    EXPECT_EQ("test", reader.readString());
+    StringVect vect2;
+    reader.readStrings(vect2);
+    EXPECT_EQ(vect, vect2);
+    EXPECT_TRUE(reader.isValid());
+    EXPECT_TRUE(reader.isEnd());
+
+    // read outside of data
+    EXPECT_EQ(0, reader.readInt());
+    EXPECT_FALSE(reader.isValid());
+}
+
+static void deleteSprites(const SpriteDisplay &display)
+{
+    FOR_EACH (SpriteRefs, it, display.sprites)
+        delete *it;
+}
+
+TEST(DbCache, itemInfo1)
+{
+    ItemInfo *const info = new ItemInfo;
+    SpriteDisplay display;
+    display.image = "icon.png";
+    display.floor = "floor.png";
+    display.sprites.push_back(new SpriteReference("item.xml", 2));
+    display.particles.push_back("particle.xml");
+    info->setDisplay(display);
+    info->setId(1234);
+    info->setName("Item name");
+    info->setDescription("Item description");
+    info->setEffect("Effect");
+    info->setUseButton("Use");
+    info->setUseButton2("Use 2");
+    info->setType(ItemType::EQUIPMENT_TORSO);
+    info->setWeight(30);
+    info->setSprite("female.xml", Gender::FEMALE, 2);
+    info->setSprite("male.xml", Gender::MALE, 0);
+    info->setAttackAction("attack");
+    info->setSkyAttackAction("attacksky");
+    info->setWaterAttackAction("attackwater");
+    info->setAttackRange(3);
+    info->setMissileParticleFile("missile.xml");
+    info->setHitEffectId(10);
+    info->setCriticalHitEffectId(11);
+    info->setMissEffectId(12);
+    info->addSound(ItemSoundEvent::HIT, "hit.ogg", 100);
+    info->addSound(ItemSoundEvent::HIT, "hit2.ogg", 0);
+    info->addSound(ItemSoundEvent::EQUIP, "equip.ogg", 5);
+    (*info->addReplaceSprite(3, 1))[100] = 200;
+    info->addReplaceSprite(4, 2);
+    info->addTag(7);
+    info->setRemoveSprites();
+    info->setMaxFloorOffset(5);
+    info->setPickupCursor(Cursor::CURSOR_PICKUP);
+    info->setPet(6);
+    info->setProtected(true);
+    info->setDrawBefore(1, 3);
+    info->setDrawAfter(2, 4);
+    info->setDrawPriority(3, 5);
+
+    DbCacheWriter writer;
+    info->writeCache(writer);
+
+    DbCacheReader reader(writer.getData());
+    ItemInfo *const info2 = new ItemInfo;
+    info2->readCache(reader);
+    EXPECT_TRUE(reader.isValid());
+    EXPECT_TRUE(reader.isEnd());
+
+    EXPECT_EQ(1234, info2->getId());
+    EXPECT_EQ("Item name", info2->getName());
+    EXPECT_EQ(ItemType::EQUIPMENT_TORSO, info2->getType());
+    EXPECT_EQ("female.xml", info2->getSprite(Gender::FEMALE, 2));
+    EXPECT_EQ("icon.png", info2->getDisplay().image);
+    ASSERT_EQ(1U, info2->getDisplay().sprites.size());
+    EXPECT_EQ("item.xml", info2->getDisplay().sprites[0]->sprite);
+    EXPECT_EQ(2, info2->getDisplay().sprites[0]->variant);
+
+    // all fields restored if second write give same data
+    DbCacheWriter writer2;
+    info2->writeCache(writer2);
+    EXPECT_EQ(writer.getData(), writer2.getData());
+
+    // truncated data must not be accepted
+    const std::string data = writer.getData().substr(0,
+        writer.getData().size() - 3);
+    DbCacheReader reader2(data);
+    ItemInfo *const info3 = new ItemInfo;
+    info3->readCache(reader2);
+    EXPECT_FALSE(reader2.isValid());
+
+    // item info not own display sprites
+    deleteSprites(info->getDisplay());
+    deleteSprites(info2->getDisplay());
+    deleteSprites(info3->getDisplay());
+    delete info;
+    delete info2;
+    delete info3;
+}
+
+TEST(DbCache, beingInfo1)
+{
+    BeingInfo *const info = new BeingInfo;
+    SpriteDisplay display;
+    display.image = "being.png";
+    display.sprites.push_back(new SpriteReference("being.xml", 1));
+    display.sprites.push_back(new SpriteReference("being2.xml", 0));
+    display.particles.push_back("particle.xml");
+    info->setDisplay(display);
+    info->setName("Being name");
+    info->setTargetCursorSize(TargetCursorSize::LARGE);
+    info->setHoverCursor(Cursor::CURSOR_FIGHT);
+    info->addSound(ItemSoundEvent::HURT, "hurt.ogg", 0);
+    info->addSound(ItemSoundEvent::DIE, "die.ogg", 20);
+    info->addAttack(1, "attack", "attacksky", "attackwater", 2, 3, 4, 5,
+        "missile.xml");
+    info->addAttack(3, "attack2", "", "", -1, -1, -1, -1, "");
+    info->setWalkMask(3);
+    info->setBlockType(BlockType::MONSTER);
+    info->setTargetOffsetX(1);
+    info->setTargetOffsetY(2);
+    info->setNameOffsetX(3);
+    info->setNameOffsetY(4);
+    info->setHpBarOffsetX(5);
+    info->setHpBarOffsetY(6);
+    info->setMaxHP(700);
+    info->setSortOffsetY(8);
+    info->setDeadSortOffsetY(9);
+    info->setAvatarId(10);
+    info->setWidth(11);
+    info->setHeight(12);
+    info->setStartFollowDist(13);
+    info->setFollowDist(14);
+    info->setWarpDist(15);
+    info->setWalkSpeed(16);
+    info->setSitOffsetX(17);
+    info->setSitOffsetY(18);
+    info->setMoveOffsetX(19);
+    info->setMoveOffsetY(20);
+    info->setDeadOffsetX(21);
+    info->setDeadOffsetY(22);
+    info->setAttackOffsetX(23);
+    info->setAttackOffsetY(24);
+    info->setThinkTime(25);
+    info->setDirectionType(1);
+    info->setSitDirectionType(2);
+    info->setDeadDirectionType(3);
+    info->setAttackDirectionType(4);
+    info->setStaticMaxHP(true);
+    info->setTargetSelection(false);
+
+    DbCacheWriter writer;
+    info->writeCache(writer);
+
+    DbCacheReader reader(writer.getData());
+    BeingInfo *const info2 = new BeingInfo;
+    info2->readCache(reader);
+    EXPECT_TRUE(reader.isValid());
+    EXPECT_TRUE(reader.isEnd());
+
+    EXPECT_EQ("Being name", info2->getName());
+    EXPECT_EQ(TargetCursorSize::LARGE, info2->getTargetCursorSize());
+    EXPECT_EQ(16, info2->getWalkSpeed());
+    ASSERT_NE(nullptr, info2->getAttack(1));
+    EXPECT_EQ("missile.xml", info2->getAttack(1)->mMissileParticle);
+    ASSERT_EQ(2U, info2->getDisplay().sprites.size());
+    EXPECT_EQ("being2.xml", info2->getDisplay().sprites[1]->sprite);
+
+    DbCacheWriter writer2;
+    info2->writeCache(writer2);
+    EXPECT_EQ(writer.getData(), writer2.getData());
+
+    const std::string data = writer.getData().substr(0,
+        writer.getData().size() / 2);
+    DbCacheReader reader2(data);
+    BeingInfo *const info3 = new BeingInfo;
+    info3->readCache(reader2);
+    EXPECT_FALSE(reader2.isValid());
+
+    delete info;
+    delete info2;
+    delete info3;
+}
@@ -33,10 +33,12 @@
 #include "resources/spritedirection.h"
 #include "resources/spritereference.h"
 
+#include "resources/db/dbcache.h"
 #include "resources/db/itemdbstat.h"
 
 #include "utils/delete2.h"
 #include "utils/dtor.h"
+#include "utils/langs.h"
 
 #include "utils/translation/podict.h"
 
@@ -52,6 +54,7 @@ namespace
     StringVect mTagNames;
     std::map<std::string, int> mTags;
     std::map<std::string, ItemSoundEvent::Type> mSoundNames;
+    StringVect mSourceFiles;
 }  // namespace
 
 extern int serverVersion;
@@ -70,6 +73,9 @@ static void loadOrderSprite(ItemInfo *const itemInfo,
                             const bool drawAfter);
 static int parseSpriteName(const std::string &name);
 static int parseDirectionName(const std::string &name);
+static std::string getCacheKey(const StringVect &list);
+static bool loadCache(const std::string &key, int &tagNum);
+static void saveCache(const std::string &key);
 
 namespace
 {
@@ -200,19 +206,35 @@ void ItemDB::load()
     mUnknown->setSprite(errFile, Gender::FEMALE, 0);
     mUnknown->setSprite(errFile, Gender::OTHER, 0);
     mUnknown->addTag(mTags["All"]);
-    loadXmlFile(paths.getStringValue("itemsFile"), tagNum);
-    loadXmlFile(paths.getStringValue("itemsPatchFile"), tagNum);
 
     StringVect list;
     BeingCommon::getIncludeFiles(paths.getStringValue("itemsPatchDir"),
         list,
         ".xml");
+
+    const bool useCache = config.getBoolValue("useDbCache");
+    std::string cacheKey;
+    if (useCache)
+    {
+        cacheKey = getCacheKey(list);
+        if (loadCache(cacheKey, tagNum))
+            return;
+    }
+
+    mSourceFiles.clear();
+    loadXmlFile(paths.getStringValue("itemsFile"), tagNum);
+    loadXmlFile(paths.getStringValue("itemsPatchFile"), tagNum);
     FOR_EACH (StringVectCIter, it, list)
         loadXmlFile(*it, tagNum);
+
+    if (useCache)
+        saveCache(cacheKey);
+    mSourceFiles.clear();
 }
 
 void ItemDB::loadXmlFile(const std::string &fileName, int &tagNum)
 {
+    mSourceFiles.push_back(fileName);
     XML::Document doc(fileName);
     const XmlNodePtrConst rootNode = doc.rootNode();
 
@@ -925,3 +947,107 @@ void loadOrderSprite(ItemInfo *const itemInfo,
         itemInfo->setDrawBefore(direction, sprite);
     itemInfo->setDrawPriority(direction, priority);
 }
+
+std::string getCacheKey(const StringVect &list)
+{
+    std::string key = strprintf("%d %d %d %d %d", serverVersion, mapTileSize,
+        paths.getIntValue("hitEffectId"),
+        paths.getIntValue("criticalHitEffectId"),
+        paths.getIntValue("missEffectId"));
+    const LangVect lang = getLang();
+    FOR_EACH (LangIter, it, lang)
+        key.append("|").append(*it);
+    key.append("|").append(paths.getStringValue("sfx"));
+    key.append("|").append(paths.getStringValue("itemsFile"));
+    key.append("|").append(paths.getStringValue("itemsPatchFile"));
+    FOR_EACH (StringVectCIter, it, list)
+        key.append("|").append(*it);
+    FOR_EACH (std::vector<ItemDB::Stat>::const_iterator, it, extraStats)
+        key.append("|").append(it->tag).append("=").append(it->format);
+    return key;
+}
+
+static void resetTags(int &tagNum)
+{
+    // keep only default tags added in ItemDB::load
+    mTagNames.resize(4);
+    mTags.clear();
+    tagNum = 0;
+    FOR_EACH (StringVectCIter, it, mTagNames)
+        mTags[*it] = tagNum ++;
+}
+
+bool loadCache(const std::string &key, int &tagNum)
+{
+    std::string data;
+    if (!DbCache::load("items", key, data))
+        return false;
+
+    DbCacheReader reader(data);
+    StringVect tagNames;
+    reader.readStrings(tagNames);
+    if (tagNames.size() < 4)
+        return false;
+    resetTags(tagNum);
+    for (size_t f = 4; f < tagNames.size(); f ++)
+    {
+        mTagNames.push_back(tagNames[f]);
+        mTags[tagNames[f]] = tagNum ++;
+    }
+
+    const int cnt = reader.readCount(8);
+    for (int f = 0; f < cnt && reader.isValid(); f ++)
+    {
+        ItemInfo *const itemInfo = new ItemInfo;
+        itemInfo->readCache(reader);
+        const int id = itemInfo->getId();
+        if (mItemInfos.find(id) != mItemInfos.end())
+            delete mItemInfos[id];
+        mItemInfos[id] = itemInfo;
+    }
+
+    const int cnt2 = reader.readCount(8);
+    for (int f = 0; f < cnt2; f ++)
+    {
+        const std::string name = reader.readString();
+        const ItemDB::ItemInfos::const_iterator it
+            = mItemInfos.find(reader.readInt());
+        if (it == mItemInfos.end())
+            break;
+        mNamedItemInfos[name] = (*it).second;
+    }
+
+    if (!reader.isValid() || !reader.isEnd()
+        || static_cast<int>(mNamedItemInfos.size()) != cnt2)
+    {
+        logger->log("ItemDB: broken cache, loading xml files");
+        delete_all(mItemInfos);
+        mItemInfos.clear();
+        mNamedItemInfos.clear();
+        resetTags(tagNum);
+        return false;
+    }
+
+    logger->log("ItemDB: loaded %d items from cache", cnt);
+    mLoaded = true;
+    return true;
+}
+
+void saveCache(const std::string &key)
+{
+    DbCacheWriter writer;
+    writer.writeStrings(mTagNames);
+
+    writer.writeInt(static_cast<int>(mItemInfos.size()));
+    FOR_EACH (ItemDB::ItemInfos::const_iterator, it, mItemInfos)
+        (*it).second->writeCache(writer);
+
+    writer.writeInt(static_cast<int>(mNamedItemInfos.size()));
+    FOR_EACH (ItemDB::NamedItemInfos::const_iterator, it, mNamedItemInfos)
+    {
+        writer.writeString((*it).first);
+        writer.writeInt((*it).second->getId());
+    }
+
+    DbCache::save("items", key, mSourceFiles, writer.getData());
+}
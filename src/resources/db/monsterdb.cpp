@@ -28,10 +28,14 @@
 #include "resources/beinginfo.h"
 #include "resources/spritereference.h"
 
+#include "resources/db/dbcache.h"
+
 #include "resources/map/blockmask.h"
 
 #include "utils/dtor.h"
 #include "utils/gettext.h"
+#include "utils/langs.h"
+#include "utils/stringutils.h"
 
 #include "configuration.h"
 
@@ -43,6 +47,64 @@ namespace
 {
     BeingInfos mMonsterInfos;
     bool mLoaded = false;
+    StringVect mSourceFiles;
+}
+
+static std::string getCacheKey(const StringVect &list)
+{
+    std::string key = strprintf("%d %d %d %d",
+        paths.getIntValue("effectId"),
+        paths.getIntValue("hitEffectId"),
+        paths.getIntValue("criticalHitEffectId"),
+        paths.getIntValue("missEffectId"));
+    const LangVect lang = getLang();
+    FOR_EACH (LangIter, it, lang)
+        key.append("|").append(*it);
+    key.append("|").append(paths.getStringValue("monstersFile"));
+    key.append("|").append(paths.getStringValue("monstersPatchFile"));
+    FOR_EACH (StringVectCIter, it, list)
+        key.append("|").append(*it);
+    return key;
+}
+
+static bool loadCache(const std::string &key)
+{
+    std::string data;
+    if (!DbCache::load("monsters", key, data))
+        return false;
+
+    DbCacheReader reader(data);
+    const int cnt = reader.readCount(8);
+    for (int f = 0; f < cnt && reader.isValid(); f ++)
+    {
+        const int id = reader.readInt();
+        BeingInfo *const info = new BeingInfo;
+        info->readCache(reader);
+        delete mMonsterInfos[id];
+        mMonsterInfos[id] = info;
+    }
+
+    if (!reader.isValid() || !reader.isEnd())
+    {
+        logger->log("MonsterDB: broken cache, loading xml files");
+        delete_all(mMonsterInfos);
+        mMonsterInfos.clear();
+        return false;
+    }
+    logger->log("MonsterDB: loaded %d monsters from cache", cnt);
+    return true;
+}
+
+static void saveCache(const std::string &key)
+{
+    DbCacheWriter writer;
+    writer.writeInt(static_cast<int>(mMonsterInfos.size()));
+    FOR_EACH (BeingInfos::const_iterator, it, mMonsterInfos)
+    {
+        writer.writeInt((*it).first);
+        (*it).second->writeCache(writer);
+    }
+    DbCache::save("monsters", key, mSourceFiles, writer.getData());
 }
 
 void MonsterDB::load()
@@ -51,15 +113,40 @@ void MonsterDB::load()
         unload();
 
     logger->log1("Initializing monster database...");
+
+    StringVect list;
+    BeingCommon::getIncludeFiles(paths.getStringValue("monstersPatchDir"),
+        list,
+        ".xml");
+
+    const bool useCache = config.getBoolValue("useDbCache");
+    std::string cacheKey;
+    if (useCache)
+    {
+        cacheKey = getCacheKey(list);
+        if (loadCache(cacheKey))
+        {
+            mLoaded = true;
+            return;
+        }
+    }
+
+    mSourceFiles.clear();
     loadXmlFile(paths.getStringValue("monstersFile"));
     loadXmlFile(paths.getStringValue("monstersPatchFile"));
-    loadXmlDir("monstersPatchDir", loadXmlFile);
+    FOR_EACH (StringVectCIter, it, list)
+        loadXmlFile(*it);
+
+    if (useCache)
+        saveCache(cacheKey);
+    mSourceFiles.clear();
 
     mLoaded = true;
 }
 
 void MonsterDB::loadXmlFile(const std::string &fileName)
 {
+    mSourceFiles.push_back(fileName);
     XML::Document doc(fileName);
     const XmlNodePtr rootNode = doc.rootNode();
 
@@ -0,0 +1,69 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_DELAYEDLOAD_H
+#define RESOURCES_DELAYEDLOAD_H
+
+#include <stdint.h>
+
+#include "localconsts.h"
+
+class Actor;
+
+/**
+ * Base class for loads what executed later by DelayedManager.
+ */
+class DelayedLoad notfinal
+{
+    public:
+        DelayedLoad() :
+            mOwner(nullptr),
+            mAddTime(0)
+        { }
+
+        A_DELETE_COPY(DelayedLoad)
+
+        virtual ~DelayedLoad()
+        { }
+
+        virtual void load() = 0;
+
+        /**
+         * Sets actor what will use loaded resource. Loads for actors near
+         * to player executed first. Owner must live longer than load.
+         */
+        void setOwner(const Actor *const owner)
+        { mOwner = owner; }
+
+        const Actor *getOwner() const A_WARN_UNUSED
+        { return mOwner; }
+
+        void setAddTime(const uint32_t time)
+        { mAddTime = time; }
+
+        uint32_t getAddTime() const A_WARN_UNUSED
+        { return mAddTime; }
+
+    protected:
+        const Actor *mOwner;
+        uint32_t mAddTime;
+};
+
+#endif  // RESOURCES_DELAYEDLOAD_H
@@ -20,50 +20,85 @@
 
 #include "resources/delayedmanager.h"
 
-#include "animationdelayload.h"
+#include "being/actor.h"
 
-#include "utils/timer.h"
+#include "resources/delayedload.h"
+
+#include <SDL_timer.h>
+
+#include <climits>
+#include <cstdlib>
 
 #include "debug.h"
 
-DelayedAnim DelayedManager::mDelayedAnimations;
+DelayedLoads DelayedManager::mDelayedLoads;
+int DelayedManager::mTimeBudget = 5;
+int DelayedManager::mLatency = 0;
 
-void DelayedManager::delayedLoad()
+void DelayedManager::addDelayedLoad(DelayedLoad *const load)
 {
+    load->setAddTime(SDL_GetTicks());
+    mDelayedLoads.push_back(load);
+}
+
+void DelayedManager::delayedLoad(const Actor *const player)
+{
+    if (mDelayedLoads.empty())
+        return;
+
     BLOCK_START("DelayedManager::delayedLoad")
-    static int loadTime = 0;
-    if (loadTime < cur_time)
+    // SDL ticks is monotonic and not affected by system time changes
+    const uint32_t startTime = SDL_GetTicks();
+    uint32_t time = startTime;
+    do
     {
-        loadTime = tick_time;
+        // remove from list before load, because load can add new items
+        const DelayedLoadsIter it = findNearest(player);
+        DelayedLoad *const load = *it;
+        mDelayedLoads.erase(it);
+        load->load();
+        time = SDL_GetTicks();
+        mLatency = static_cast<int>(time - load->getAddTime());
+        delete load;
+    }
+    while (!mDelayedLoads.empty()
+           && static_cast<int>(time - startTime) < mTimeBudget);
+    BLOCK_END("DelayedManager::delayedLoad")
+}
+
+DelayedLoadsIter DelayedManager::findNearest(const Actor *const player)
+{
+    DelayedLoadsIter best = mDelayedLoads.begin();
+    if (!player)
+        return best;
 
-        int k = 0;
-        DelayedAnimIter it = mDelayedAnimations.begin();
-        const DelayedAnimIter it_end = mDelayedAnimations.end();
-        while (it != it_end && k < 1)
+    const int x = player->getPixelX();
+    const int y = player->getPixelY();
+    int bestDist = INT_MAX;
+    FOR_EACH (DelayedLoadsIter, it, mDelayedLoads)
+    {
+        const Actor *const owner = (*it)->getOwner();
+        // loads without owner used by gui and must be visible first
+        if (!owner)
+            return it;
+        const int dist = abs(owner->getPixelX() - x)
+            + abs(owner->getPixelY() - y);
+        if (dist < bestDist)
         {
-            (*it)->load();
-            AnimationDelayLoad *tmp = *it;
-            it = mDelayedAnimations.erase(it);
-            delete tmp;
-            k ++;
+            bestDist = dist;
+            best = it;
         }
-        const int time2 = tick_time;
-        if (time2 > loadTime)
-            loadTime = time2 + (time2 - loadTime) * 2 + 10;
-        else
-            loadTime = time2 + 3;
     }
-    BLOCK_END("DelayedManager::delayedLoad")
+    return best;
 }
 
-void DelayedManager::removeDelayLoad(const AnimationDelayLoad
-                                     *const delayedLoad)
+void DelayedManager::removeDelayLoad(const DelayedLoad *const delayedLoad)
 {
-    FOR_EACH (DelayedAnimIter, it, mDelayedAnimations)
+    FOR_EACH (DelayedLoadsIter, it, mDelayedLoads)
     {
         if (*it == delayedLoad)
         {
-            mDelayedAnimations.erase(it);
+            mDelayedLoads.erase(it);
             return;
         }
     }
@@ -25,28 +25,47 @@
 
 #include "localconsts.h"
 
-class AnimationDelayLoad;
+class Actor;
+class DelayedLoad;
 
-typedef std::list<AnimationDelayLoad*> DelayedAnim;
-typedef DelayedAnim::iterator DelayedAnimIter;
+typedef std::list<DelayedLoad*> DelayedLoads;
+typedef DelayedLoads::iterator DelayedLoadsIter;
 
 /**
- * A class for loading and managing resources.
+ * A class for loading resources in small portions between frames.
  */
 class DelayedManager final
 {
     public:
-        static void addDelayedAnimation(AnimationDelayLoad *const animation)
-        { mDelayedAnimations.push_back(animation); }
+        static void addDelayedLoad(DelayedLoad *const load);
 
-        static void delayedLoad();
+        /**
+         * Executes delayed loads until time budget for this frame spent.
+         * Loads nearest to player actor executed first.
+         */
+        static void delayedLoad(const Actor *const player);
 
-        static void removeDelayLoad(const AnimationDelayLoad
-                                    *const delayedLoad);
+        static void removeDelayLoad(const DelayedLoad *const delayedLoad);
 
+        static void setTimeBudget(const int budget)
+        { mTimeBudget = budget; }
+
+        static int getQueueSize() A_WARN_UNUSED
+        { return static_cast<int>(mDelayedLoads.size()); }
+
+        /**
+         * Returns time in milliseconds from adding to loading for last
+         * executed load.
+         */
+        static int getLatency() A_WARN_UNUSED
+        { return mLatency; }
 
     private:
-        static DelayedAnim mDelayedAnimations;
+        static DelayedLoadsIter findNearest(const Actor *const player);
+
+        static DelayedLoads mDelayedLoads;
+        static int mTimeBudget;
+        static int mLatency;
 };
 
 #endif  // RESOURCES_DELAYEDMANAGER_H
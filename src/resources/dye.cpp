@@ -26,15 +26,144 @@
 
 #include "resources/dyepalette.h"
 
+#include "utils/cpu.h"
 #include "utils/delete2.h"
 
+#include <algorithm>
 #include <sstream>
 
 #include <SDL_endian.h>
 
+#ifdef DYE_SIMD_SUPPORTED
+#include <emmintrin.h>
+#endif
+
 #include "debug.h"
 
-Dye::Dye(const std::string &description)
+typedef void (*DyePixelsFuncPtr) (const uint32_t *const *const luts,
+                                   uint32_t *restrict pixels,
+                                   const int bufSize,
+                                   const int rShift,
+                                   const int gShift,
+                                   const int bShift,
+                                   const uint32_t alphaMask);
+
+static inline void dyePixel(const uint32_t *const *const luts,
+                            uint32_t *const pixel,
+                            const int rShift,
+                            const int gShift,
+                            const int bShift,
+                            const uint32_t alphaMask)
+{
+    const uint32_t p = *pixel;
+    const int r = (p >> rShift) & 255;
+    const int g = (p >> gShift) & 255;
+    const int b = (p >> bShift) & 255;
+
+    const int cmax = std::max(r, std::max(g, b));
+    if (cmax == 0)
+        return;
+
+    const int cmin = std::min(r, std::min(g, b));
+    const int intensity = r + g + b;
+
+    if (cmin != cmax && (cmin != 0 || (intensity != cmax
+        && intensity != 2 * cmax)))
+    {
+        // not pure
+        return;
+    }
+
+    const int i = (r != 0) | ((g != 0) << 1) | ((b != 0) << 2);
+    const uint32_t *const lut = luts[i - 1];
+    if (!lut)
+        return;
+
+    const uint32_t color = lut[cmax];
+    *pixel = ((color & 255) << rShift)
+        | (((color >> 8) & 255) << gShift)
+        | (((color >> 16) & 255) << bShift)
+        | (p & alphaMask);
+}
+
+static void dyePixels(const uint32_t *const *const luts,
+                      uint32_t *restrict pixels,
+                      const int bufSize,
+                      const int rShift,
+                      const int gShift,
+                      const int bShift,
+                      const uint32_t alphaMask)
+{
+    for (uint32_t *p_end = pixels + static_cast<size_t>(bufSize);
+         pixels != p_end;
+         ++ pixels)
+    {
+        if (*pixels & alphaMask)
+            dyePixel(luts, pixels, rShift, gShift, bShift, alphaMask);
+    }
+}
+
+#ifdef DYE_SIMD_SUPPORTED
+// Checks 4 pixels at once and dyes only pure color pixels.
+__attribute__((target("sse2")))
+static void dyePixelsSse2(const uint32_t *const *const luts,
+                          uint32_t *restrict pixels,
+                          const int bufSize,
+                          const int rShift,
+                          const int gShift,
+                          const int bShift,
+                          const uint32_t alphaMask)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_set1_epi32(255);
+    const __m128i alpha4 = _mm_set1_epi32(static_cast<int>(alphaMask));
+    const __m128i rCount = _mm_cvtsi32_si128(rShift);
+    const __m128i gCount = _mm_cvtsi32_si128(gShift);
+    const __m128i bCount = _mm_cvtsi32_si128(bShift);
+
+    int f = 0;
+    for (; f + 4 <= bufSize; f += 4)
+    {
+        const __m128i p = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(pixels + f));
+        const __m128i r = _mm_and_si128(_mm_srl_epi32(p, rCount), mask);
+        const __m128i g = _mm_and_si128(_mm_srl_epi32(p, gCount), mask);
+        const __m128i b = _mm_and_si128(_mm_srl_epi32(p, bCount), mask);
+        // values below 256, so 16 bit min and max is enough
+        const __m128i cmax = _mm_max_epi16(r, _mm_max_epi16(g, b));
+        const __m128i cmin = _mm_min_epi16(r, _mm_min_epi16(g, b));
+        const __m128i intensity = _mm_add_epi32(_mm_add_epi32(r, g), b);
+
+        const __m128i gray = _mm_cmpeq_epi32(cmin, cmax);
+        const __m128i pure = _mm_and_si128(_mm_cmpeq_epi32(cmin, zero),
+            _mm_or_si128(_mm_cmpeq_epi32(intensity, cmax),
+            _mm_cmpeq_epi32(intensity, _mm_add_epi32(cmax, cmax))));
+        const __m128i skip = _mm_or_si128(
+            _mm_cmpeq_epi32(_mm_and_si128(p, alpha4), zero),
+            _mm_cmpeq_epi32(cmax, zero));
+        const int dyeMask = _mm_movemask_epi8(
+            _mm_andnot_si128(skip, _mm_or_si128(gray, pure)));
+        if (!dyeMask)
+            continue;
+
+        for (int k = 0; k < 4; k ++)
+        {
+            if (dyeMask & (1 << (k * 4)))
+            {
+                dyePixel(luts, pixels + f + k,
+                    rShift, gShift, bShift, alphaMask);
+            }
+        }
+    }
+    dyePixels(luts, pixels + f, bufSize - f,
+        rShift, gShift, bShift, alphaMask);
+}
+#endif  // DYE_SIMD_SUPPORTED
+
+static DyePixelsFuncPtr dyePixelsFunc = &dyePixels;
+
+Dye::Dye(const std::string &description) :
+    mDescription(description)
 {
     for (int i = 0; i < dyePalateSize; ++i)
         mDyePalettes[i] = nullptr;
@@ -148,112 +277,42 @@ int Dye::getType() const
     return 0;
 }
 
-void Dye::normalDye(uint32_t *restrict pixels, const int bufSize) const
+void Dye::getLuts(const uint32_t *luts[7]) const
 {
-    for (uint32_t *p_end = pixels + static_cast<size_t>(bufSize);
-         pixels != p_end;
-         ++ pixels)
+    for (int f = 0; f < 7; f ++)
     {
-        const uint32_t p = *pixels;
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        const int alpha = p & 0xff000000;
-#else
-        const int alpha = p & 0xff;
-#endif
-        if (!alpha)
-            continue;
-        int color[3];
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        color[0] = (p) & 255;
-        color[1] = (p >> 8) & 255;
-        color[2] = (p >> 16) & 255;
-#else
-        color[0] = (p >> 24) & 255;
-        color[1] = (p >> 16) & 255;
-        color[2] = (p >> 8) & 255;
-#endif
-
-        const int cmax = std::max(color[0], std::max(color[1], color[2]));
-        if (cmax == 0)
-            continue;
-
-        const int cmin = std::min(color[0], std::min(color[1], color[2]));
-        const int intensity = color[0] + color[1] + color[2];
-
-        if (cmin != cmax && (cmin != 0 || (intensity != cmax
-            && intensity != 2 * cmax)))
-        {
-            // not pure
-            continue;
-        }
-
-        const int i = (color[0] != 0) | ((color[1] != 0) << 1)
-            | ((color[2] != 0) << 2);
-
-        if (mDyePalettes[i - 1])
-            mDyePalettes[i - 1]->getColor(cmax, color);
+        const DyePalette *const pal = mDyePalettes[f];
+        luts[f] = pal ? pal->getLut() : nullptr;
+    }
+}
 
+void Dye::normalDye(uint32_t *restrict pixels, const int bufSize) const
+{
+    const uint32_t *luts[7];
+    getLuts(luts);
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        *pixels = (color[0]) | (color[1] << 8)
-            | (color[2] << 16) | alpha;
+    dyePixelsFunc(luts, pixels, bufSize, 0, 8, 16, 0xff000000U);
 #else
-        *pixels = (color[0] << 24) | (color[1] << 16)
-            | (color[2] << 8) | alpha;
+    dyePixelsFunc(luts, pixels, bufSize, 24, 16, 8, 0xffU);
 #endif
-    }
 }
 
 void Dye::normalOGLDye(uint32_t *restrict pixels, const int bufSize) const
 {
-    for (uint32_t *p_end = pixels + static_cast<size_t>(bufSize);
-         pixels != p_end;
-         ++ pixels)
-    {
-        const uint32_t p = *pixels;
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        const int alpha = p & 255;
-#else
-        const int alpha = p & 0xff000000;
-#endif
-        if (!alpha)
-            continue;
-        int color[3];
+    const uint32_t *luts[7];
+    getLuts(luts);
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        color[0] = (p >> 24) & 255;
-        color[1] = (p >> 16) & 255;
-        color[2] = (p >> 8) & 255;
+    dyePixelsFunc(luts, pixels, bufSize, 24, 16, 8, 0xffU);
 #else
-        color[0] = (p) & 255;
-        color[1] = (p >> 8) & 255;
-        color[2] = (p >> 16) & 255;
+    dyePixelsFunc(luts, pixels, bufSize, 0, 8, 16, 0xff000000U);
 #endif
+}
 
-        const int cmax = std::max(color[0], std::max(color[1], color[2]));
-        if (cmax == 0)
-            continue;
-
-        const int cmin = std::min(color[0], std::min(color[1], color[2]));
-        const int intensity = color[0] + color[1] + color[2];
-
-        if (cmin != cmax && (cmin != 0 || (intensity != cmax
-            && intensity != 2 * cmax)))
-        {
-            // not pure
-            continue;
-        }
-
-        const int i = (color[0] != 0) | ((color[1] != 0) << 1)
-            | ((color[2] != 0) << 2);
-
-        if (mDyePalettes[i - 1])
-            mDyePalettes[i - 1]->getColor(cmax, color);
-
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        *pixels = (color[0] << 24) | (color[1] << 16)
-            | (color[2] << 8) | alpha;
-#else
-        *pixels = (color[0]) | (color[1] << 8)
-            | (color[2] << 16) | alpha;
+void Dye::initFunctions(const int cpuFlags A_UNUSED)
+{
+    dyePixelsFunc = &dyePixels;
+#ifdef DYE_SIMD_SUPPORTED
+    if (cpuFlags & Cpu::FEATURE_SSE2)
+        dyePixelsFunc = &dyePixelsSse2;
 #endif
-    }
 }
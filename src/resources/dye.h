@@ -29,6 +29,11 @@
 
 class DyePalette;
 
+#if defined(__GNUC__) && (GCC_VERSION >= 40900) \
+    && (defined(__x86_64__) || defined(__i386__))
+#define DYE_SIMD_SUPPORTED
+#endif
+
 const int dyePalateSize = 9;
 const int sPaleteIndex = 7;
 const int aPaleteIndex = 8;
@@ -77,11 +82,23 @@ class Dye final
          */
         int getType() const A_WARN_UNUSED;
 
+        const std::string &getDescription() const A_WARN_UNUSED
+        { return mDescription; }
+
         void normalDye(uint32_t *restrict pixels, const int bufSize) const;
 
         void normalOGLDye(uint32_t *restrict pixels, const int bufSize) const;
 
+        /**
+         * Selects pixel kernels for given Cpu features.
+         */
+        static void initFunctions(const int cpuFlags);
+
     private:
+        void getLuts(const uint32_t *luts[7]) const;
+
+        std::string mDescription;
+
         /**
          * The order of the palettes, as well as their uppercase letter, is:
          *
@@ -20,10 +20,26 @@
 
 #include "resources/dye.h"
 
+#include "settings.h"
+
+#include "resources/dyecache.h"
 #include "resources/dyepalette.h"
 
+#include "utils/cpu.h"
+#include "utils/stringutils.h"
+
 #include "gtest/gtest.h"
 
+#include <SDL_video.h>
+
+#include <algorithm>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+#include <vector>
+
 #include "debug.h"
 
 TEST(Dye, replaceSOGLColor1)
@@ -253,3 +269,266 @@ TEST(Dye, normalOGLDye1)
     EXPECT_EQ(0x2a, data[2]);
     EXPECT_EQ(0x50, data[3]);
 }
+
+// Old per pixel dye code, used for checking lookup tables and kernels.
+static void normalDyeReference(DyePalette *const *const palettes,
+                               uint32_t *pixels,
+                               const int bufSize,
+                               const bool ogl)
+{
+    const int rShift = ogl ? 0 : 24;
+    const int gShift = ogl ? 8 : 16;
+    const int bShift = ogl ? 16 : 8;
+    const uint32_t alphaMask = ogl ? 0xff000000U : 0xffU;
+    for (int f = 0; f < bufSize; f ++)
+    {
+        const uint32_t p = pixels[f];
+        if (!(p & alphaMask))
+            continue;
+        int color[3];
+        color[0] = (p >> rShift) & 255;
+        color[1] = (p >> gShift) & 255;
+        color[2] = (p >> bShift) & 255;
+        const int cmax = std::max(color[0], std::max(color[1], color[2]));
+        if (cmax == 0)
+            continue;
+        const int cmin = std::min(color[0], std::min(color[1], color[2]));
+        const int intensity = color[0] + color[1] + color[2];
+        if (cmin != cmax && (cmin != 0 || (intensity != cmax
+            && intensity != 2 * cmax)))
+        {
+            continue;
+        }
+        const int i = (color[0] != 0) | ((color[1] != 0) << 1)
+            | ((color[2] != 0) << 2);
+        if (palettes[i - 1])
+            palettes[i - 1]->getColor(cmax, color);
+        pixels[f] = (color[0] << rShift) | (color[1] << gShift)
+            | (color[2] << bShift) | (p & alphaMask);
+    }
+}
+
+static void testNormalDyeKernel(const int cpuFlags, const bool ogl)
+{
+    const std::string str = "R:#203040,506070;B:#ff0000;"
+        "Y:#102030,a0b0c0,ffffff;W:#111111,eeeeee,808080";
+    Dye dye(str);
+    DyePalette *palettes[7] = {nullptr, nullptr, nullptr, nullptr,
+        nullptr, nullptr, nullptr};
+    palettes[0] = new DyePalette("#203040,506070", 6);
+    palettes[3] = new DyePalette("#ff0000", 6);
+    palettes[2] = new DyePalette("#102030,a0b0c0,ffffff", 6);
+    palettes[6] = new DyePalette("#111111,eeeeee,808080", 6);
+
+    // mostly pure colors, like in dyeable sprites
+    const int size = 4099;
+    std::vector<uint32_t> pixels(size);
+    unsigned int seed = 12345;
+    for (int f = 0; f < size; f ++)
+    {
+        seed = seed * 1103515245U + 12345U;
+        const uint32_t v = (seed >> 16) & 255;
+        const uint32_t v2 = (seed >> 8) & 255;
+        const uint32_t a = (seed >> 24) & 3 ? (seed >> 4) & 255 : 0;
+        uint32_t rgb[3] = {0, 0, 0};
+        switch ((seed >> 12) % 6)
+        {
+            case 0: rgb[0] = v; break;
+            case 1: rgb[0] = v; rgb[1] = v; break;
+            case 2: rgb[0] = v; rgb[1] = v; rgb[2] = v; break;
+            case 3: rgb[2] = v; break;
+            case 4: rgb[1] = v; rgb[2] = v2; break;
+            default: rgb[0] = v; rgb[1] = v2; rgb[2] = v; break;
+        }
+        pixels[f] = ogl
+            ? rgb[0] | (rgb[1] << 8) | (rgb[2] << 16) | (a << 24)
+            : (rgb[0] << 24) | (rgb[1] << 16) | (rgb[2] << 8) | a;
+    }
+    std::vector<uint32_t> reference = pixels;
+    normalDyeReference(palettes, &reference[0], size, ogl);
+
+    Dye::initFunctions(cpuFlags);
+    if (ogl)
+        dye.normalOGLDye(&pixels[0], size);
+    else
+        dye.normalDye(&pixels[0], size);
+    Dye::initFunctions(0);
+
+    for (int f = 0; f < size; f ++)
+        EXPECT_EQ(reference[f], pixels[f]);
+    for (int f = 0; f < 7; f ++)
+        delete palettes[f];
+}
+
+TEST(Dye, normalDyeKernels)
+{
+#if SDL_BYTEORDER != SDL_BIG_ENDIAN
+    testNormalDyeKernel(0, false);
+    testNormalDyeKernel(0, true);
+    testNormalDyeKernel(Cpu::FEATURE_SSE2, false);
+    testNormalDyeKernel(Cpu::FEATURE_SSE2, true);
+#endif
+}
+
+TEST(Dye, replaceSColorRepeated)
+{
+    DyePalette palette("#0000ff,000011,0000ff,222222,00ff00,333333", 6);
+    uint8_t data[16];
+    for (int f = 0; f < 3; f ++)
+    {
+        data[f * 4 + 0] = 0x10;
+        data[f * 4 + 1] = 0xff;
+        data[f * 4 + 2] = 0x00;
+        data[f * 4 + 3] = 0x00;
+    }
+    data[12] = 0x10;
+    data[13] = 0x00;
+    data[14] = 0xff;
+    data[15] = 0x00;
+    palette.replaceSColor(reinterpret_cast<uint32_t*>(&data[0]), 4);
+    for (int f = 0; f < 3; f ++)
+    {
+        EXPECT_EQ(0x10, data[f * 4 + 0]);
+        EXPECT_EQ(0x11, data[f * 4 + 1]);
+        EXPECT_EQ(0x00, data[f * 4 + 2]);
+        EXPECT_EQ(0x00, data[f * 4 + 3]);
+    }
+    EXPECT_EQ(0x10, data[12]);
+    EXPECT_EQ(0x33, data[13]);
+    EXPECT_EQ(0x33, data[14]);
+    EXPECT_EQ(0x33, data[15]);
+}
+
+TEST(Dye, dyeCacheNormalize)
+{
+    EXPECT_EQ("", DyeCache::normalize(""));
+    EXPECT_EQ("R:#203040", DyeCache::normalize("R:#203040"));
+    EXPECT_EQ("B:#FFFFFF;R:#203040",
+        DyeCache::normalize("R:#203040;B:#FFFFFF"));
+    EXPECT_EQ("S:#aabbcc", DyeCache::normalize("S:#aabbcc"));
+    EXPECT_EQ(DyeCache::normalize("G:#111111;W:#222222"),
+        DyeCache::normalize("W:#222222;G:#111111"));
+    EXPECT_EQ("R:#111111;R:#222222",
+        DyeCache::normalize("R:#111111;R:#222222"));
+}
+
+TEST(Dye, dyeCacheKey)
+{
+    const char data[] = "image data";
+    EXPECT_NE(DyeCache::getKey("a.png", data, 10, "R:#ff0000", 0),
+        DyeCache::getKey("b.png", data, 10, "R:#ff0000", 0));
+    EXPECT_NE(DyeCache::getKey("a.png", data, 10, "R:#ff0000", 0),
+        DyeCache::getKey("a.png", data, 10, "R:#ff0000", 1));
+    EXPECT_NE(DyeCache::getKey("a.png", data, 10, "R:#ff0000", 0),
+        DyeCache::getKey("a.png", data, 9, "R:#ff0000", 0));
+    EXPECT_EQ(DyeCache::getKey("a.png", data, 10, "G:#111;R:#ff0000", 0),
+        DyeCache::getKey("a.png", data, 10, "R:#ff0000;G:#111", 0));
+}
+
+static SDL_Surface *createCacheSurface()
+{
+    SDL_Surface *const surface = SDL_CreateRGBSurface(SDL_SWSURFACE,
+        5, 3, 32, 0x000000ffU, 0x0000ff00U, 0x00ff0000U, 0xff000000U);
+    uint8_t *const pixels = static_cast<uint8_t*>(surface->pixels);
+    for (int y = 0; y < surface->h; y ++)
+    {
+        for (int x = 0; x < surface->w * 4; x ++)
+            pixels[y * surface->pitch + x] = static_cast<uint8_t>(x * 7 + y);
+    }
+    return surface;
+}
+
+static std::string getCacheFile()
+{
+    std::string fileName;
+    const std::string dirName = settings.localDataDir + "/cache/dye/";
+    DIR *const dir = opendir(dirName.c_str());
+    if (!dir)
+        return fileName;
+    const struct dirent *next_file = nullptr;
+    while ((next_file = readdir(dir)))
+    {
+        if (next_file->d_name[0] != '.')
+            fileName = dirName + next_file->d_name;
+    }
+    closedir(dir);
+    return fileName;
+}
+
+TEST(Dye, dyeCacheSaveLoad)
+{
+    const std::string oldDir = settings.localDataDir;
+    settings.localDataDir = strprintf("/tmp/manaplus_dyecache_%d",
+        static_cast<int>(getpid()));
+    DyeCache::setLimit(1000000);
+    SDL_Surface *const surface = createCacheSurface();
+    const std::string key = DyeCache::getKey("test.png", "data", 4,
+        "R:#ff0000", 0);
+    DyeCache::save(key, surface);
+
+    SDL_Surface *const surface2 = DyeCache::load(key);
+    ASSERT_TRUE(surface2 != nullptr);
+    EXPECT_EQ(surface->w, surface2->w);
+    EXPECT_EQ(surface->h, surface2->h);
+    EXPECT_EQ(surface->format->Rmask, surface2->format->Rmask);
+    EXPECT_EQ(surface->format->Amask, surface2->format->Amask);
+    for (int y = 0; y < surface->h; y ++)
+    {
+        EXPECT_EQ(0, memcmp(static_cast<uint8_t*>(surface->pixels)
+            + y * surface->pitch, static_cast<uint8_t*>(surface2->pixels)
+            + y * surface2->pitch, surface->w * 4));
+    }
+    SDL_FreeSurface(surface2);
+
+    // other key with same file name not loaded
+    EXPECT_TRUE(DyeCache::load(DyeCache::getKey("test.png", "data", 4,
+        "R:#ff0001", 0)) == nullptr);
+
+    const std::string fileName = getCacheFile();
+    ASSERT_FALSE(fileName.empty());
+    std::vector<char> data;
+    {
+        std::ifstream file(fileName.c_str(),
+            std::ios::in | std::ios::binary);
+        data.assign(std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>());
+    }
+    ASSERT_GT(data.size(), 40U);
+
+    // damaged pixels
+    std::vector<char> data2 = data;
+    data2[data2.size() - 3] ^= 0x55;
+    data2[data2.size() - 8] ^= 0x55;
+    {
+        std::ofstream file(fileName.c_str(),
+            std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write(&data2[0], data2.size());
+    }
+    EXPECT_TRUE(DyeCache::load(key) == nullptr);
+
+    // truncated file
+    {
+        std::ofstream file(fileName.c_str(),
+            std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write(&data[0], data.size() - 5);
+    }
+    EXPECT_TRUE(DyeCache::load(key) == nullptr);
+
+    // damaged header
+    data2 = data;
+    data2[1] = 'X';
+    {
+        std::ofstream file(fileName.c_str(),
+            std::ios::out | std::ios::binary | std::ios::trunc);
+        file.write(&data2[0], data2.size());
+    }
+    EXPECT_TRUE(DyeCache::load(key) == nullptr);
+
+    ::remove(fileName.c_str());
+    ::rmdir((settings.localDataDir + "/cache/dye").c_str());
+    ::rmdir((settings.localDataDir + "/cache").c_str());
+    ::rmdir(settings.localDataDir.c_str());
+    DyeCache::clear();
+    settings.localDataDir = oldDir;
+    SDL_FreeSurface(surface);
+}
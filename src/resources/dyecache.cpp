@@ -0,0 +1,385 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/dyecache.h"
+
+#include "logger.h"
+#include "settings.h"
+
+#include "utils/files.h"
+#include "utils/mkdir.h"
+#include "utils/sdlcheckutils.h"
+#include "utils/mutex.h"
+#include "utils/stringutils.h"
+
+#include <SDL_thread.h>
+#include <SDL_video.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <map>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <zlib.h>
+
+#include "debug.h"
+
+static const char dyeCacheMagic[4] = {'M', 'P', 'D', 'Y'};
+static const int dyeCacheVersion = 3;
+static const int dyeCacheHeaderSize = 36;
+
+static void writeInt(std::ofstream &file, const uint32_t val)
+{
+    const char buf[4] =
+    {
+        static_cast<char>(val & 0xff),
+        static_cast<char>((val >> 8) & 0xff),
+        static_cast<char>((val >> 16) & 0xff),
+        static_cast<char>((val >> 24) & 0xff)
+    };
+    file.write(buf, 4);
+}
+
+static uint32_t readInt(const std::vector<char> &data, const size_t pos)
+{
+    const uint8_t *const ptr = reinterpret_cast<const uint8_t*>(&data[pos]);
+    return static_cast<uint32_t>(ptr[0])
+        | (static_cast<uint32_t>(ptr[1]) << 8)
+        | (static_cast<uint32_t>(ptr[2]) << 16)
+        | (static_cast<uint32_t>(ptr[3]) << 24);
+}
+
+static bool compareChannels(const std::string &str1,
+                            const std::string &str2)
+{
+    return str1[0] < str2[0];
+}
+
+static std::string getCacheDir()
+{
+    return settings.localDataDir + "/cache/dye";
+}
+
+static std::string getCacheFileName(const std::string &key)
+{
+    return strprintf("%s/%08x%08x.bin", getCacheDir().c_str(),
+        static_cast<unsigned int>(hashString(key)),
+        static_cast<unsigned int>(key.size()));
+}
+
+namespace
+{
+    struct CacheFile final
+    {
+        uint64_t size;
+        uint64_t stamp;
+    };
+
+    typedef std::map<std::string, CacheFile> CacheFiles;
+    typedef CacheFiles::iterator CacheFilesIter;
+    typedef std::map<uint64_t, std::string> CacheOrder;
+
+    // file names by size and last use, guarded by cacheMutex
+    Mutex cacheMutex;
+    CacheFiles cacheFiles;
+    CacheOrder cacheOrder;
+    uint64_t cacheSize = 0;
+    uint64_t cacheLimit = 0;
+    uint64_t cacheStamp = 0;
+    bool cacheIndexed = false;
+
+    bool compareMTime(const std::pair<time_t, std::string> &file1,
+                      const std::pair<time_t, std::string> &file2)
+    {
+        return file1.first < file2.first;
+    }
+
+    void removeFile(const CacheFilesIter &it)
+    {
+        ::remove(it->first.c_str());
+        cacheSize -= it->second.size;
+        cacheOrder.erase(it->second.stamp);
+        cacheFiles.erase(it);
+    }
+
+    void trimIndex()
+    {
+        while (cacheSize > cacheLimit && !cacheOrder.empty())
+        {
+            const CacheFilesIter it = cacheFiles.find(
+                cacheOrder.begin()->second);
+            if (it == cacheFiles.end())
+                cacheOrder.erase(cacheOrder.begin());
+            else
+                removeFile(it);
+        }
+    }
+
+    void addFile(const std::string &fileName, const uint64_t size)
+    {
+        const CacheFilesIter it = cacheFiles.find(fileName);
+        if (it != cacheFiles.end())
+        {
+            cacheSize -= it->second.size;
+            cacheOrder.erase(it->second.stamp);
+            cacheFiles.erase(it);
+        }
+        const CacheFile file = {size, cacheStamp ++};
+        cacheFiles[fileName] = file;
+        cacheOrder[file.stamp] = fileName;
+        cacheSize += size;
+    }
+
+    // oldest files by modification time get lowest stamps
+    void indexFiles()
+    {
+        if (cacheIndexed)
+            return;
+        cacheIndexed = true;
+        const std::string dirName = getCacheDir() + "/";
+        DIR *const dir = opendir(dirName.c_str());
+        if (!dir)
+            return;
+        std::vector<std::pair<time_t, std::string> > files;
+        std::map<std::string, uint64_t> sizes;
+        const struct dirent *next_file = nullptr;
+        while ((next_file = readdir(dir)))
+        {
+            const std::string fileName = dirName + next_file->d_name;
+            struct stat statbuf;
+            if (!stat(fileName.c_str(), &statbuf)
+                && S_ISREG(statbuf.st_mode))
+            {
+                files.push_back(std::pair<time_t, std::string>(
+                    statbuf.st_mtime, fileName));
+                sizes[fileName] = static_cast<uint64_t>(statbuf.st_size);
+            }
+        }
+        closedir(dir);
+        std::sort(files.begin(), files.end(), &compareMTime);
+        for (std::vector<std::pair<time_t, std::string> >::const_iterator
+             it = files.begin(), it_end = files.end(); it != it_end; ++ it)
+        {
+            addFile(it->second, sizes[it->second]);
+        }
+        trimIndex();
+    }
+
+    void touchFile(const std::string &fileName)
+    {
+        MutexLocker lock(&cacheMutex);
+        indexFiles();
+        const CacheFilesIter it = cacheFiles.find(fileName);
+        if (it == cacheFiles.end())
+            return;
+        cacheOrder.erase(it->second.stamp);
+        it->second.stamp = cacheStamp ++;
+        cacheOrder[it->second.stamp] = fileName;
+    }
+}  // namespace
+
+namespace DyeCache
+{
+    void setLimit(const uint64_t size)
+    {
+        MutexLocker lock(&cacheMutex);
+        cacheLimit = size;
+    }
+
+    void clear()
+    {
+        MutexLocker lock(&cacheMutex);
+        if (cacheIndexed)
+            trimIndex();
+        cacheFiles.clear();
+        cacheOrder.clear();
+        cacheSize = 0;
+        cacheStamp = 0;
+        cacheIndexed = false;
+    }
+
+    std::string normalize(const std::string &dye)
+    {
+        StringVect channels;
+        splitToStringVector(channels, dye, ';');
+        // later duplicate channel replace previous, so order kept for them
+        std::stable_sort(channels.begin(), channels.end(), &compareChannels);
+        std::string str;
+        FOR_EACH (StringVectCIter, it, channels)
+        {
+            if (!str.empty())
+                str.append(";");
+            str.append(*it);
+        }
+        return str;
+    }
+
+    std::string getKey(const std::string &path,
+                       const char *const data,
+                       const int size,
+                       const std::string &dye,
+                       const int format)
+    {
+        uLong crc = crc32(0L, Z_NULL, 0);
+        crc = crc32(crc, reinterpret_cast<const Bytef*>(data),
+            static_cast<uInt>(size));
+        return strprintf("%08x %d %d %s|%s", static_cast<unsigned int>(crc),
+            size, format, path.c_str(), normalize(dye).c_str());
+    }
+
+    SDL_Surface *load(const std::string &key)
+    {
+        const std::string fileName = getCacheFileName(key);
+        std::ifstream file;
+        file.open(fileName.c_str(), std::ios::in | std::ios::binary);
+        if (!file.is_open())
+            return nullptr;
+        file.seekg(0, std::ios::end);
+        const int fileSize = static_cast<int>(file.tellg());
+        file.seekg(0, std::ios::beg);
+        const int keySize = static_cast<int>(key.size());
+        if (fileSize <= dyeCacheHeaderSize + keySize)
+            return nullptr;
+        std::vector<char> data(fileSize);
+        file.read(&data[0], fileSize);
+        const bool isRead = file.gcount() == fileSize;
+        file.close();
+        if (!isRead)
+        {
+            logger->log("Error reading dye cache: %s", fileName.c_str());
+            return nullptr;
+        }
+
+        if (memcmp(&data[0], dyeCacheMagic, 4)
+            || static_cast<int>(readInt(data, 4)) != dyeCacheVersion
+            || static_cast<int>(readInt(data, 8)) != keySize
+            || key.compare(0, keySize, &data[dyeCacheHeaderSize],
+            keySize) != 0)
+        {
+            // hash collision or old format
+            return nullptr;
+        }
+        const int width = static_cast<int>(readInt(data, 12));
+        const int height = static_cast<int>(readInt(data, 16));
+        if (width <= 0 || height <= 0 || width > 16384 || height > 16384)
+            return nullptr;
+
+        const size_t rowSize = static_cast<size_t>(width) * 4;
+        std::vector<char> pixels(rowSize * height);
+        uLongf pixelsSize = static_cast<uLongf>(pixels.size());
+        if (uncompress(reinterpret_cast<Bytef*>(&pixels[0]), &pixelsSize,
+            reinterpret_cast<const Bytef*>(
+            &data[dyeCacheHeaderSize + keySize]),
+            static_cast<uLong>(fileSize - dyeCacheHeaderSize - keySize))
+            != Z_OK || pixelsSize != pixels.size())
+        {
+            return nullptr;
+        }
+
+        SDL_Surface *const surface = MSDL_CreateRGBSurface(SDL_SWSURFACE,
+            width, height, 32U, readInt(data, 20), readInt(data, 24),
+            readInt(data, 28), readInt(data, 32));
+        if (!surface)
+            return nullptr;
+
+        const char *src = &pixels[0];
+        for (int y = 0; y < height; y ++)
+        {
+            memcpy(static_cast<uint8_t*>(surface->pixels)
+                + y * surface->pitch, src, rowSize);
+            src += rowSize;
+        }
+        touchFile(fileName);
+        return surface;
+    }
+
+    void save(const std::string &key,
+              const SDL_Surface *const surface)
+    {
+        if (!surface || !surface->format
+            || surface->format->BitsPerPixel != 32)
+        {
+            return;
+        }
+
+        const size_t rowSize = static_cast<size_t>(surface->w) * 4;
+        std::vector<char> pixels(rowSize * surface->h);
+        for (int y = 0; y < surface->h; y ++)
+        {
+            memcpy(&pixels[y * rowSize], static_cast<const char*>(
+                surface->pixels) + y * surface->pitch, rowSize);
+        }
+        uLongf packedSize = compressBound(static_cast<uLong>(pixels.size()));
+        std::vector<char> packed(packedSize);
+        if (compress2(reinterpret_cast<Bytef*>(&packed[0]), &packedSize,
+            reinterpret_cast<const Bytef*>(&pixels[0]),
+            static_cast<uLong>(pixels.size()), Z_BEST_SPEED) != Z_OK)
+        {
+            return;
+        }
+
+        const std::string fileName = getCacheFileName(key);
+        // other thread can save same image, so use own temp file
+        const std::string tmpName = strprintf("%s.%u", fileName.c_str(),
+            static_cast<unsigned int>(SDL_ThreadID()));
+        std::ofstream file;
+        file.open(tmpName.c_str(), std::ios::out | std::ios::binary);
+        if (!file.is_open())
+        {
+            mkdir_r(getCacheDir().c_str());
+            file.open(tmpName.c_str(), std::ios::out | std::ios::binary);
+            if (!file.is_open())
+            {
+                logger->log_r("Error saving dye cache: %s",
+                    fileName.c_str());
+                return;
+            }
+        }
+
+        const SDL_PixelFormat *const format = surface->format;
+        file.write(dyeCacheMagic, 4);
+        writeInt(file, dyeCacheVersion);
+        writeInt(file, static_cast<uint32_t>(key.size()));
+        writeInt(file, static_cast<uint32_t>(surface->w));
+        writeInt(file, static_cast<uint32_t>(surface->h));
+        writeInt(file, format->Rmask);
+        writeInt(file, format->Gmask);
+        writeInt(file, format->Bmask);
+        writeInt(file, format->Amask);
+        file.write(key.c_str(), key.size());
+        file.write(&packed[0], packedSize);
+        file.close();
+        if (file.fail() || Files::renameFile(tmpName, fileName))
+        {
+            ::remove(tmpName.c_str());
+            return;
+        }
+
+        MutexLocker lock(&cacheMutex);
+        indexFiles();
+        addFile(fileName, dyeCacheHeaderSize + key.size() + packedSize);
+        trimIndex();
+    }
+}  // namespace DyeCache
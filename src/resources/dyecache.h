@@ -0,0 +1,75 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_DYECACHE_H
+#define RESOURCES_DYECACHE_H
+
+#include <stdint.h>
+#include <string>
+
+#include "localconsts.h"
+
+struct SDL_Surface;
+
+/**
+ * Disk cache for dyed images. Files named by hash of source image path and
+ * data, normalized dye string and pixel format, and store compressed pixels.
+ * Total size kept under limit by removing least recently used files.
+ * Functions can be called from worker threads.
+ */
+namespace DyeCache
+{
+    /**
+     * Sets maximum size of cache files in bytes.
+     */
+    void setLimit(const uint64_t size);
+
+    /**
+     * Trims cache files to limit and frees files index.
+     */
+    void clear();
+
+    /**
+     * Returns dye string with sorted channels, like "B:#fff;R:#000".
+     * Case kept as is.
+     */
+    std::string normalize(const std::string &dye) A_WARN_UNUSED;
+
+    /**
+     * Returns key from crc32 and size of image data, image path, dye and
+     * pixel format. Full key stored in file, so collisions are detected.
+     */
+    std::string getKey(const std::string &path,
+                       const char *const data,
+                       const int size,
+                       const std::string &dye,
+                       const int format) A_WARN_UNUSED;
+
+    /**
+     * Loads cached surface or returns nullptr. Truncated or damaged files
+     * are ignored.
+     */
+    SDL_Surface *load(const std::string &key) A_WARN_UNUSED;
+
+    void save(const std::string &key,
+              const SDL_Surface *const surface);
+}  // namespace DyeCache
+
+#endif  // RESOURCES_DYECACHE_H
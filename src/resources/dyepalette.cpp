@@ -26,15 +26,25 @@
 
 #include "resources/db/palettedb.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include <SDL_endian.h>
 
 #include "debug.h"
 
+typedef std::vector<std::pair<unsigned int, size_t> > DyeColorKeys;
+
 DyePalette::DyePalette(const std::string &description,
                        const uint8_t blockSize) :
     mColors()
+{
+    parse(description, blockSize);
+    initLut();
+}
+
+void DyePalette::parse(const std::string &description,
+                       const uint8_t blockSize)
 {
     const size_t size = static_cast<size_t>(description.length());
     if (size == 0)
@@ -87,6 +97,29 @@ DyePalette::DyePalette(const std::string &description,
     logger->log("Error, invalid embedded palette: %s", description.c_str());
 }
 
+void DyePalette::initLut()
+{
+    mLut[0] = 0;
+    int color[3] = {0, 0, 0};
+    for (int f = 1; f < 256; f ++)
+    {
+        getColor(f, color);
+        mLut[f] = static_cast<uint32_t>(color[0])
+            | (static_cast<uint32_t>(color[1]) << 8)
+            | (static_cast<uint32_t>(color[2]) << 16);
+    }
+}
+
+// Returns index of first color pair with given key, or -1.
+static int findColorKey(const DyeColorKeys &keys, const unsigned int data)
+{
+    const DyeColorKeys::const_iterator it = std::lower_bound(
+        keys.begin(), keys.end(), std::make_pair(data, static_cast<size_t>(0)));
+    if (it == keys.end() || (*it).first != data)
+        return -1;
+    return static_cast<int>((*it).second);
+}
+
 unsigned int DyePalette::hexDecode(const signed char c)
 {
     if ('0' <= c && c <= '9')
@@ -199,13 +232,29 @@ void DyePalette::getColor(double intensity, int color[3]) const
 void DyePalette::replaceSColor(uint32_t *restrict pixels,
                                const int bufSize) const
 {
-    std::vector<DyeColor>::const_iterator it_end = mColors.end();
-    const size_t sz = mColors.size();
+    const size_t sz = mColors.size() & ~static_cast<size_t>(1);
     if (!sz)
         return;
-    if (sz % 2)
-        -- it_end;
 
+    DyeColorKeys keys;
+    keys.reserve(sz / 2);
+    for (size_t f = 0; f < sz; f += 2)
+    {
+        const DyeColor &col = mColors[f];
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+        const unsigned int coldata = (col.value[2] << 16)
+            | (col.value[1] << 8) | (col.value[0]);
+#else
+        const unsigned int coldata = (col.value[2] << 8)
+            | (col.value[1] << 16) | (col.value[0] << 24);
+#endif
+        keys.push_back(std::make_pair(coldata, f + 1));
+    }
+    std::sort(keys.begin(), keys.end());
+
+    unsigned int lastData = 0;
+    int lastIdx = -1;
+    bool hasLast = false;
     for (uint32_t *p_end = pixels + static_cast<size_t>(bufSize);
          pixels != p_end;
          ++pixels)
@@ -218,39 +267,22 @@ void DyePalette::replaceSColor(uint32_t *restrict pixels,
         const int alpha = *p & 0xff;
         const unsigned int data = (*pixels) & 0xffffff00;
 #endif
-//        logger->log("c:%04d   %08x", c, *pixels);
-//        logger->log("data:    %08x", data);
         if (!alpha)
-        {
-//            logger->log("skip:    %08x", *pixels);
             continue;
-        }
 
-        std::vector<DyeColor>::const_iterator it = mColors.begin();
-        while (it != it_end)
+        // neighbour pixels often have same color
+        if (!hasLast || data != lastData)
         {
-            const DyeColor &col = *it;
-            ++ it;
-            const DyeColor &col2 = *it;
-
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-            const unsigned int coldata = (col.value[2] << 16)
-                | (col.value[1] << 8) | (col.value[0]);
-#else
-            const unsigned int coldata = (col.value[2] << 8)
-                | (col.value[1] << 16) | (col.value[0] << 24);
-#endif
-//            logger->log("coldata: %08x", coldata);
-            if (data == coldata)
-            {
-//                logger->log("correct");
-                p[3] = col2.value[0];
-                p[2] = col2.value[1];
-                p[1] = col2.value[2];
-                break;
-            }
-
-            ++ it;
+            lastData = data;
+            lastIdx = findColorKey(keys, data);
+            hasLast = true;
+        }
+        if (lastIdx >= 0)
+        {
+            const DyeColor &col2 = mColors[lastIdx];
+            p[3] = col2.value[0];
+            p[2] = col2.value[1];
+            p[1] = col2.value[2];
         }
     }
 }
@@ -258,13 +290,29 @@ void DyePalette::replaceSColor(uint32_t *restrict pixels,
 void DyePalette::replaceAColor(uint32_t *restrict pixels,
                                const int bufSize) const
 {
-    std::vector<DyeColor>::const_iterator it_end = mColors.end();
-    const size_t sz = mColors.size();
+    const size_t sz = mColors.size() & ~static_cast<size_t>(1);
     if (!sz)
         return;
-    if (sz % 2)
-        -- it_end;
 
+    DyeColorKeys keys;
+    keys.reserve(sz / 2);
+    for (size_t f = 0; f < sz; f += 2)
+    {
+        const DyeColor &col = mColors[f];
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+        const unsigned int coldata = (col.value[3] << 24)
+            | (col.value[2] << 16) | (col.value[1] << 8) | (col.value[0]);
+#else
+        const unsigned int coldata = (col.value[3]) | (col.value[2] << 8)
+            | (col.value[1] << 16) | (col.value[0] << 24);
+#endif
+        keys.push_back(std::make_pair(coldata, f + 1));
+    }
+    std::sort(keys.begin(), keys.end());
+
+    unsigned int lastData = 0;
+    int lastIdx = -1;
+    bool hasLast = false;
     for (uint32_t *p_end = pixels + static_cast<size_t>(bufSize);
          pixels != p_end;
          ++pixels)
@@ -272,31 +320,19 @@ void DyePalette::replaceAColor(uint32_t *restrict pixels,
         uint8_t *const p = reinterpret_cast<uint8_t *>(pixels);
         const unsigned int data = *pixels;
 
-        std::vector<DyeColor>::const_iterator it = mColors.begin();
-        while (it != it_end)
+        if (!hasLast || data != lastData)
         {
-            const DyeColor &col = *it;
-            ++ it;
-            const DyeColor &col2 = *it;
-
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-            const unsigned int coldata = (col.value[3] << 24)
-                | (col.value[2] << 16) | (col.value[1] << 8) | (col.value[0]);
-#else
-            const unsigned int coldata = (col.value[3]) | (col.value[2] << 8)
-                | (col.value[1] << 16) | (col.value[0] << 24);
-#endif
-
-            if (data == coldata)
-            {
-                p[3] = col2.value[0];
-                p[2] = col2.value[1];
-                p[1] = col2.value[2];
-                p[0] = col2.value[3];
-                break;
-            }
-
-            ++ it;
+            lastData = data;
+            lastIdx = findColorKey(keys, data);
+            hasLast = true;
+        }
+        if (lastIdx >= 0)
+        {
+            const DyeColor &col2 = mColors[lastIdx];
+            p[3] = col2.value[0];
+            p[2] = col2.value[1];
+            p[1] = col2.value[2];
+            p[0] = col2.value[3];
         }
     }
 }
@@ -304,13 +340,29 @@ void DyePalette::replaceAColor(uint32_t *restrict pixels,
 void DyePalette::replaceSOGLColor(uint32_t *restrict pixels,
                                   const int bufSize) const
 {
-    std::vector<DyeColor>::const_iterator it_end = mColors.end();
-    const size_t sz = mColors.size();
+    const size_t sz = mColors.size() & ~static_cast<size_t>(1);
     if (!sz)
         return;
-    if (sz % 2)
-        -- it_end;
 
+    DyeColorKeys keys;
+    keys.reserve(sz / 2);
+    for (size_t f = 0; f < sz; f += 2)
+    {
+        const DyeColor &col = mColors[f];
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+        const unsigned int coldata = (col.value[0] << 24)
+            | (col.value[1] << 16) | (col.value[2] << 8);
+#else
+        const unsigned int coldata = (col.value[0])
+            | (col.value[1] << 8) | (col.value[2] << 16);
+#endif
+        keys.push_back(std::make_pair(coldata, f + 1));
+    }
+    std::sort(keys.begin(), keys.end());
+
+    unsigned int lastData = 0;
+    int lastIdx = -1;
+    bool hasLast = false;
     for (uint32_t *p_end = pixels + static_cast<size_t>(bufSize);
          pixels != p_end;
          ++pixels)
@@ -326,29 +378,18 @@ void DyePalette::replaceSOGLColor(uint32_t *restrict pixels,
         if (!alpha)
             continue;
 
-        std::vector<DyeColor>::const_iterator it = mColors.begin();
-        while (it != it_end)
+        if (!hasLast || data != lastData)
         {
-            const DyeColor &col = *it;
-            ++ it;
-            const DyeColor &col2 = *it;
-
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-            const unsigned int coldata = (col.value[0] << 24)
-                | (col.value[1] << 16) | (col.value[2] << 8);
-#else
-            const unsigned int coldata = (col.value[0])
-                | (col.value[1] << 8) | (col.value[2] << 16);
-#endif
-            if (data == coldata)
-            {
-                p[0] = col2.value[0];
-                p[1] = col2.value[1];
-                p[2] = col2.value[2];
-                break;
-            }
-
-            ++ it;
+            lastData = data;
+            lastIdx = findColorKey(keys, data);
+            hasLast = true;
+        }
+        if (lastIdx >= 0)
+        {
+            const DyeColor &col2 = mColors[lastIdx];
+            p[0] = col2.value[0];
+            p[1] = col2.value[1];
+            p[2] = col2.value[2];
         }
     }
 }
@@ -356,13 +397,29 @@ void DyePalette::replaceSOGLColor(uint32_t *restrict pixels,
 void DyePalette::replaceAOGLColor(uint32_t *restrict pixels,
                                   const int bufSize) const
 {
-    std::vector<DyeColor>::const_iterator it_end = mColors.end();
-    const size_t sz = mColors.size();
+    const size_t sz = mColors.size() & ~static_cast<size_t>(1);
     if (!sz)
         return;
-    if (sz % 2)
-        -- it_end;
 
+    DyeColorKeys keys;
+    keys.reserve(sz / 2);
+    for (size_t f = 0; f < sz; f += 2)
+    {
+        const DyeColor &col = mColors[f];
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+        const unsigned int coldata = (col.value[0] << 24)
+            | (col.value[1] << 16) | (col.value[2] << 8) | col.value[3];
+#else
+        const unsigned int coldata = (col.value[0]) | (col.value[1] << 8)
+            | (col.value[2] << 16) | (col.value[3] << 24);
+#endif
+        keys.push_back(std::make_pair(coldata, f + 1));
+    }
+    std::sort(keys.begin(), keys.end());
+
+    unsigned int lastData = 0;
+    int lastIdx = -1;
+    bool hasLast = false;
     for (uint32_t *p_end = pixels + static_cast<size_t>(bufSize);
          pixels != p_end;
          ++pixels)
@@ -370,30 +427,19 @@ void DyePalette::replaceAOGLColor(uint32_t *restrict pixels,
         uint8_t *const p = reinterpret_cast<uint8_t *>(pixels);
         const unsigned int data = *pixels;
 
-        std::vector<DyeColor>::const_iterator it = mColors.begin();
-        while (it != it_end)
+        if (!hasLast || data != lastData)
         {
-            const DyeColor &col = *it;
-            ++ it;
-            const DyeColor &col2 = *it;
-
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-            const unsigned int coldata = (col.value[0] << 24)
-                | (col.value[1] << 16) | (col.value[2] << 8) | col.value[3];
-#else
-            const unsigned int coldata = (col.value[0]) | (col.value[1] << 8)
-                | (col.value[2] << 16) | (col.value[3] << 24);
-#endif
-            if (data == coldata)
-            {
-                p[0] = col2.value[0];
-                p[1] = col2.value[1];
-                p[2] = col2.value[2];
-                p[3] = col2.value[3];
-                break;
-            }
-
-            ++ it;
+            lastData = data;
+            lastIdx = findColorKey(keys, data);
+            hasLast = true;
+        }
+        if (lastIdx >= 0)
+        {
+            const DyeColor &col2 = mColors[lastIdx];
+            p[0] = col2.value[0];
+            p[1] = col2.value[1];
+            p[2] = col2.value[2];
+            p[3] = col2.value[3];
         }
     }
 }
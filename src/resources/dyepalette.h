@@ -78,10 +78,24 @@ class DyePalette final
         void replaceAOGLColor(uint32_t *restrict pixels,
                               const int bufSize) const;
 
+        /**
+         * Returns colors for each intensity packed as 0x00BBGGRR,
+         * or nullptr if palette is empty.
+         */
+        const uint32_t *getLut() const A_WARN_UNUSED
+        { return mColors.empty() ? nullptr : mLut; }
+
         static unsigned int hexDecode(const signed char c) A_WARN_UNUSED;
 
     private:
+        void parse(const std::string &description, const uint8_t blockSize);
+
+        void initLut();
+
         std::vector<DyeColor> mColors;
+
+        /** Precalculated getColor results for each intensity. */
+        uint32_t mLut[256];
 };
 
 #endif  // RESOURCES_DYEPALETTE_H
@@ -26,6 +26,8 @@
 
 #include "logger.h"
 
+#include "render/graphics.h"
+
 #include "resources/imagehelper.h"
 #include "resources/openglimagehelper.h"
 #include "resources/sdlimagehelper.h"
@@ -203,6 +205,13 @@ void Image::unload()
 
     if (mSDLSurface)
     {
+        // surface can be used in postponed draw commands, and its address
+        // can be reused by other surface
+        if (mainGraphics)
+        {
+            mainGraphics->flushCommands();
+            mainGraphics->invalidateScreen();
+        }
         SDLCleanCache();
         // Free the image surface.
         MSDL_FreeSurface(mSDLSurface);
@@ -232,6 +241,34 @@ void Image::unload()
 #endif
 }
 
+int Image::calcMemory() const
+{
+    int sz = 0;
+    if (mSDLSurface)
+    {
+        sz += mSDLSurface->pitch * mSDLSurface->h;
+        if (mAlphaChannel)
+            sz += mSDLSurface->w * mSDLSurface->h;
+    }
+    for (std::map<float, SDL_Surface*>::const_iterator
+         it = mAlphaCache.begin(), it_end = mAlphaCache.end();
+         it != it_end; ++ it)
+    {
+        const SDL_Surface *const surface = (*it).second;
+        if (surface)
+            sz += surface->pitch * surface->h;
+    }
+#ifdef USE_SDL2
+    if (mTexture)
+        sz += mBounds.w * mBounds.h * 4;
+#endif
+#ifdef USE_OPENGL
+    if (mGLImage)
+        sz += mTexWidth * mTexHeight * 4;
+#endif
+    return sz;
+}
+
 bool Image::hasAlphaChannel() const
 {
     if (mLoaded)
@@ -307,6 +344,10 @@ void Image::setAlpha(const float alpha)
             }
         }
 
+        // surface will be changed in place
+        if (!mUseAlphaCache && mainGraphics)
+            mainGraphics->flushCommands();
+
         mAlpha = alpha;
 
         if (!mHasAlphaChannel)
@@ -322,6 +363,8 @@ void Image::setAlpha(const float alpha)
         }
         else
         {
+            if (mainGraphics)
+                mainGraphics->invalidateScreen();
             if (SDL_MUSTLOCK(mSDLSurface))
                 SDL_LockSurface(mSDLSurface);
 
@@ -112,6 +112,8 @@ class Image notfinal : public Resource
          */
         bool hasAlphaChannel() const A_WARN_UNUSED;
 
+        int calcMemory() const override A_WARN_UNUSED;
+
         /**
          * Sets the alpha value of this image.
          */
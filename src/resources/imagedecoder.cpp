@@ -0,0 +1,235 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/imagedecoder.h"
+
+#include "logger.h"
+
+#include "resources/dye.h"
+#include "resources/imagehelper.h"
+
+#include "utils/datapack.h"
+#include "utils/delete2.h"
+#include "utils/physfstools.h"
+#include "utils/sdlhelper.h"
+
+#include "debug.h"
+
+ImageDecoder::ImageDecoder() :
+    mJobs(),
+    mThreads(),
+    mHelper(nullptr),
+    mStartSem(SDL_CreateSemaphore(0)),
+    mDoneSem(SDL_CreateSemaphore(0)),
+    mJobMutex(),
+    mReadMutex(),
+    mNextJob(0),
+    mQuit(false)
+{
+}
+
+ImageDecoder::~ImageDecoder()
+{
+    stopThreads();
+    SDL_DestroySemaphore(mStartSem);
+    SDL_DestroySemaphore(mDoneSem);
+}
+
+void ImageDecoder::setThreads(int threads)
+{
+    if (threads > 16)
+        threads = 16;
+    if (threads < 2)
+        threads = 1;
+    if (static_cast<int>(mThreads.size()) == threads - 1)
+        return;
+
+    stopThreads();
+    mQuit = false;
+    for (int f = 1; f < threads; f ++)
+    {
+        SDL_Thread *const thread = SDL::createThread(
+            &ImageDecoder::workerThread, "imagedecoder", this);
+        if (!thread)
+        {
+            logger->log("Error: image decoder thread creation failed");
+            break;
+        }
+        mThreads.push_back(thread);
+    }
+    logger->log("Image decoder threads: %d",
+        static_cast<int>(mThreads.size()) + 1);
+}
+
+void ImageDecoder::stopThreads()
+{
+    if (mThreads.empty())
+        return;
+
+    mQuit = true;
+    const size_t sz = mThreads.size();
+    for (size_t f = 0; f < sz; f ++)
+        SDL_SemPost(mStartSem);
+    FOR_EACH (std::vector<SDL_Thread*>::iterator, it, mThreads)
+        SDL_WaitThread(*it, nullptr);
+    mThreads.clear();
+}
+
+int ImageDecoder::workerThread(void *ptr)
+{
+    ImageDecoder *const decoder = static_cast<ImageDecoder *const>(ptr);
+    if (!decoder)
+        return 0;
+
+    for (;;)
+    {
+        SDL_SemWait(decoder->mStartSem);
+        if (decoder->mQuit)
+            break;
+        decoder->decodeJobs();
+        SDL_SemPost(decoder->mDoneSem);
+    }
+    return 0;
+}
+
+void ImageDecoder::decode(ImageHelper *const helper,
+                          const StringVect &paths,
+                          std::vector<SDL_Surface*> &surfaces)
+{
+    surfaces.clear();
+    if (!helper || paths.empty())
+        return;
+
+    BLOCK_START("ImageDecoder::decode")
+    mHelper = helper;
+    mJobs.resize(paths.size());
+    const size_t sz = paths.size();
+    for (size_t f = 0; f < sz; f ++)
+    {
+        ImageDecodeJob &job = mJobs[f];
+        const std::string &str = paths[f];
+        const size_t p = str.find('|');
+        job.surface = nullptr;
+        // dye parser can write to log, so it created on main thread
+        if (p != std::string::npos)
+        {
+            job.path = str.substr(0, p);
+            job.dye = new Dye(str.substr(p + 1));
+        }
+        else
+        {
+            job.path = str;
+            job.dye = nullptr;
+        }
+    }
+
+    mNextJob = 0;
+    size_t threads = mThreads.size();
+    if (threads > sz - 1)
+        threads = sz - 1;
+    for (size_t f = 0; f < threads; f ++)
+        SDL_SemPost(mStartSem);
+    decodeJobs();
+    for (size_t f = 0; f < threads; f ++)
+        SDL_SemWait(mDoneSem);
+
+    surfaces.reserve(sz);
+    FOR_EACH (std::vector<ImageDecodeJob>::iterator, it, mJobs)
+    {
+        ImageDecodeJob &job = *it;
+        surfaces.push_back(job.surface);
+        delete2(job.dye);
+    }
+    mJobs.clear();
+    mHelper = nullptr;
+    logger->flush();
+    BLOCK_END("ImageDecoder::decode")
+}
+
+void ImageDecoder::decodeJobs()
+{
+    const size_t sz = mJobs.size();
+    for (;;)
+    {
+        size_t idx;
+        {
+            MutexLocker lock(&mJobMutex);
+            idx = mNextJob ++;
+        }
+        if (idx >= sz)
+            return;
+        decodeJob(mJobs[idx]);
+    }
+}
+
+void ImageDecoder::decodeJob(ImageDecodeJob &job)
+{
+    char *data = nullptr;
+    SDL_RWops *const rw = readFile(job.path, data);
+    if (!rw)
+        return;
+
+    // rw closed by loaders
+    if (job.dye)
+        job.surface = mHelper->loadDyedCached(rw, *job.dye, job.path);
+    else
+        job.surface = ImageHelper::loadPng(rw);
+    delete [] data;
+}
+
+SDL_RWops *ImageDecoder::readFile(const std::string &path, char *&data)
+{
+    int size = 0;
+    {
+        // PhysicsFS handles can not be used from many threads at once
+        MutexLocker lock(&mReadMutex);
+        // data from pack used without copy
+        SDL_RWops *const packRw = DataPack::openRead(path.c_str());
+        if (packRw)
+            return packRw;
+        PHYSFS_file *const file = PhysFs::openRead(path.c_str());
+        if (!file)
+        {
+            logger->log_r("Error, image file not found: %s", path.c_str());
+            return nullptr;
+        }
+        size = static_cast<int>(PHYSFS_fileLength(file));
+        if (size > 0)
+        {
+            data = new char[static_cast<size_t>(size)];
+            if (PHYSFS_read(file, data, 1, size) != size)
+            {
+                delete [] data;
+                data = nullptr;
+            }
+        }
+        PHYSFS_close(file);
+    }
+    if (!data)
+        return nullptr;
+
+    SDL_RWops *const rw = SDL_RWFromMem(data, size);
+    if (!rw)
+    {
+        delete [] data;
+        data = nullptr;
+    }
+    return rw;
+}
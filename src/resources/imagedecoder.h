@@ -0,0 +1,98 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_IMAGEDECODER_H
+#define RESOURCES_IMAGEDECODER_H
+
+#include "utils/mutex.h"
+#include "utils/stringvector.h"
+
+#include <SDL_video.h>
+
+#include <vector>
+
+#include "localconsts.h"
+
+class Dye;
+class ImageHelper;
+
+struct SDL_Thread;
+
+/**
+ * Image what waiting for decoding.
+ */
+struct ImageDecodeJob final
+{
+    std::string path;
+    Dye *dye;
+    SDL_Surface *surface;
+};
+
+/**
+ * Reads, decodes and dyes images on worker threads. Only surfaces returned
+ * to caller, so texture uploads and resources cache stay on main thread.
+ */
+class ImageDecoder final
+{
+    public:
+        ImageDecoder();
+
+        A_DELETE_COPY(ImageDecoder)
+
+        ~ImageDecoder();
+
+        /**
+         * Sets number of threads used for decoding, including main thread.
+         * Values below 2 decode images on main thread.
+         */
+        void setThreads(int threads);
+
+        /**
+         * Decodes images from paths in format "file|dye". Result surfaces
+         * placed in same order as paths, or nullptr for failed images.
+         * Caller must free surfaces.
+         */
+        void decode(ImageHelper *const helper,
+                    const StringVect &paths,
+                    std::vector<SDL_Surface*> &surfaces);
+
+    private:
+        static int SDLCALL workerThread(void *ptr);
+
+        void stopThreads();
+
+        void decodeJobs();
+
+        void decodeJob(ImageDecodeJob &job);
+
+        SDL_RWops *readFile(const std::string &path, char *&data);
+
+        std::vector<ImageDecodeJob> mJobs;
+        std::vector<SDL_Thread*> mThreads;
+        ImageHelper *mHelper;
+        SDL_sem *mStartSem;
+        SDL_sem *mDoneSem;
+        Mutex mJobMutex;
+        Mutex mReadMutex;
+        size_t mNextJob;
+        volatile bool mQuit;
+};
+
+#endif  // RESOURCES_IMAGEDECODER_H
@@ -26,6 +26,7 @@
 #include "main.h"
 
 #include "resources/dye.h"
+#include "resources/dyecache.h"
 #include "resources/dyepalette.h"
 
 #include "utils/sdlcheckutils.h"
@@ -38,6 +39,7 @@ ImageHelper *imageHelper = nullptr;
 ImageHelper *surfaceImageHelper = nullptr;
 
 bool ImageHelper::mEnableAlpha = true;
+bool ImageHelper::mUseDyeCache = false;
 RenderType ImageHelper::mUseOpenGL = RENDER_SOFTWARE;
 
 Image *ImageHelper::load(SDL_RWops *const rw)
@@ -55,14 +57,70 @@ Image *ImageHelper::load(SDL_RWops *const rw)
     return image;
 }
 
-Image *ImageHelper::load(SDL_RWops *const rw, Dye const &dye)
+Image *ImageHelper::load(SDL_RWops *const rw, Dye const &dye,
+                         const std::string &path)
 {
     BLOCK_START("ImageHelper::load")
+    SDL_Surface *const surf = loadDyedCached(rw, dye, path);
+    if (!surf)
+    {
+        BLOCK_END("ImageHelper::load")
+        return nullptr;
+    }
+
+    Image *const image = load(surf);
+    MSDL_FreeSurface(surf);
+    BLOCK_END("ImageHelper::load")
+    return image;
+}
+
+SDL_Surface *ImageHelper::loadDyedCached(SDL_RWops *const rw,
+                                         Dye const &dye,
+                                         const std::string &path)
+{
+    if (!mUseDyeCache)
+        return loadDyed(rw, dye);
+
+    const int size = static_cast<int>(SDL_RWseek(rw, 0, SEEK_END));
+    if (size <= 0)
+    {
+        SDL_RWclose(rw);
+        return nullptr;
+    }
+    SDL_RWseek(rw, 0, SEEK_SET);
+    char *const data = new char[static_cast<size_t>(size)];
+    const bool isRead = static_cast<int>(SDL_RWread(rw, data, 1, size))
+        == size;
+    SDL_RWclose(rw);
+    if (!isRead)
+    {
+        delete [] data;
+        return nullptr;
+    }
+
+    const std::string key = DyeCache::getKey(path, data, size,
+        dye.getDescription(), static_cast<int>(useOpenGL()));
+    SDL_Surface *surf = DyeCache::load(key);
+    if (!surf)
+    {
+        SDL_RWops *const memRw = SDL_RWFromConstMem(data, size);
+        if (memRw)
+        {
+            surf = loadDyed(memRw, dye);
+            if (surf)
+                DyeCache::save(key, surf);
+        }
+    }
+    delete [] data;
+    return surf;
+}
+
+SDL_Surface *ImageHelper::loadDyed(SDL_RWops *const rw, Dye const &dye)
+{
     SDL_Surface *const tmpImage = loadPng(rw);
     if (!tmpImage)
     {
-        logger->log("Error, image load failed: %s", IMG_GetError());
-        BLOCK_END("ImageHelper::load")
+        logger->log_r("Error, image load failed: %s", IMG_GetError());
         return nullptr;
     }
 
@@ -86,6 +144,8 @@ Image *ImageHelper::load(SDL_RWops *const rw, Dye const &dye)
     SDL_Surface *const surf = MSDL_ConvertSurface(
         tmpImage, &rgba, SDL_SWSURFACE);
     MSDL_FreeSurface(tmpImage);
+    if (!surf)
+        return nullptr;
 
     uint32_t *const pixels = static_cast<uint32_t *const>(surf->pixels);
     const int type = dye.getType();
@@ -114,10 +174,7 @@ Image *ImageHelper::load(SDL_RWops *const rw, Dye const &dye)
         }
     }
 
-    Image *const image = load(surf);
-    MSDL_FreeSurface(surf);
-    BLOCK_END("ImageHelper::load")
-    return image;
+    return surf;
 }
 
 SDL_Surface* ImageHelper::convertTo32Bit(SDL_Surface *const tmpImage)
@@ -205,7 +262,7 @@ SDL_Surface *ImageHelper::loadPng(SDL_RWops *const rw)
         return tmpImage;
     }
 
-    logger->log("Error, image is not png");
+    logger->log_r("Error, image is not png");
     SDL_RWclose(rw);
     return nullptr;
 }
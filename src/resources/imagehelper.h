@@ -58,7 +58,29 @@ class ImageHelper notfinal
          */
         Image *load(SDL_RWops *const rw) A_WARN_UNUSED;
 
-        virtual Image *load(SDL_RWops *const rw, Dye const &dye) A_WARN_UNUSED;
+        /**
+         * Loads and dyes image. Path is name of source image, used as part
+         * of dye cache key.
+         */
+        Image *load(SDL_RWops *const rw, Dye const &dye,
+                    const std::string &path) A_WARN_UNUSED;
+
+        /**
+         * Loads an image surface from an SDL_RWops structure and recolors
+         * it. Can be called from worker threads.
+         *
+         * @return <code>NULL</code> if an error occurred, a surface what
+         *         must be freed by caller otherwise.
+         */
+        virtual SDL_Surface *loadDyed(SDL_RWops *const rw,
+                                      Dye const &dye) A_WARN_UNUSED;
+
+        /**
+         * Same as loadDyed, but uses dye disk cache if enabled.
+         */
+        SDL_Surface *loadDyedCached(SDL_RWops *const rw,
+                                    Dye const &dye,
+                                    const std::string &path) A_WARN_UNUSED;
 
 #ifdef __GNUC__
         virtual Image *load(SDL_Surface *const) A_WARN_UNUSED = 0;
@@ -94,6 +116,9 @@ class ImageHelper notfinal
         static void setEnableAlpha(const bool n)
         { mEnableAlpha = n; }
 
+        static void setUseDyeCache(const bool n)
+        { mUseDyeCache = n; }
+
         static SDL_Surface *loadPng(SDL_RWops *const rw);
 
         static void setOpenGlMode(const RenderType useOpenGL)
@@ -110,6 +135,7 @@ class ImageHelper notfinal
         { }
 
         static bool mEnableAlpha;
+        static bool mUseDyeCache;
         static RenderType mUseOpenGL;
 };
 
@@ -24,10 +24,12 @@
 
 #include "resources/spriteaction.h"
 #include "resources/spritedirection.h"
+#include "resources/spritereference.h"
 
 #include "resources/map/mapconsts.h"
 
 #include "resources/db/colordb.h"
+#include "resources/db/dbcache.h"
 #include "resources/db/itemdb.h"
 
 #include "configuration.h"
@@ -386,3 +388,199 @@ std::string ItemInfo::getColor(const int idx) const
         return std::string();
     return it->second.color;
 }
+
+void ItemInfo::writeCache(DbCacheWriter &writer) const
+{
+    writer.writeString(mDisplay.image);
+    writer.writeString(mDisplay.floor);
+    writer.writeInt(static_cast<int>(mDisplay.sprites.size()));
+    FOR_EACH (SpriteRefs, it, mDisplay.sprites)
+    {
+        writer.writeString((*it)->sprite);
+        writer.writeInt((*it)->variant);
+    }
+    writer.writeStrings(mDisplay.particles);
+
+    writer.writeString(mName);
+    writer.writeString(mDescription);
+    writer.writeString(mEffect);
+    writer.writeString(mUseButton);
+    writer.writeString(mUseButton2);
+    writer.writeInt(static_cast<int>(mType));
+    writer.writeInt(mWeight);
+    writer.writeInt(mView);
+    writer.writeInt(mId);
+    writer.writeInt(mIsRemoveSprites);
+
+    for (int f = 0; f < 10; f ++)
+    {
+        const SpriteToItemMap *const spMap = mSpriteToItemReplaceMap[f];
+        if (!spMap)
+        {
+            writer.writeInt(-1);
+            continue;
+        }
+        writer.writeInt(static_cast<int>(spMap->size()));
+        FOR_EACHP (SpriteToItemMapCIter, it, spMap)
+        {
+            writer.writeInt((*it).first);
+            const std::map<int, int> &items = (*it).second;
+            writer.writeInt(static_cast<int>(items.size()));
+            for (std::map<int, int>::const_iterator it2 = items.begin(),
+                 it2_end = items.end(); it2 != it2_end; ++ it2)
+            {
+                writer.writeInt((*it2).first);
+                writer.writeInt((*it2).second);
+            }
+        }
+    }
+
+    writer.writeString(mAttackAction);
+    writer.writeString(mSkyAttackAction);
+    writer.writeString(mWaterAttackAction);
+    writer.writeInt(mAttackRange);
+    writer.writeString(mMissileParticleFile);
+
+    writer.writeInt(static_cast<int>(mAnimationFiles.size()));
+    for (std::map<int, std::string>::const_iterator
+         it = mAnimationFiles.begin(), it_end = mAnimationFiles.end();
+         it != it_end; ++ it)
+    {
+        writer.writeInt((*it).first);
+        writer.writeString((*it).second);
+    }
+
+    writer.writeInt(static_cast<int>(mSounds.size()));
+    for (std::map<ItemSoundEvent::Type, SoundInfoVect>::const_iterator
+         it = mSounds.begin(), it_end = mSounds.end(); it != it_end; ++ it)
+    {
+        writer.writeInt(static_cast<int>((*it).first));
+        const SoundInfoVect &sounds = (*it).second;
+        writer.writeInt(static_cast<int>(sounds.size()));
+        FOR_EACH (SoundInfoVect::const_iterator, it2, sounds)
+        {
+            writer.writeString((*it2).sound);
+            writer.writeInt((*it2).delay);
+        }
+    }
+
+    writer.writeInt(static_cast<int>(mTags.size()));
+    for (std::map<int, int>::const_iterator it = mTags.begin(),
+         it_end = mTags.end(); it != it_end; ++ it)
+    {
+        writer.writeInt((*it).first);
+        writer.writeInt((*it).second);
+    }
+
+    writer.writeString(mColorList);
+    writer.writeInt(mHitEffectId);
+    writer.writeInt(mCriticalHitEffectId);
+    writer.writeInt(mMissEffectId);
+    writer.writeInt(maxFloorOffset);
+    writer.writeInt(static_cast<int>(mPickupCursor));
+    writer.writeInt(mPet);
+    writer.writeInt(mProtected);
+
+    for (int f = 0; f < 10; f ++)
+    {
+        writer.writeInt(mDrawBefore[f]);
+        writer.writeInt(mDrawAfter[f]);
+        writer.writeInt(mDrawPriority[f]);
+    }
+}
+
+void ItemInfo::readCache(DbCacheReader &reader)
+{
+    mDisplay.image = reader.readString();
+    mDisplay.floor = reader.readString();
+    int cnt = reader.readCount(8);
+    for (int f = 0; f < cnt; f ++)
+    {
+        SpriteReference *const sprite = new SpriteReference;
+        sprite->sprite = reader.readString();
+        sprite->variant = reader.readInt();
+        mDisplay.sprites.push_back(sprite);
+    }
+    reader.readStrings(mDisplay.particles);
+
+    mName = reader.readString();
+    mDescription = reader.readString();
+    mEffect = reader.readString();
+    mUseButton = reader.readString();
+    mUseButton2 = reader.readString();
+    mType = static_cast<ItemType::Type>(reader.readInt());
+    mWeight = reader.readInt();
+    mView = reader.readInt();
+    mId = reader.readInt();
+    mIsRemoveSprites = reader.readInt() != 0;
+
+    for (int f = 0; f < 10; f ++)
+    {
+        const int sprites = reader.readInt();
+        if (sprites < 0 || !reader.isValid())
+            continue;
+        // create map even if it empty, because it hide map for up or down
+        SpriteToItemMap *const spMap = new SpriteToItemMap;
+        mSpriteToItemReplaceMap[f] = spMap;
+        mSpriteToItemReplaceList.push_back(spMap);
+        for (int sprite = 0; sprite < sprites; sprite ++)
+        {
+            std::map<int, int> &items = (*spMap)[reader.readInt()];
+            const int items2 = reader.readCount(8);
+            for (int item = 0; item < items2; item ++)
+            {
+                const int from = reader.readInt();
+                items[from] = reader.readInt();
+            }
+        }
+    }
+
+    mAttackAction = reader.readString();
+    mSkyAttackAction = reader.readString();
+    mWaterAttackAction = reader.readString();
+    mAttackRange = reader.readInt();
+    mMissileParticleFile = reader.readString();
+
+    cnt = reader.readCount(8);
+    for (int f = 0; f < cnt; f ++)
+    {
+        const int key = reader.readInt();
+        mAnimationFiles[key] = reader.readString();
+    }
+
+    cnt = reader.readCount(8);
+    for (int f = 0; f < cnt; f ++)
+    {
+        SoundInfoVect &sounds = mSounds[static_cast<ItemSoundEvent::Type>(
+            reader.readInt())];
+        const int sounds2 = reader.readCount(8);
+        for (int sound = 0; sound < sounds2; sound ++)
+        {
+            const std::string name = reader.readString();
+            sounds.push_back(SoundInfo(name, reader.readInt()));
+        }
+    }
+
+    cnt = reader.readCount(8);
+    for (int f = 0; f < cnt; f ++)
+    {
+        const int tag = reader.readInt();
+        mTags[tag] = reader.readInt();
+    }
+
+    setColorsList(reader.readString());
+    mHitEffectId = reader.readInt();
+    mCriticalHitEffectId = reader.readInt();
+    mMissEffectId = reader.readInt();
+    maxFloorOffset = reader.readInt();
+    mPickupCursor = static_cast<Cursor::Cursor>(reader.readInt());
+    mPet = reader.readInt();
+    mProtected = reader.readInt() != 0;
+
+    for (int f = 0; f < 10; f ++)
+    {
+        mDrawBefore[f] = reader.readInt();
+        mDrawAfter[f] = reader.readInt();
+        mDrawPriority[f] = reader.readInt();
+    }
+}
@@ -32,6 +32,9 @@
 
 #include <map>
 
+class DbCacheReader;
+class DbCacheWriter;
+
 namespace ColorDB
 {
     class ItemColor;
@@ -270,6 +273,10 @@ class ItemInfo final
 
         std::string getColor(const int idx) const;
 
+        void writeCache(DbCacheWriter &writer) const;
+
+        void readCache(DbCacheReader &reader);
+
         int mDrawBefore[10];
         int mDrawAfter[10];
         int mDrawPriority[10];
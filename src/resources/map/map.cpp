@@ -59,6 +59,7 @@
 #include "utils/physfstools.h"
 #include "utils/timer.h"
 
+#include <algorithm>
 #include <climits>
 #include <queue>
 
@@ -330,7 +331,7 @@ void Map::draw(Graphics *const graphics, int scrollX, int scrollY)
     // Make sure actors are sorted ascending by Y-coordinate
     // so that they overlap correctly
     BLOCK_START("Map::draw sort")
-        mActors.sort(actorCompare);
+        sortActors();
     BLOCK_END("Map::draw sort")
 
     // update scrolling of all ambient layers
@@ -375,6 +376,9 @@ void Map::draw(Graphics *const graphics, int scrollX, int scrollY)
             mDrawScrollY = scrollY;
             updateFlag = 1;
         }
+        // layers drawn without vertexes while recording trace
+        if (renderTrace)
+            mRedrawMap = true;
     }
 #endif
 
@@ -412,9 +416,9 @@ void Map::draw(Graphics *const graphics, int scrollX, int scrollY)
             else
             {
 #ifdef USE_OPENGL
-                if (mOpenGL == RENDER_NORMAL_OPENGL
+                if ((mOpenGL == RENDER_NORMAL_OPENGL
                     || mOpenGL == RENDER_GLES_OPENGL
-                    || mOpenGL == RENDER_MODERN_OPENGL)
+                    || mOpenGL == RENDER_MODERN_OPENGL) && !renderTrace)
                 {
                     if (updateFlag)
                     {
@@ -706,16 +710,63 @@ const MetaTile *Map::getMetaTile(const int x, const int y) const
     return &mMetaTiles[x + y * mWidth];
 }
 
-Actors::iterator Map::addActor(Actor *const actor)
+void Map::sortActors()
 {
-    mActors.push_front(actor);
+    // insertion sort is fast for actors moved between frames, but after
+    // many actors changed positions full sort is faster
+    const size_t sz = mActors.size();
+    size_t steps = 0;
+    size_t maxSteps = 64;
+    for (size_t f = sz; f; f >>= 1)
+        maxSteps += sz;
+
+    for (size_t f = 1; f < sz; f ++)
+    {
+        Actor *const actor = mActors[f];
+        size_t pos = f;
+        while (pos > 0 && actorCompare(actor, mActors[pos - 1]))
+        {
+            mActors[pos] = mActors[pos - 1];
+            mActors[pos]->mMapIndex = static_cast<int>(pos);
+            pos --;
+            steps ++;
+        }
+        mActors[pos] = actor;
+        actor->mMapIndex = static_cast<int>(pos);
+        if (steps > maxSteps)
+        {
+            std::stable_sort(mActors.begin(), mActors.end(), actorCompare);
+            updateActorIndexes(0);
+            return;
+        }
+    }
+}
+
+void Map::updateActorIndexes(const size_t start)
+{
+    const size_t sz = mActors.size();
+    for (size_t f = start; f < sz; f ++)
+        mActors[f]->mMapIndex = static_cast<int>(f);
+}
+
+void Map::addActor(Actor *const actor)
+{
+    const Actors::iterator it = std::upper_bound(mActors.begin(),
+        mActors.end(), actor, actorCompare);
+    const size_t pos = static_cast<size_t>(it - mActors.begin());
+    mActors.insert(it, actor);
+    updateActorIndexes(pos);
 //    mSpritesUpdated = true;
-    return mActors.begin();
 }
 
-void Map::removeActor(const Actors::iterator &iterator)
+void Map::removeActor(Actor *const actor)
 {
-    mActors.erase(iterator);
+    const size_t pos = static_cast<size_t>(actor->mMapIndex);
+    if (pos >= mActors.size() || mActors[pos] != actor)
+        return;
+    mActors.erase(mActors.begin() + pos);
+    actor->mMapIndex = -1;
+    updateActorIndexes(pos);
 //    mSpritesUpdated = true;
 }
 
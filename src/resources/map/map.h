@@ -333,12 +333,12 @@ class Map final : public Properties, public ConfigListener
         /**
          * Adds an actor to the map.
          */
-        Actors::iterator addActor(Actor *const actor);
+        void addActor(Actor *const actor);
 
         /**
          * Removes an actor from the map.
          */
-        void removeActor(const Actors::iterator &iterator);
+        void removeActor(Actor *const actor);
 
     private:
         enum LayerType
@@ -352,6 +352,14 @@ class Map final : public Properties, public ConfigListener
          */
         void updateAmbientLayers(const float scrollX, const float scrollY);
 
+        /**
+         * Sorts actors by sort pixel y. Actors order changes a little
+         * between frames, so insertion sort is used.
+         */
+        void sortActors();
+
+        void updateActorIndexes(const size_t start);
+
         /**
          * Draws the foreground or background layers to the given graphics output.
          */
@@ -57,6 +57,7 @@ MapLayer::MapLayer(const int x, const int y,
     mSpecialLayer(nullptr),
     mTempLayer(nullptr),
     mTempRows(),
+    mSpareRows(),
     mMask(mask),
     mIsFringeLayer(fringeLayer),
     mHighlightAttackRange(config.getBoolValue("highlightAttackRange"))
@@ -73,6 +74,35 @@ MapLayer::~MapLayer()
     delete [] mTiles;
     delete_all(mTempRows);
     mTempRows.clear();
+    delete_all(mSpareRows);
+    mSpareRows.clear();
+}
+
+void MapLayer::clearTempRows()
+{
+    FOR_EACH (MapRows::iterator, it, mTempRows)
+    {
+        MapRowVertexes *const row = *it;
+        row->clear();
+        mSpareRows.push_back(row);
+    }
+    mTempRows.clear();
+}
+
+MapRowVertexes *MapLayer::getTempRow()
+{
+    MapRowVertexes *row = nullptr;
+    if (mSpareRows.empty())
+    {
+        row = new MapRowVertexes();
+    }
+    else
+    {
+        row = mSpareRows.back();
+        mSpareRows.pop_back();
+    }
+    mTempRows.push_back(row);
+    return row;
 }
 
 void MapLayer::optionChanged(const std::string &value)
@@ -188,8 +218,7 @@ void MapLayer::updateSDL(const Graphics *const graphics,
                          const int debugFlags)
 {
     BLOCK_START("MapLayer::updateSDL")
-    delete_all(mTempRows);
-    mTempRows.clear();
+    clearTempRows();
 
     startX -= mX;
     startY -= mY;
@@ -212,8 +241,7 @@ void MapLayer::updateSDL(const Graphics *const graphics,
 
     for (int y = startY; y < endY; y++)
     {
-        MapRowVertexes *const row = new MapRowVertexes();
-        mTempRows.push_back(row);
+        MapRowVertexes *const row = getTempRow();
 
         const Image *lastImage = nullptr;
         ImageVertexes *imgVert = nullptr;
@@ -233,9 +261,7 @@ void MapLayer::updateSDL(const Graphics *const graphics,
                 {
                     if (lastImage != img)
                     {
-                        imgVert = new ImageVertexes();
-                        imgVert->image = img;
-                        row->images.push_back(imgVert);
+                        imgVert = row->addImage(img);
                         lastImage = img;
                     }
                     graphics->calcTileSDL(imgVert, px, py);
@@ -253,8 +279,7 @@ void MapLayer::updateOGL(Graphics *const graphics,
                          const int debugFlags)
 {
     BLOCK_START("MapLayer::updateOGL")
-    delete_all(mTempRows);
-    mTempRows.clear();
+    clearTempRows();
 
     startX -= mX;
     startY -= mY;
@@ -275,8 +300,7 @@ void MapLayer::updateOGL(Graphics *const graphics,
     const bool flag = (debugFlags != MapType::SPECIAL
         && debugFlags != MapType::SPECIAL2);
 
-    MapRowVertexes *const row = new MapRowVertexes();
-    mTempRows.push_back(row);
+    MapRowVertexes *const row = getTempRow();
     Image *lastImage = nullptr;
     ImageVertexes *imgVert = nullptr;
     typedef std::map<int, ImageVertexes*> ImageVertexesMap;
@@ -310,10 +334,7 @@ void MapLayer::updateOGL(Graphics *const graphics,
                         {
                             if (lastImage)
                                 imgSet[lastImage->mGLImage] = imgVert;
-                            imgVert = new ImageVertexes();
-                            imgVert->ogl.init();
-                            imgVert->image = img;
-                            row->images.push_back(imgVert);
+                            imgVert = row->addImage(img);
                         }
                     }
                     lastImage = img;
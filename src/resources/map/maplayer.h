@@ -138,6 +138,10 @@ class MapLayer final: public ConfigListener
                                     int &width) A_WARN_UNUSED;
 
     private:
+        void clearTempRows();
+
+        MapRowVertexes *getTempRow();
+
         int mX;
         int mY;
         int mWidth;
@@ -147,6 +151,7 @@ class MapLayer final: public ConfigListener
         SpecialLayer *mTempLayer;
         typedef std::vector<MapRowVertexes*> MapRows;
         MapRows mTempRows;
+        MapRows mSpareRows;
         int mMask;
         bool mIsFringeLayer;    /**< Whether the actors are drawn. */
         bool mHighlightAttackRange;
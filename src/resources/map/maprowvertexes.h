@@ -35,7 +35,8 @@ class MapRowVertexes final
 {
     public:
         MapRowVertexes() :
-            images()
+            images(),
+            spare()
         {
             images.reserve(30);
         }
@@ -46,9 +47,40 @@ class MapRowVertexes final
         {
             delete_all(images);
             images.clear();
+            delete_all(spare);
+            spare.clear();
+        }
+
+        /**
+         * Moves all images to spare list. Vertexes memory is kept
+         * for next rebuild.
+         */
+        void clear()
+        {
+            spare.insert(spare.end(), images.begin(), images.end());
+            images.clear();
+        }
+
+        ImageVertexes *addImage(const Image *const image)
+        {
+            ImageVertexes *imgVert = nullptr;
+            if (spare.empty())
+            {
+                imgVert = new ImageVertexes();
+            }
+            else
+            {
+                imgVert = spare.back();
+                spare.pop_back();
+                imgVert->clear();
+            }
+            imgVert->image = image;
+            images.push_back(imgVert);
+            return imgVert;
         }
 
         MapRowImages images;
+        MapRowImages spare;
 };
 
 #endif  // RESOURCES_MAP_MAPROWVERTEXES_H
@@ -341,6 +341,8 @@ Map *MapReader::readMap(XmlNodePtrConst node, const std::string &path)
     BLOCK_END("MapReader::readMap load atlas")
 #endif
 
+    preloadTilesets(node, pathDir);
+
     for_each_xml_child_node(childNode, node)
     {
         if (xmlNameEqual(childNode, "tileset"))
@@ -868,6 +870,35 @@ void MapReader::readLayer(const XmlNodePtr node, Map *const map)
     }
 }
 
+void MapReader::preloadTilesets(const XmlNodePtrConst node,
+                                const std::string &path)
+{
+    BLOCK_START("MapReader::preloadTilesets")
+    StringVect files;
+    for_each_xml_child_node(tilesetNode, node)
+    {
+        // external tile sets loaded in usual way
+        if (!xmlNameEqual(tilesetNode, "tileset")
+            || XmlHasProp(tilesetNode, "source"))
+        {
+            continue;
+        }
+        for_each_xml_child_node(childNode, tilesetNode)
+        {
+            if (xmlNameEqual(childNode, "image"))
+            {
+                const std::string source = XML::getProperty(
+                    childNode, "source", "");
+                if (!source.empty())
+                    files.push_back(resolveRelativePath(path, source));
+                break;
+            }
+        }
+    }
+    ResourceManager::getInstance()->preloadImages(files);
+    BLOCK_END("MapReader::preloadTilesets")
+}
+
 Tileset *MapReader::readTileset(XmlNodePtr node,
                                 const std::string &path,
                                 Map *const map)
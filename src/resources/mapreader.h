@@ -99,6 +99,12 @@ class MapReader final
                                     const std::string &path,
                                     Map *const map) A_WARN_UNUSED;
 
+        /**
+         * Decodes images from embedded tile sets in parallel.
+         */
+        static void preloadTilesets(const XmlNodePtrConst node,
+                                    const std::string &path);
+
         static void updateMusic(Map *const map);
 
         static void addLayerToList(const std::string &fileName);
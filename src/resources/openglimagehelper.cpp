@@ -55,17 +55,19 @@ OpenGLImageHelper::~OpenGLImageHelper()
         &mTextures[mFreeTextureIndex]);
 }
 
-Image *OpenGLImageHelper::load(SDL_RWops *const rw, Dye const &dye)
+SDL_Surface *OpenGLImageHelper::loadDyed(SDL_RWops *const rw, Dye const &dye)
 {
     SDL_Surface *const tmpImage = loadPng(rw);
     if (!tmpImage)
     {
-        logger->log("Error, image load failed: %s", IMG_GetError());
+        logger->log_r("Error, image load failed: %s", IMG_GetError());
         return nullptr;
     }
 
     SDL_Surface *const surf = convertTo32Bit(tmpImage);
     MSDL_FreeSurface(tmpImage);
+    if (!surf)
+        return nullptr;
 
     uint32_t *pixels = static_cast<uint32_t *>(surf->pixels);
     const int type = dye.getType();
@@ -94,9 +96,7 @@ Image *OpenGLImageHelper::load(SDL_RWops *const rw, Dye const &dye)
         }
     }
 
-    Image *const image = load(surf);
-    MSDL_FreeSurface(surf);
-    return image;
+    return surf;
 }
 
 Image *OpenGLImageHelper::load(SDL_Surface *const tmpImage)
@@ -25,6 +25,8 @@
 
 #include "main.h"
 
+#include <SDL_stdinc.h>
+
 #include <ctime>
 #include <string>
 
@@ -45,6 +47,8 @@ class Resource notfinal
             mIdPath(),
             mSource(),
             mTimeStamp(0),
+            mIdHash(0),
+            mMemory(0),
             mRefCount(0),
             mProtected(false),
 #ifdef DEBUG_DUMP_LEAKS
@@ -99,6 +103,13 @@ class Resource notfinal
         void setNotCount(const bool b)
         { mNotCount = b; }
 
+        /**
+         * Returns estimated memory in bytes owned only by this resource,
+         * like surface pixels or texture.
+         */
+        virtual int calcMemory() const A_WARN_UNUSED
+        { return 0; }
+
 #ifdef DEBUG_DUMP_LEAKS
         bool getDumped() const A_WARN_UNUSED
         { return mDumped; }
@@ -118,6 +129,8 @@ class Resource notfinal
 
     private:
         time_t mTimeStamp;   /**< Time at which the resource was orphaned. */
+        uint32_t mIdHash;    /**< Hash of id path in resource manager. */
+        int mMemory;         /**< Memory counted while orphaned. */
         unsigned int mRefCount;  /**< Reference count. */
         bool mProtected;
         bool mNotCount;
@@ -0,0 +1,68 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resources/resourcehandle.h"
+
+#include "listeners/resourcelistener.h"
+
+#include "resources/delayedmanager.h"
+#include "resources/image.h"
+#include "resources/resourcemanager.h"
+#include "resources/spritedef.h"
+
+#include "debug.h"
+
+ResourceHandle::ResourceHandle(const Type type,
+                               const std::string &path,
+                               const int variant,
+                               ResourceListener *const listener) :
+    DelayedLoad(),
+    mPath(path),
+    mListener(listener),
+    mVariant(variant),
+    mType(type)
+{
+}
+
+ResourceHandle::~ResourceHandle()
+{
+    DelayedManager::removeDelayLoad(this);
+}
+
+void ResourceHandle::load()
+{
+    ResourceManager *const resman = ResourceManager::getInstance();
+    Resource *res = nullptr;
+    switch (mType)
+    {
+        case IMAGE:
+            res = resman->getImage(mPath);
+            break;
+        case SPRITE:
+            res = resman->getSprite(mPath, mVariant);
+            break;
+        default:
+            break;
+    }
+    if (mListener)
+        mListener->resourceLoaded(this, res);
+    else if (res)
+        res->decRef();
+}
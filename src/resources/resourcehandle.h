@@ -0,0 +1,70 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESOURCES_RESOURCEHANDLE_H
+#define RESOURCES_RESOURCEHANDLE_H
+
+#include "resources/delayedload.h"
+
+#include <string>
+
+#include "localconsts.h"
+
+class ResourceListener;
+
+/**
+ * Pending async resource request. Handle queued in DelayedManager and
+ * deleted by it after listener got resource. Owner can delete handle
+ * earlier for cancel request.
+ */
+class ResourceHandle final : public DelayedLoad
+{
+    public:
+        enum Type
+        {
+            IMAGE = 0,
+            SPRITE
+        };
+
+        ResourceHandle(const Type type,
+                       const std::string &path,
+                       const int variant,
+                       ResourceListener *const listener);
+
+        A_DELETE_COPY(ResourceHandle)
+
+        ~ResourceHandle();
+
+        void load() override final;
+
+        Type getType() const A_WARN_UNUSED
+        { return mType; }
+
+        const std::string &getPath() const A_WARN_UNUSED
+        { return mPath; }
+
+    private:
+        std::string mPath;
+        ResourceListener *mListener;
+        int mVariant;
+        Type mType;
+};
+
+#endif  // RESOURCES_RESOURCEHANDLE_H
@@ -30,10 +30,14 @@
 
 #include "resources/atlasmanager.h"
 #include "resources/atlasresource.h"
+#include "resources/delayedmanager.h"
 #include "resources/dye.h"
+#include "resources/dyecache.h"
 #include "resources/image.h"
+#include "resources/imagedecoder.h"
 #include "resources/imagehelper.h"
 #include "resources/imageset.h"
+#include "resources/resourcehandle.h"
 #include "resources/sdlmusic.h"
 #include "resources/soundeffect.h"
 #include "resources/spritedef.h"
@@ -42,6 +46,7 @@
 #include "utils/physfscheckutils.h"
 #include "utils/physfsrwops.h"
 #include "utils/sdlcheckutils.h"
+#include "utils/stringutils.h"
 
 #include "render/shaders/shader.h"
 #include "render/shaders/shaderprogram.h"
@@ -49,22 +54,41 @@
 
 #include <SDL_image.h>
 
+#include <algorithm>
+
 #include <sys/time.h>
 
 #include "debug.h"
 
 ResourceManager *ResourceManager::instance = nullptr;
 
+namespace
+{
+    uint64_t getConfigMemoryBudget() A_WARN_UNUSED;
+    uint64_t getConfigMemoryBudget()
+    {
+        const int size = config.getIntValue("resourceCacheSize");
+        if (size <= 0)
+            return 0;
+        return static_cast<uint64_t>(size) * 1024 * 1024;
+    }
+}  // namespace
+
 ResourceManager::ResourceManager() :
     deletedSurfaces(),
     mResources(),
     mOrphanedResources(),
     mDeletedResources(),
+    mImageDecoder(new ImageDecoder),
     mOldestOrphan(0),
+    mOrphanedMemory(0),
+    mMemoryBudget(getConfigMemoryBudget()),
     mDestruction(0),
     mUseLongLiveSprites(config.getBoolValue("uselonglivesprites"))
 {
     logger->log1("Initializing resource manager...");
+    DyeCache::setLimit(static_cast<uint64_t>(std::max(0,
+        config.getIntValue("dyeCacheSize"))) * 1024 * 1024);
 }
 
 ResourceManager::~ResourceManager()
@@ -164,6 +188,8 @@ ResourceManager::~ResourceManager()
     }
     clearDeleted();
     clearScheduled();
+    delete2(mImageDecoder);
+    DyeCache::clear();
 }
 
 void ResourceManager::cleanUp(Resource *const res)
@@ -209,18 +235,77 @@ void ResourceManager::cleanProtected()
     }
 }
 
+ResourceManager::ResourceKey::ResourceKey(const std::string &path0) :
+    path(),
+    pathRef(&path0),
+    hash(hashString(path0))
+{
+}
+
+void ResourceManager::eraseOrphan(const ResourceIterator &iter)
+{
+    Resource *const res = iter->second;
+    if (res)
+    {
+        mOrphanedMemory -= res->mMemory;
+        res->mMemory = 0;
+    }
+    mOrphanedResources.erase(iter);
+}
+
+bool ResourceManager::evictOrphans()
+{
+    if (mOrphanedMemory <= mMemoryBudget)
+        return false;
+
+    // least recently released first
+    std::vector<std::pair<time_t, ResourceKey> > keys;
+    keys.reserve(mOrphanedResources.size());
+    FOR_EACH (ResourceCIterator, it, mOrphanedResources)
+    {
+        const Resource *const res = it->second;
+        if (res && res->mMemory > 0)
+            keys.push_back(std::make_pair(res->mTimeStamp, it->first));
+    }
+    std::sort(keys.begin(), keys.end());
+
+    bool status(false);
+    const size_t sz = keys.size();
+    for (size_t f = 0; f < sz && mOrphanedMemory > mMemoryBudget; f ++)
+    {
+        // deleting previous resources can change orphans list
+        const ResourceIterator iter = mOrphanedResources.find(keys[f].second);
+        if (iter == mOrphanedResources.end())
+            continue;
+        Resource *const res = iter->second;
+        if (!res)
+            continue;
+        logResource(res);
+        eraseOrphan(iter);
+        delete res;
+        status = true;
+    }
+    return status;
+}
+
 bool ResourceManager::cleanOrphans(const bool always)
 {
+    if (mOrphanedResources.empty())
+        return false;
+
+    mMemoryBudget = getConfigMemoryBudget();
+    bool status = evictOrphans();
+
     timeval tv;
     gettimeofday(&tv, nullptr);
-    // Delete orphaned resources after 30 seconds.
+    // Delete orphaned resources after 5 minutes.
+    // Most of them removed before by memory budget.
     time_t oldest = static_cast<time_t>(tv.tv_sec);
-    const time_t threshold = oldest - 30;
+    const time_t threshold = oldest - 300;
 
     if (mOrphanedResources.empty() || (!always && mOldestOrphan >= threshold))
-        return false;
+        return status;
 
-    bool status(false);
     ResourceIterator iter = mOrphanedResources.begin();
     while (iter != mOrphanedResources.end())
     {
@@ -242,7 +327,7 @@ bool ResourceManager::cleanOrphans(const bool always)
             logResource(res);
             const ResourceIterator toErase = iter;
             ++iter;
-            mOrphanedResources.erase(toErase);
+            eraseOrphan(toErase);
             delete res;  // delete only after removal from list,
                          // to avoid issues in recursion
             status = true;
@@ -400,7 +485,9 @@ bool ResourceManager::addResource(const std::string &idPath,
         logger->log("set name %p, %s", static_cast<void*>(resource),
             resource->mIdPath.c_str());
 #endif
-        mResources[idPath] = resource;
+        const ResourceKey key(idPath);
+        resource->mIdHash = key.hash;
+        mResources[key] = resource;
         return true;
     }
     return false;
@@ -416,13 +503,13 @@ Resource *ResourceManager::getFromCache(const std::string &filename,
 
 bool ResourceManager::isInCache(const std::string &idPath) const
 {
-    const ResourceCIterator &resIter = mResources.find(idPath);
+    const ResourceCIterator &resIter = mResources.find(ResourceKey(idPath));
     return (resIter != mResources.end() && resIter->second);
 }
 
 Resource *ResourceManager::getTempResource(const std::string &idPath)
 {
-    const ResourceCIterator &resIter = mResources.find(idPath);
+    const ResourceCIterator &resIter = mResources.find(ResourceKey(idPath));
     if (resIter != mResources.end())
     {
         Resource *const res = resIter->second;
@@ -435,7 +522,8 @@ Resource *ResourceManager::getTempResource(const std::string &idPath)
 Resource *ResourceManager::getFromCache(const std::string &idPath)
 {
     // Check if the id exists, and return the value if it does.
-    ResourceIterator resIter = mResources.find(idPath);
+    const ResourceKey key(idPath);
+    ResourceIterator resIter = mResources.find(key);
     if (resIter != mResources.end())
     {
         if (resIter->second)
@@ -443,12 +531,12 @@ Resource *ResourceManager::getFromCache(const std::string &idPath)
         return resIter->second;
     }
 
-    resIter = mOrphanedResources.find(idPath);
+    resIter = mOrphanedResources.find(key);
     if (resIter != mOrphanedResources.end())
     {
         Resource *const res = resIter->second;
         mResources.insert(*resIter);
-        mOrphanedResources.erase(resIter);
+        eraseOrphan(resIter);
         if (res)
             res->incRef();
         return res;
@@ -473,7 +561,9 @@ Resource *ResourceManager::get(const std::string &idPath, const generator fun,
         logger->log("set name %p, %s", static_cast<void*>(resource),
             resource->mIdPath.c_str());
 #endif
-        mResources[idPath] = resource;
+        const ResourceKey key(idPath);
+        resource->mIdHash = key.hash;
+        mResources[key] = resource;
         cleanOrphans();
     }
     else
@@ -566,7 +656,7 @@ struct DyedImageLoader final
             delete d;
             return nullptr;
         }
-        Resource *const res = d ? imageHelper->load(rw, *d)
+        Resource *const res = d ? imageHelper->load(rw, *d, path1)
             : imageHelper->load(rw);
         delete d;
         return res;
@@ -579,6 +669,68 @@ Image *ResourceManager::getImage(const std::string &idPath)
     return static_cast<Image*>(get(idPath, &DyedImageLoader::load, &rl));
 }
 
+Image *ResourceManager::getImageAsync(const std::string &idPath,
+                                      ResourceListener *const listener,
+                                      ResourceHandle *&handle)
+{
+    handle = nullptr;
+    Resource *const res = getFromCache(idPath);
+    if (res)
+        return static_cast<Image*>(res);
+    handle = new ResourceHandle(ResourceHandle::IMAGE,
+        idPath, 0, listener);
+    DelayedManager::addDelayedLoad(handle);
+    return nullptr;
+}
+
+ImageDecoder *ResourceManager::getImageDecoder()
+{
+    mImageDecoder->setThreads(config.getIntValue("imageDecodeThreads"));
+    return mImageDecoder;
+}
+
+void ResourceManager::preloadImages(const StringVect &paths)
+{
+#ifndef DISABLE_RESOURCE_CACHING
+    std::set<std::string> added;
+    StringVect files;
+    FOR_EACH (StringVectCIter, it, paths)
+    {
+        const std::string &path = *it;
+        const ResourceKey key(path);
+        if (mResources.find(key) == mResources.end()
+            && mOrphanedResources.find(key) == mOrphanedResources.end()
+            && added.insert(path).second)
+        {
+            files.push_back(path);
+        }
+    }
+    // single image faster to load in usual way
+    if (files.size() < 2)
+        return;
+
+    BLOCK_START("ResourceManager::preloadImages")
+    std::vector<SDL_Surface*> surfaces;
+    getImageDecoder()->decode(imageHelper, files, surfaces);
+    const size_t sz = surfaces.size();
+    for (size_t f = 0; f < sz; f ++)
+    {
+        SDL_Surface *const surface = surfaces[f];
+        if (!surface)
+            continue;
+        // texture upload must be done in main thread
+        Image *const image = imageHelper->load(surface);
+        MSDL_FreeSurface(surface);
+        if (!image)
+            continue;
+        // keep image in orphans until someone request it
+        addResource(files[f], image);
+        image->decRef();
+    }
+    BLOCK_END("ResourceManager::preloadImages")
+#endif
+}
+
 struct ImageSetLoader final
 {
     ResourceManager *manager;
@@ -612,7 +764,6 @@ ImageSet *ResourceManager::getImageSet(const std::string &imagePath,
     return static_cast<ImageSet*>(get(ss.str(), &ImageSetLoader::load, &rl));
 }
 
-
 struct SubImageSetLoader final
 {
     ResourceManager *manager;
@@ -811,6 +962,21 @@ SpriteDef *ResourceManager::getSprite(const std::string &path,
     return static_cast<SpriteDef*>(get(ss.str(), &SpriteDefLoader::load, &rl));
 }
 
+SpriteDef *ResourceManager::getSpriteAsync(const std::string &path,
+                                           const int variant,
+                                           ResourceListener *const listener,
+                                           ResourceHandle *&handle)
+{
+    handle = nullptr;
+    Resource *const res = getFromCache(path, variant);
+    if (res)
+        return static_cast<SpriteDef*>(res);
+    handle = new ResourceHandle(ResourceHandle::SPRITE,
+        path, variant, listener);
+    DelayedManager::addDelayedLoad(handle);
+    return nullptr;
+}
+
 void ResourceManager::release(Resource *const res)
 {
     if (!res || mDestruction)
@@ -826,7 +992,8 @@ void ResourceManager::release(Resource *const res)
         return;
     }
 
-    ResourceIterator resIter = mResources.find(res->mIdPath);
+    ResourceIterator resIter = mResources.find(
+        ResourceKey(res->mIdPath, res->mIdHash));
 
     if (resIter == mResources.end())
     {
@@ -846,6 +1013,8 @@ void ResourceManager::release(Resource *const res)
     const time_t timestamp = static_cast<time_t>(tv.tv_sec);
 
     res->mTimeStamp = timestamp;
+    res->mMemory = res->calcMemory();
+    mOrphanedMemory += res->mMemory;
     if (mOrphanedResources.empty())
         mOldestOrphan = timestamp;
 
@@ -866,7 +1035,8 @@ void ResourceManager::moveToDeleted(Resource *const res)
     if (count == 1)
         logResource(res);
     res->decRef();
-    ResourceIterator resIter = mResources.find(res->mIdPath);
+    const ResourceKey key(res->mIdPath, res->mIdHash);
+    ResourceIterator resIter = mResources.find(key);
     if (resIter != mResources.end() && resIter->second == res)
     {
         mResources.erase(resIter);
@@ -874,10 +1044,10 @@ void ResourceManager::moveToDeleted(Resource *const res)
     }
     else
     {
-        resIter = mOrphanedResources.find(res->mIdPath);
+        resIter = mOrphanedResources.find(key);
         if (resIter != mOrphanedResources.end() && resIter->second == res)
         {
-            mOrphanedResources.erase(resIter);
+            eraseOrphan(resIter);
             found = true;
         }
     }
@@ -900,16 +1070,17 @@ void ResourceManager::decRefDelete(Resource *const res)
     {
         logResource(res);
 
-        ResourceIterator resIter = mResources.find(res->mIdPath);
+        const ResourceKey key(res->mIdPath, res->mIdHash);
+        ResourceIterator resIter = mResources.find(key);
         if (resIter != mResources.end() && resIter->second == res)
         {
             mResources.erase(resIter);
         }
         else
         {
-            resIter = mOrphanedResources.find(res->mIdPath);
+            resIter = mOrphanedResources.find(key);
             if (resIter != mOrphanedResources.end() && resIter->second == res)
-                mOrphanedResources.erase(resIter);
+                eraseOrphan(resIter);
         }
 
         delete res;
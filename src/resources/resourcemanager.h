@@ -27,6 +27,8 @@
 
 #include "utils/stringvector.h"
 
+#include <SDL_stdinc.h>
+
 #include <ctime>
 #include <map>
 #include <set>
@@ -34,10 +36,13 @@
 #include "localconsts.h"
 
 class Image;
+class ImageDecoder;
 class ImageSet;
 class Map;
 class SDLMusic;
 class Resource;
+class ResourceHandle;
+class ResourceListener;
 class SoundEffect;
 class SpriteDef;
 class WalkLayer;
@@ -146,6 +151,22 @@ class ResourceManager final
          */
         Image *getImage(const std::string &idPath) A_WARN_UNUSED;
 
+        /**
+         * Decodes not loaded images in parallel and keeps them in cache
+         * for next getImage calls.
+         */
+        void preloadImages(const StringVect &paths);
+
+        ImageDecoder *getImageDecoder() A_WARN_UNUSED;
+
+        /**
+         * Returns image if it already in cache. Otherwise returns nullptr
+         * and handle of delayed request, what will pass image to listener.
+         */
+        Image *getImageAsync(const std::string &idPath,
+                             ResourceListener *const listener,
+                             ResourceHandle *&handle) A_WARN_UNUSED;
+
         /**
          * Convenience wrapper around ResourceManager::get for loading
          * songs.
@@ -192,6 +213,11 @@ class ResourceManager final
         SpriteDef *getSprite(const std::string &path,
                              const int variant = 0) A_WARN_UNUSED;
 
+        SpriteDef *getSpriteAsync(const std::string &path,
+                                  const int variant,
+                                  ResourceListener *const listener,
+                                  ResourceHandle *&handle) A_WARN_UNUSED;
+
         /**
          * Releases a resource, placing it in the set of orphaned resources.
          */
@@ -237,7 +263,57 @@ class ResourceManager final
         int size() const A_WARN_UNUSED
         { return static_cast<int>(mResources.size()); }
 
-        typedef std::map<std::string, Resource*> Resources;
+        /**
+         * Cache key. Ordered by path hash first, so most lookups compare
+         * single integers instead of long id paths.
+         * Key created from path only refer to it, and used for lookups.
+         * Copies always own path, so keys stored in maps stay valid.
+         */
+        struct ResourceKey final
+        {
+            explicit ResourceKey(const std::string &path0);
+
+            ResourceKey(const std::string &path0, const uint32_t hash0) :
+                path(path0),
+                pathRef(nullptr),
+                hash(hash0)
+            {
+            }
+
+            ResourceKey(const ResourceKey &key) :
+                path(key.getPath()),
+                pathRef(nullptr),
+                hash(key.hash)
+            {
+            }
+
+            ResourceKey &operator=(const ResourceKey &key)
+            {
+                if (this != &key)
+                {
+                    path = key.getPath();
+                    pathRef = nullptr;
+                    hash = key.hash;
+                }
+                return *this;
+            }
+
+            const std::string &getPath() const A_WARN_UNUSED
+            { return pathRef ? *pathRef : path; }
+
+            bool operator<(const ResourceKey &key) const
+            {
+                if (hash != key.hash)
+                    return hash < key.hash;
+                return getPath() < key.getPath();
+            }
+
+            std::string path;
+            const std::string *pathRef;
+            uint32_t hash;
+        };
+
+        typedef std::map<ResourceKey, Resource*> Resources;
         typedef Resources::iterator ResourceIterator;
         typedef Resources::const_iterator ResourceCIterator;
 
@@ -249,8 +325,20 @@ class ResourceManager final
         { return &mOrphanedResources; }
 #endif
 
+        const Resources* getResources() const A_WARN_UNUSED
+        { return &mResources; }
+
+        const Resources* getOrphanedResources() const A_WARN_UNUSED
+        { return &mOrphanedResources; }
+
         bool cleanOrphans(const bool always = false);
 
+        uint64_t getOrphanedMemory() const A_WARN_UNUSED
+        { return mOrphanedMemory; }
+
+        uint64_t getMemoryBudget() const A_WARN_UNUSED
+        { return mMemoryBudget; }
+
         void cleanProtected();
 
         bool isInCache(const std::string &idPath) const A_WARN_UNUSED;
@@ -265,12 +353,19 @@ class ResourceManager final
          */
         static void cleanUp(Resource *const resource);
 
+        void eraseOrphan(const ResourceIterator &iter);
+
+        bool evictOrphans();
+
         static ResourceManager *instance;
         std::set<SDL_Surface*> deletedSurfaces;
         Resources mResources;
         Resources mOrphanedResources;
         std::set<Resource*> mDeletedResources;
+        ImageDecoder *mImageDecoder;
         time_t mOldestOrphan;
+        uint64_t mOrphanedMemory;
+        uint64_t mMemoryBudget;
         bool mDestruction;
         bool mUseLongLiveSprites;
 };
@@ -40,12 +40,12 @@
 
 bool SDLImageHelper::mEnableAlphaCache = false;
 
-Image *SDLImageHelper::load(SDL_RWops *const rw, Dye const &dye)
+SDL_Surface *SDLImageHelper::loadDyed(SDL_RWops *const rw, Dye const &dye)
 {
     SDL_Surface *const tmpImage = loadPng(rw);
     if (!tmpImage)
     {
-        logger->log("Error, image load failed: %s", IMG_GetError());
+        logger->log_r("Error, image load failed: %s", IMG_GetError());
         return nullptr;
     }
 
@@ -71,6 +71,8 @@ Image *SDLImageHelper::load(SDL_RWops *const rw, Dye const &dye)
     SDL_Surface *const surf = MSDL_ConvertSurface(
         tmpImage, &rgba, SDL_SWSURFACE);
     MSDL_FreeSurface(tmpImage);
+    if (!surf)
+        return nullptr;
 
     uint32_t *pixels = static_cast<uint32_t *>(surf->pixels);
     const int type = dye.getType();
@@ -99,9 +101,7 @@ Image *SDLImageHelper::load(SDL_RWops *const rw, Dye const &dye)
         }
     }
 
-    Image *const image = load(surf);
-    MSDL_FreeSurface(surf);
-    return image;
+    return surf;
 }
 
 Image *SDLImageHelper::load(SDL_Surface *const tmpImage)
@@ -53,7 +53,8 @@ class SDLImageHelper final : public ImageHelper
         { }
 
         /**
-         * Loads an image from an SDL_RWops structure and recolors it.
+         * Loads an image surface from an SDL_RWops structure and recolors
+         * it.
          *
          * @param rw         The SDL_RWops to load the image from.
          * @param dye        The dye used to recolor the image.
@@ -61,8 +62,8 @@ class SDLImageHelper final : public ImageHelper
          * @return <code>NULL</code> if an error occurred, a valid pointer
          *         otherwise.
          */
-        Image *load(SDL_RWops *const rw,
-                    Dye const &dye) override final A_WARN_UNUSED;
+        SDL_Surface *loadDyed(SDL_RWops *const rw,
+                              Dye const &dye) override final A_WARN_UNUSED;
 
         /**
          * Loads an image from an SDL surface.
@@ -65,6 +65,9 @@ class SoundEffect final : public Resource
         bool play(const int loops, const int volume,
                   const int channel = -1) const;
 
+        int calcMemory() const override final A_WARN_UNUSED
+        { return mChunk ? static_cast<int>(mChunk->alen) : 0; }
+
     protected:
         /**
          * Constructor.
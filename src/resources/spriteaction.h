@@ -65,4 +65,39 @@ namespace SpriteAction
     static const std::string INVALID("");
 }  // namespace SpriteAction
 
+/*
+ * Interned ids of SpriteAction names, see SpriteDef::getActionId.
+ */
+namespace SpriteActionId
+{
+    enum Type
+    {
+        INVALID = -1,
+        STAND = 0,
+        SIT,
+        SITTOP,
+        SLEEP,
+        DEAD,
+        MOVE,
+        ATTACK,
+        HURT,
+        USE_SPECIAL,
+        CAST_MAGIC,
+        USE_ITEM,
+        SPAWN,
+        FLY,
+        SWIM,
+        STANDSKY,
+        STANDWATER,
+        SITSKY,
+        SITWATER,
+        ATTACKSKY,
+        ATTACKWATER,
+        SPAWNSKY,
+        SPAWNWATER,
+        DEADSKY,
+        DEADWATER
+    };
+}  // namespace SpriteActionId
+
 #endif  // RESOURCES_SPRITEACTION_H
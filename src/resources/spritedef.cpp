@@ -41,8 +41,95 @@
 SpriteReference *SpriteReference::Empty = nullptr;
 extern int serverVersion;
 
+namespace
+{
+    std::map<std::string, int> mActionIds;
+    StringVect mActionNames;
+
+    // same order as in SpriteActionId
+    void addDefaultActions()
+    {
+        const std::string *const names[] =
+        {
+            &SpriteAction::STAND,
+            &SpriteAction::SIT,
+            &SpriteAction::SITTOP,
+            &SpriteAction::SLEEP,
+            &SpriteAction::DEAD,
+            &SpriteAction::MOVE,
+            &SpriteAction::ATTACK,
+            &SpriteAction::HURT,
+            &SpriteAction::USE_SPECIAL,
+            &SpriteAction::CAST_MAGIC,
+            &SpriteAction::USE_ITEM,
+            &SpriteAction::SPAWN,
+            &SpriteAction::FLY,
+            &SpriteAction::SWIM,
+            &SpriteAction::STANDSKY,
+            &SpriteAction::STANDWATER,
+            &SpriteAction::SITSKY,
+            &SpriteAction::SITWATER,
+            &SpriteAction::ATTACKSKY,
+            &SpriteAction::ATTACKWATER,
+            &SpriteAction::SPAWNSKY,
+            &SpriteAction::SPAWNWATER,
+            &SpriteAction::DEADSKY,
+            &SpriteAction::DEADWATER
+        };
+        const size_t sz = sizeof(names) / sizeof(names[0]);
+        for (size_t f = 0; f < sz; f ++)
+        {
+            mActionIds[*names[f]] = static_cast<int>(f);
+            mActionNames.push_back(*names[f]);
+        }
+    }
+}  // namespace
+
+int SpriteDef::getActionId(const std::string &action)
+{
+    if (mActionNames.empty())
+        addDefaultActions();
+
+    const std::map<std::string, int>::const_iterator it
+        = mActionIds.find(action);
+    if (it != mActionIds.end())
+        return (*it).second;
+
+    const int id = static_cast<int>(mActionNames.size());
+    mActionIds[action] = id;
+    mActionNames.push_back(action);
+    return id;
+}
+
+const std::string &SpriteDef::getActionName(const int actionId)
+{
+    static const std::string empty;
+    if (mActionNames.empty())
+        addDefaultActions();
+    if (actionId < 0 || static_cast<size_t>(actionId) >= mActionNames.size())
+        return empty;
+    return mActionNames[static_cast<size_t>(actionId)];
+}
+
+Action *SpriteDef::findAction(const ActionMap *const actMap,
+                              const int actionId)
+{
+    if (!actMap || actionId < 0
+        || static_cast<size_t>(actionId) >= actMap->size())
+    {
+        return nullptr;
+    }
+    return (*actMap)[static_cast<size_t>(actionId)];
+}
+
 const Action *SpriteDef::getAction(const std::string &action,
                                    const unsigned num) const
+{
+    return getAction(getActionId(action), num);
+}
+
+const Action *SpriteDef::getAction(const int actionId,
+                                   const unsigned num) const
 {
     Actions::const_iterator i = mActions.find(num);
     if (i == mActions.end() && num != 100)
@@ -51,18 +138,15 @@ const Action *SpriteDef::getAction(const std::string &action,
     if (i == mActions.end() || !(*i).second)
         return nullptr;
 
-    const ActionMap *const actMap = (*i).second;
-    if (!actMap)
-        return nullptr;
-    const ActionMap::const_iterator it = actMap->find(action);
-
-    if (it == actMap->end())
+    const Action *const action = findAction((*i).second, actionId);
+    if (!action)
     {
-        logger->log("Warning: no action \"%s\" defined!", action.c_str());
+        logger->log("Warning: no action \"%s\" defined!",
+            getActionName(actionId).c_str());
         return nullptr;
     }
 
-    return (*it).second;
+    return action;
 }
 
 unsigned SpriteDef::findNumber(const unsigned num) const
@@ -120,31 +204,27 @@ void SpriteDef::fixDeadAction()
 {
     FOR_EACH (ActionsIter, it, mActions)
     {
-        ActionMap *const d = (*it).second;
-        if (!d)
-            continue;
-        const ActionMap::iterator i = d->find(SpriteAction::DEAD);
-        const ActionMap::iterator i2 = d->find(SpriteAction::STAND);
+        const ActionMap *const d = (*it).second;
+        Action *const dead = findAction(d, SpriteActionId::DEAD);
         // search dead action and check what it not same with stand action
-        if (i != d->end() && i->second && i->second != i2->second)
-            (i->second)->setLastFrameDelay(0);
+        if (dead && dead != findAction(d, SpriteActionId::STAND))
+            dead->setLastFrameDelay(0);
     }
 }
 
 void SpriteDef::substituteAction(const std::string &restrict complete,
                                  const std::string &restrict with)
 {
+    const int completeId = getActionId(complete);
+    const int withId = getActionId(with);
     FOR_EACH (ActionsConstIter, it, mActions)
     {
-        ActionMap *const d = (*it).second;
-        if (!d)
+        const ActionMap *const d = (*it).second;
+        if (!d || findAction(d, completeId))
             continue;
-        if (d->find(complete) == d->end())
-        {
-            const ActionMap::iterator i = d->find(with);
-            if (i != d->end())
-                (*d)[complete] = i->second;
-        }
+        Action *const action = findAction(d, withId);
+        if (action)
+            addAction((*it).first, complete, action);
     }
 }
 
@@ -260,7 +340,13 @@ void SpriteDef::loadAction(const XmlNodePtr node,
 
     // When first action set it as default direction
     const Actions::const_iterator i = mActions.find(hp);
-    if ((*i).second->size() == 1)
+    int cnt = 0;
+    FOR_EACHP (ActionMap::const_iterator, it, (*i).second)
+    {
+        if (*it)
+            cnt ++;
+    }
+    if (cnt == 1)
         addAction(hp, SpriteAction::DEFAULT, action);
 
     // Load animations
@@ -443,7 +529,10 @@ SpriteDef::~SpriteDef()
     FOR_EACH (Actions::iterator, i, mActions)
     {
         FOR_EACHP (ActionMap::iterator, it, (*i).second)
-            actions.insert(it->second);
+        {
+            if (*it)
+                actions.insert(*it);
+        }
         delete (*i).second;
     }
 
@@ -495,7 +584,11 @@ void SpriteDef::addAction(const unsigned hp, const std::string &name,
     if (i == mActions.end())
         mActions[hp] = new ActionMap();
 
-    (*mActions[hp])[name] = action;
+    ActionMap *const actMap = mActions[hp];
+    const size_t id = static_cast<size_t>(getActionId(name));
+    if (id >= actMap->size())
+        actMap->resize(id + 1, nullptr);
+    (*actMap)[id] = action;
 }
 
 bool SpriteDef::addSequence(const int start,
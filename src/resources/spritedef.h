@@ -31,6 +31,7 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 class Action;
 class Animation;
@@ -57,6 +58,23 @@ class SpriteDef final : public Resource
         const Action *getAction(const std::string &action,
                                 const unsigned num) const A_WARN_UNUSED;
 
+        /**
+         * Returns the specified action by interned action id.
+         */
+        const Action *getAction(const int actionId,
+                                const unsigned num) const A_WARN_UNUSED;
+
+        /**
+         * Returns interned id for action name. Unknown names get new id.
+         */
+        static int getActionId(const std::string &action) A_WARN_UNUSED;
+
+        /**
+         * Returns action name for interned action id.
+         */
+        static const std::string &getActionName(const int actionId)
+                                                A_WARN_UNUSED;
+
         unsigned findNumber(const unsigned num) const A_WARN_UNUSED;
 
         /**
@@ -144,9 +162,13 @@ class SpriteDef final : public Resource
         void substituteAction(const std::string &restrict complete,
                               const std::string &restrict with);
 
+        typedef std::vector<Action*> ActionMap;
+
+        static Action *findAction(const ActionMap *const actMap,
+                                  const int actionId) A_WARN_UNUSED;
+
         typedef std::map<std::string, ImageSet*> ImageSets;
         typedef ImageSets::iterator ImageSetIterator;
-        typedef std::map<std::string, Action*> ActionMap;
         typedef std::map<unsigned, ActionMap*> Actions;
         typedef Actions::const_iterator ActionsConstIter;
         typedef Actions::iterator ActionsIter;
@@ -83,6 +83,12 @@ class SubImage final : public Image
         void decRef() override final;
 #endif
 
+        /**
+         * Pixels owned by parent image.
+         */
+        int calcMemory() const override final A_WARN_UNUSED
+        { return 0; }
+
         SDL_Rect mInternalBounds;
 
     private:
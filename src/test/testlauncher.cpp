@@ -22,18 +22,27 @@
 
 #ifdef USE_OPENGL
 
+#include "actormanager.h"
 #include "graphicsmanager.h"
 #include "graphicsvertexes.h"
 #include "settings.h"
 #include "soundmanager.h"
+#include "text.h"
 
 #include "gui/skin.h"
 #include "gui/theme.h"
 
+#include "being/being.h"
+
 #include "gui/fonts/font.h"
 
+#include "utils/cpu.h"
+#include "utils/delete2.h"
 #include "utils/physfscheckutils.h"
 #include "utils/physfsrwops.h"
+#include "utils/stringutils.h"
+
+#include "render/rendertrace.h"
 
 #include "resources/dye.h"
 #include "resources/image.h"
@@ -42,7 +51,11 @@
 #include "resources/surfaceimagehelper.h"
 #include "resources/wallpaper.h"
 
+#include "resources/map/map.h"
+
+#include <set>
 #include <unistd.h>
+#include <vector>
 
 #ifdef WIN32
 #include <windows.h>
@@ -94,6 +107,16 @@ int TestLauncher::exec()
         return testFps2();
     else if (mTest == "104")
         return testFps3();
+    else if (mTest == "105")
+        return testTrace();
+    else if (mTest == "106")
+        return testRebuild();
+    else if (mTest == "107")
+        return testPlacement();
+    else if (mTest == "108")
+        return testPackets();
+    else if (mTest == "109")
+        return testPick();
 
     return -1;
 }
@@ -268,6 +291,332 @@ int TestLauncher::testFps3()
     return 0;
 }
 
+int TestLauncher::testTrace()
+{
+    timeval start;
+    timeval end;
+    timeval frameStart;
+    timeval frameEnd;
+
+    RenderTracePlayer *const player = new RenderTracePlayer;
+    if (!player->load(settings.localDataDir + "/rendertrace.bin")
+        || !player->getFramesCount())
+    {
+        delete player;
+        return 1;
+    }
+
+    // first pass loads images
+    while (player->drawFrame(mainGraphics))
+        mainGraphics->updateScreen();
+    player->rewind();
+
+    const int cnt = player->getFramesCount();
+    long minTime = 0;
+    long maxTime = 0;
+
+    file << mTest << std::endl;
+    gettimeofday(&start, nullptr);
+    for (int k = 0; k < cnt; k ++)
+    {
+        gettimeofday(&frameStart, nullptr);
+        player->drawFrame(mainGraphics);
+        mainGraphics->updateScreen();
+        gettimeofday(&frameEnd, nullptr);
+        const long frameTime = (frameEnd.tv_sec - frameStart.tv_sec)
+            * 1000000 + frameEnd.tv_usec - frameStart.tv_usec;
+        if (!k || frameTime < minTime)
+            minTime = frameTime;
+        if (frameTime > maxTime)
+            maxTime = frameTime;
+        file << frameTime << std::endl;
+    }
+    gettimeofday(&end, nullptr);
+    delete player;
+
+    const int tFps = calcFps(&start, &end, cnt);
+    file << tFps << std::endl;
+
+    printf("frames: %d, fps: %d, min: %ld us, max: %ld us\n",
+        cnt, tFps, minTime, maxTime);
+    sleep(1);
+    return 0;
+}
+
+static void collectArrays(const ImageVertexes *const vert,
+                          std::set<const void*> &arrays)
+{
+    arrays.clear();
+    if (!vert->sdl.empty())
+        arrays.insert(&vert->sdl[0]);
+#ifdef USE_OPENGL
+    const OpenGLGraphicsVertexes &ogl = vert->ogl;
+    arrays.insert(ogl.mFloatTexPool.begin(), ogl.mFloatTexPool.end());
+    arrays.insert(ogl.mIntVertPool.begin(), ogl.mIntVertPool.end());
+    arrays.insert(ogl.mShortVertPool.begin(), ogl.mShortVertPool.end());
+    arrays.insert(ogl.mIntTexPool.begin(), ogl.mIntTexPool.end());
+    arrays.insert(ogl.mFloatTexArray);
+    arrays.insert(ogl.mIntTexArray);
+    arrays.insert(ogl.mIntVertArray);
+    arrays.insert(ogl.mShortVertArray);
+    arrays.erase(nullptr);
+#endif
+}
+
+int TestLauncher::testRebuild()
+{
+    timeval start;
+    timeval end;
+
+    Image *const img = Theme::getImageFromTheme(
+        "graphics/sprites/arrow_up.png");
+    if (!img)
+        return 1;
+
+    const int cnt = 500;
+    // frames after what reused vertexes must not allocate new arrays
+    const int warmup = 32;
+    int errors = 0;
+    std::set<const void*> arrays;
+    std::set<const void*> oldArrays;
+    file << mTest << std::endl;
+    // first pass recreate vertexes, second pass reuse arrays,
+    // third pass reuse arrays while view scrolled by one pixel per frame
+    for (int k = 0; k < 3; k ++)
+    {
+        ImageVertexes *vert = new ImageVertexes;
+        int newArrays = 0;
+        long time = 0;
+        oldArrays.clear();
+        for (int n = 0; n < cnt; n ++)
+        {
+            gettimeofday(&start, nullptr);
+            if (k)
+            {
+                vert->clear();
+            }
+            else
+            {
+                delete vert;
+                vert = new ImageVertexes;
+            }
+            vert->image = img;
+            const int scroll = k == 2 ? n % 32 : 0;
+            for (int y = -scroll; y < 600; y += 32)
+            {
+                for (int x = -scroll; x < 800; x += 32)
+                    mainGraphics->calcTileVertexes(vert, img, x, y);
+            }
+            mainGraphics->finalize(vert);
+            gettimeofday(&end, nullptr);
+            time += (end.tv_sec - start.tv_sec) * 1000000
+                + end.tv_usec - start.tv_usec;
+
+            // array check not timed
+            if (k)
+            {
+                collectArrays(vert, arrays);
+                FOR_EACH (std::set<const void*>::const_iterator, it, arrays)
+                {
+                    if (oldArrays.find(*it) == oldArrays.end())
+                    {
+                        newArrays ++;
+                        if (n >= warmup)
+                            errors ++;
+                    }
+                }
+                oldArrays.swap(arrays);
+            }
+        }
+        delete vert;
+
+        const char *const name = k == 2 ? "scroll" : k ? "reuse" : "new";
+        const int tFps = time ? static_cast<int>(
+            static_cast<long>(cnt) * 1000000 / time) : 100000;
+        file << tFps << std::endl;
+        file << newArrays << std::endl;
+        printf("rebuild %s: %d, new arrays: %d\n", name, tFps, newArrays);
+    }
+    return errors ? 1 : 0;
+}
+
+int TestLauncher::testPlacement()
+{
+    timeval start;
+    timeval end;
+
+    // synthetic crowd: names of beings standing on 40x30 tiles
+    const int crowd = 1000;
+    const Color *const color = &theme->getColor(Theme::PLAYER, 255);
+    std::vector<Text*> texts;
+    texts.reserve(crowd);
+
+    file << mTest << std::endl;
+    gettimeofday(&start, nullptr);
+    for (int f = 0; f < crowd; f ++)
+    {
+        texts.push_back(new Text(strprintf("being %d", f),
+            (f * 37 % 40) * 32 + 16, (f * 53 % 30) * 32,
+            Graphics::CENTER, color, false));
+    }
+    gettimeofday(&end, nullptr);
+    const int tAdd = calcFps(&start, &end, crowd);
+    file << tAdd << std::endl;
+
+    // all beings walk one pixel per frame
+    const int cnt = 100;
+    gettimeofday(&start, nullptr);
+    for (int k = 0; k < cnt; k ++)
+    {
+        for (int f = 0; f < crowd; f ++)
+        {
+            texts[f]->adviseXY((f * 37 % 40) * 32 + 16 + k,
+                (f * 53 % 30) * 32, true);
+        }
+    }
+    gettimeofday(&end, nullptr);
+    const int tFps = calcFps(&start, &end, cnt);
+    file << tFps << std::endl;
+
+    FOR_EACH (std::vector<Text*>::iterator, it, texts)
+        delete *it;
+    printf("texts: %d, adds: %d, fps: %d\n", crowd, tAdd, tFps);
+    return 0;
+}
+
+int TestLauncher::testPackets()
+{
+    timeval start;
+    timeval end;
+
+    if (actorManager)
+        return 1;
+    actorManager = new ActorManager;
+
+    const int beings = 2000;
+    const int firstId = 110000000;
+    file << mTest << std::endl;
+    gettimeofday(&start, nullptr);
+    for (int f = 0; f < beings; f ++)
+        actorManager->createBeing(firstId + f, ActorType::MONSTER, 1002);
+    gettimeofday(&end, nullptr);
+    const int tSpawn = calcFps(&start, &end, beings);
+    file << tSpawn << std::endl;
+
+    // synthetic packet stream, not recorded traffic.
+    // first pass only looks up beings by id.
+    const int cnt = 100000;
+    int errors = 0;
+    gettimeofday(&start, nullptr);
+    for (int k = 0; k < cnt; k ++)
+    {
+        if (!actorManager->findBeing(firstId + (k * 7919) % beings))
+            errors ++;
+    }
+    gettimeofday(&end, nullptr);
+    const int tLookups = calcFps(&start, &end, cnt);
+    file << tLookups << std::endl;
+
+    // second pass respawns being with same id on every 20th packet.
+    // logic deletes old beings every 100 packets and is timed separately.
+    const int respawns = cnt / 20;
+    long respawnTime = 0;
+    long logicTime = 0;
+    int logicCalls = 0;
+    for (int k = 0; k < respawns; k ++)
+    {
+        gettimeofday(&start, nullptr);
+        const int id = firstId + (k * 20 * 7919) % beings;
+        Being *const being = actorManager->findBeing(id);
+        if (!being)
+        {
+            errors ++;
+        }
+        else
+        {
+            actorManager->destroy(being);
+            Being *const newBeing = actorManager->createBeing(id,
+                ActorType::MONSTER, 1002);
+            if (actorManager->findBeing(id) != newBeing)
+                errors ++;
+        }
+        gettimeofday(&end, nullptr);
+        respawnTime += (end.tv_sec - start.tv_sec) * 1000000
+            + end.tv_usec - start.tv_usec;
+        if (!(k % 5) || k == respawns - 1)
+        {
+            gettimeofday(&start, nullptr);
+            actorManager->logic();
+            gettimeofday(&end, nullptr);
+            logicTime += (end.tv_sec - start.tv_sec) * 1000000
+                + end.tv_usec - start.tv_usec;
+            logicCalls ++;
+        }
+    }
+    const int tRespawns = respawnTime ? static_cast<int>(
+        static_cast<long>(respawns) * 1000000 / respawnTime) : 100000;
+    const long tLogic = logicTime / logicCalls;
+    file << tRespawns << std::endl;
+    file << tLogic << std::endl;
+
+    delete2(actorManager);
+    printf("beings: %d, spawns: %d, lookups: %d, respawns: %d, "
+        "logic: %ld us, errors: %d\n",
+        beings, tSpawn, tLookups, tRespawns, tLogic, errors);
+    return errors ? 1 : 0;
+}
+
+int TestLauncher::testPick()
+{
+    if (actorManager)
+        return 1;
+    actorManager = new ActorManager;
+    Map *const map = new Map(64, 64, mapTileSize, mapTileSize);
+    actorManager->setMap(map);
+
+    int errors = 0;
+    Being *const being = actorManager->createBeing(110000000,
+        ActorType::MONSTER, 1002);
+    being->setTileCoords(10, 10);
+    being->setPosition(Vector(static_cast<float>(10 * mapTileSize
+        + mapTileSize / 2), static_cast<float>(11 * mapTileSize)));
+    if (actorManager->findBeingByPixel(10 * mapTileSize + mapTileSize / 2,
+        11 * mapTileSize - 1, true) != being)
+    {
+        errors ++;
+    }
+
+    // pixel position far outside of grid margin from being tile
+    const int x = 40 * mapTileSize + mapTileSize / 2;
+    const int y = 41 * mapTileSize;
+    being->setPosition(Vector(static_cast<float>(x),
+        static_cast<float>(y)));
+    if (actorManager->findBeingByPixel(x, y - 1, true) != being)
+        errors ++;
+    std::vector<ActorSprite*> beings;
+    actorManager->findBeingsByPixel(beings, x, y - 1, true);
+    if (beings.size() != 1 || beings[0] != being)
+        errors ++;
+
+    // back near tile, far click must not hit being
+    being->setPosition(Vector(static_cast<float>(10 * mapTileSize
+        + mapTileSize / 2), static_cast<float>(11 * mapTileSize)));
+    if (actorManager->findBeingByPixel(x, y - 1, true))
+        errors ++;
+    beings.clear();
+    actorManager->findBeingsByPixel(beings, 10 * mapTileSize
+        + mapTileSize / 2, 11 * mapTileSize - 1, true);
+    if (beings.size() != 1)
+        errors ++;
+
+    file << mTest << std::endl;
+    file << errors << std::endl;
+    delete2(actorManager);
+    delete map;
+    printf("pick errors: %d\n", errors);
+    return errors ? 1 : 0;
+}
+
 int TestLauncher::testBatches()
 {
     int batches = 512;
@@ -413,7 +762,8 @@ int TestLauncher::testDye()
 
     if (rw)
     {
-        Image *image = d ? surfaceImageHelper->load(rw, *d)
+        Image *image = d ? surfaceImageHelper->load(rw, *d,
+            "graphics/sprites/arrow_up.png")
             : surfaceImageHelper->load(rw);
         if (image)
         {
@@ -433,7 +783,8 @@ int TestLauncher::testDye()
             rw = MPHYSFSRWOPS_openRead(
                 "graphics/sprites/arrow_up.png");
             d = new Dye("S:#0000ff,00ff00,5c5cff,ff0000");
-            image = surfaceImageHelper->load(rw, *d);
+            image = surfaceImageHelper->load(rw, *d,
+                "graphics/sprites/arrow_up.png");
             if (image)
             {
                 surface = surfaceImageHelper->create32BitSurface(
@@ -450,6 +801,45 @@ int TestLauncher::testDye()
             }
         }
     }
+
+    // dye speed with default and cpu specific pixel kernels
+    timeval start;
+    timeval end;
+    const int cnt = 200;
+    const int pixelsSize = 256 * 256;
+    uint32_t *const pixels = new uint32_t[pixelsSize];
+    uint32_t *const source = new uint32_t[pixelsSize];
+    for (int f = 0; f < pixelsSize; f ++)
+    {
+        const uint32_t v = static_cast<uint32_t>(f) & 0xff;
+        switch (f % 4)
+        {
+            case 0: source[f] = (v << 24) | 0xff; break;
+            case 1: source[f] = (v << 24) | (v << 16) | 0xff; break;
+            case 2: source[f] = (v << 24) | (v << 16) | (v << 8) | 0xff;
+                break;
+            default: source[f] = (v << 24) | (f << 8) | 0xff; break;
+        }
+    }
+    Dye dye("R:#203040,506070;Y:#ff0000;W:#111111,eeeeee");
+    file << mTest << std::endl;
+    for (int k = 0; k < 2; k ++)
+    {
+        Dye::initFunctions(k ? Cpu::getFlags() : 0);
+        gettimeofday(&start, nullptr);
+        for (int f = 0; f < cnt; f ++)
+        {
+            memcpy(pixels, source, pixelsSize * sizeof(uint32_t));
+            dye.normalDye(pixels, pixelsSize);
+        }
+        gettimeofday(&end, nullptr);
+        const int tFps = calcFps(&start, &end, cnt);
+        file << tFps << std::endl;
+        printf("dye %s: %d\n", k ? "cpu" : "default", tFps);
+    }
+    Dye::initFunctions(Cpu::getFlags());
+    delete [] pixels;
+    delete [] source;
     return 0;
 }
 
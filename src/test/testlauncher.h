@@ -72,6 +72,16 @@ class TestLauncher final
 
         int testDraw();
 
+        int testTrace();
+
+        int testRebuild();
+
+        int testPlacement();
+
+        int testPackets();
+
+        int testPick();
+
     private:
         std::string mTest;
 
@@ -51,10 +51,13 @@ Text::Text(const std::string &text, const int x, const int y,
     mWidth(mFont ? mFont->getWidth(text) : 1),
     mHeight(mFont ? mFont->getHeight() : 1),
     mXOffset(0),
+    mGridLeft(0),
+    mGridRight(-1),
     mText(text),
     mColor(color),
     mOutlineColor(theme->getColor(Theme::OUTLINE, 255)),
-    mIsSpeech(isSpeech)
+    mIsSpeech(isSpeech),
+    mTextPlate()
 {
     if (!textManager)
     {
@@ -130,6 +133,8 @@ void Text::adviseXY(const int x, const int y, const bool move)
     {
         mX = x - mXOffset;
         mY = y;
+        if (textManager)
+            textManager->updateText(this);
     }
 }
 
@@ -149,7 +154,7 @@ void Text::draw(Graphics *const graphics, const int xOff, const int yOff)
     if (!mIsSpeech)
         graphics->setColor2(mOutlineColor);
 
-    mFont->drawString(graphics, mText, mX - xOff, mY - yOff);
+    mFont->drawString(graphics, mText, mX - xOff, mY - yOff, mTextPlate);
     BLOCK_END("Text::draw")
 }
 
@@ -28,6 +28,8 @@
 
 #include "gui/color.h"
 
+#include "gui/fonts/textplate.h"
+
 #include "localconsts.h"
 
 class Font;
@@ -78,11 +80,14 @@ class Text notfinal
         int mWidth;            /**< The width of the text. */
         int mHeight;           /**< The height of the text. */
         int mXOffset;          /**< The offset of mX from the desired x. */
+        int mGridLeft;         /**< First column in TextManager grid. */
+        int mGridRight;        /**< Last column in TextManager grid. */
         static int mInstances; /**< Instances of text. */
         std::string mText;     /**< The text to display. */
         const Color *mColor;     /**< The color of the text. */
         const Color mOutlineColor;
         bool mIsSpeech;        /**< Is this text a speech bubble? */
+        TextPlate mTextPlate;  /**< Own image of the text. */
 
     protected:
         static ImageRect mBubble;   /**< Speech bubble graphic */
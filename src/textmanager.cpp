@@ -23,14 +23,37 @@
 
 #include "text.h"
 
-#include <cstring>
+#include <algorithm>
+#include <climits>
 
 #include "debug.h"
 
 TextManager *textManager = nullptr;
 
+namespace
+{
+    const int GRID_COLUMN_WIDTH = 64;
+
+    int getGridColumn(const int x)
+    {
+        if (x >= 0)
+            return x / GRID_COLUMN_WIDTH;
+        return (x + 1) / GRID_COLUMN_WIDTH - 1;
+    }
+
+    struct TextSpan final
+    {
+        int top;
+        int bottom;
+
+        bool operator<(const TextSpan &span) const
+        { return top < span.top; }
+    };
+}  // namespace
+
 TextManager::TextManager() :
-    mTextList()
+    mTextList(),
+    mGrid()
 {
 }
 
@@ -38,17 +61,31 @@ void TextManager::addText(Text *const text)
 {
     place(text, nullptr, text->mX, text->mY, text->mHeight);
     mTextList.push_back(text);
+    addToGrid(text);
 }
 
-void TextManager::moveText(Text *const text, const int x, const int y) const
+void TextManager::moveText(Text *const text, const int x, const int y)
 {
     text->mX = x;
     text->mY = y;
     place(text, text, text->mX, text->mY, text->mHeight);
+    updateText(text);
+}
+
+void TextManager::updateText(Text *const text)
+{
+    if (getGridColumn(text->mX) == text->mGridLeft
+        && getGridColumn(text->mX + text->mWidth - 1) == text->mGridRight)
+    {
+        return;
+    }
+    removeFromGrid(text);
+    addToGrid(text);
 }
 
 void TextManager::removeText(const Text *const text)
 {
+    removeFromGrid(text);
     FOR_EACH (TextList::iterator, ptr, mTextList)
     {
         if (*ptr == text)
@@ -59,6 +96,35 @@ void TextManager::removeText(const Text *const text)
     }
 }
 
+void TextManager::addToGrid(Text *const text)
+{
+    text->mGridLeft = getGridColumn(text->mX);
+    text->mGridRight = getGridColumn(text->mX + text->mWidth - 1);
+    for (int f = text->mGridLeft; f <= text->mGridRight; f ++)
+        mGrid[f].push_back(text);
+}
+
+void TextManager::removeFromGrid(const Text *const text)
+{
+    for (int f = text->mGridLeft; f <= text->mGridRight; f ++)
+    {
+        const TextGrid::iterator it = mGrid.find(f);
+        if (it == mGrid.end())
+            continue;
+        TextVector &texts = (*it).second;
+        TextVector::iterator it2 = std::find(texts.begin(), texts.end(),
+            text);
+        if (it2 != texts.end())
+        {
+            // order in column not matter
+            *it2 = texts.back();
+            texts.pop_back();
+        }
+        if (texts.empty())
+            mGrid.erase(it);
+    }
+}
+
 TextManager::~TextManager()
 {
 }
@@ -67,8 +133,21 @@ void TextManager::draw(Graphics *const graphics,
                        const int xOff, const int yOff)
 {
     BLOCK_START("TextManager::draw")
+    const int width = graphics->getWidth();
+    const int height = graphics->getHeight();
     FOR_EACH (TextList::const_iterator, bPtr, mTextList)
-        (*bPtr)->draw(graphics, xOff, yOff);
+    {
+        Text *const text = *bPtr;
+        // speech bubble drawn with 5 pixels border
+        const int x = text->mX - xOff;
+        const int y = text->mY - yOff;
+        if (x + text->mWidth + 5 < 0 || x - 5 > width
+            || y + text->mHeight + 5 < 0 || y - 5 > height)
+        {
+            continue;
+        }
+        text->draw(graphics, xOff, yOff);
+    }
     BLOCK_END("TextManager::draw")
 }
 
@@ -77,105 +156,81 @@ void TextManager::place(const Text *const textObj, const Text *const omit,
 {
     const int xLeft = textObj->mX;
     const int xRight1 = xLeft + textObj->mWidth;
-    const int TEST = 50;  // Number of lines to test for text
-    const int nBeings = 30;
-    bool occupied[TEST];  // is some other text obscuring this line?
-    std::memset(&occupied, 0, sizeof(occupied));  // set all to false
-    const int wantedTop = (TEST - h) / 2;   // Entry in occupied at top of text
-    const int occupiedTop = y - wantedTop;  // Line in map representing
-                                            // to of occupied
-    int cnt = 0;
-
-    for (TextList::const_iterator ptr = mTextList.begin(),
-         pEnd = mTextList.end(); ptr != pEnd && cnt < nBeings; ++ptr, cnt ++)
-    {
-        const Text *const text = *ptr;
+    const int colRight = getGridColumn(xRight1 - 1);
 
-        if (text != omit && text->mX + 1 <= xRight1
-            && text->mX + text->mWidth > xLeft)
-        {
-            int from = text->mY - occupiedTop;
-            int to = from + text->mHeight - 1;
-            if (to < 0 || from >= TEST)  // out of range considered
-                continue;
-            if (from < 0)
-                from = 0;
-            if (to >= TEST)
-                to = TEST - 1;
-            for (int i = from; i <= to; ++i)
-                occupied[i] = true;
-        }
+    // texts wider than one column stored in all columns, so remove copies
+    TextVector texts;
+    for (TextGrid::const_iterator it = mGrid.lower_bound(
+         getGridColumn(xLeft)), it_end = mGrid.end();
+         it != it_end && (*it).first <= colRight; ++ it)
+    {
+        const TextVector &column = (*it).second;
+        texts.insert(texts.end(), column.begin(), column.end());
     }
-    bool ok = true;
-    const int sz = wantedTop + h;
-    for (int i = wantedTop; i < sz; i ++)
+    std::sort(texts.begin(), texts.end());
+    texts.erase(std::unique(texts.begin(), texts.end()), texts.end());
+
+    std::vector<TextSpan> spans;
+    FOR_EACH (TextVector::const_iterator, ptr, texts)
     {
-        if (occupied[i])
+        const Text *const text = *ptr;
+        if (text != omit && text != textObj
+            && text->mX + 1 <= xRight1
+            && text->mX + text->mWidth > xLeft)
         {
-            ok = false;
-            break;
+            const TextSpan span = {text->mY, text->mY + text->mHeight};
+            spans.push_back(span);
         }
     }
-
-    if (ok)
+    if (spans.empty())
         return;
-
-    // Have to move it up or down, so find nearest spaces either side
-    int consec = 0;
-    int upSlot = -1;  // means not found
-    const int sz2 = wantedTop + h - 2;
-    for (int seek = sz2; seek >= 0; --seek)
+    std::sort(spans.begin(), spans.end());
+
+    // merge overlapped spans and look for nearest gap where text fit
+    int bestY = y;
+    int bestDist = -1;
+    int gapTop = INT_MIN;
+    const size_t sz = spans.size();
+    size_t f = 0;
+    while (f <= sz)
     {
-        if (occupied[seek])
-        {
-            consec = 0;
-        }
-        else
+        int gapBottom = INT_MAX;
+        int spanBottom = INT_MAX;
+        if (f < sz)
         {
-            if (++consec == h)
+            gapBottom = spans[f].top;
+            spanBottom = spans[f].bottom;
+            f ++;
+            while (f < sz && spans[f].top < spanBottom)
             {
-                upSlot = seek;
-                break;
+                if (spans[f].bottom > spanBottom)
+                    spanBottom = spans[f].bottom;
+                f ++;
             }
         }
-    }
-    int downSlot = -1;
-    consec = 0;
-    for (int seek = wantedTop + 1; seek < TEST; ++seek)
-    {
-        if (occupied[seek])
+        else
         {
-            consec = 0;
+            f ++;
         }
-        else
+
+        if (gapBottom - h >= gapTop)
         {
-            if (++consec == h)
+            int pos = y;
+            if (pos < gapTop)
+                pos = gapTop;
+            else if (pos > gapBottom - h)
+                pos = gapBottom - h;
+            const int dist = pos > y ? pos - y : y - pos;
+            // prefer move up if distances same
+            if (bestDist == -1 || dist < bestDist)
             {
-                downSlot = seek - h + 1;
-                break;
+                bestDist = dist;
+                bestY = pos;
             }
+            if (dist == 0 || pos > y)
+                break;
         }
+        gapTop = spanBottom;
     }
-    if (upSlot == -1 && downSlot == -1)  // no good solution, so leave as is
-    {
-        return;
-    }
-    if (upSlot == -1)  // must go down
-    {
-        y += downSlot - wantedTop;
-        return;
-    }
-    if (downSlot == -1)  // must go up
-    {
-        y -= wantedTop - upSlot;
-        return;
-    }
-    if (wantedTop - upSlot > downSlot - wantedTop)  // down is better
-    {
-        y += downSlot - wantedTop;
-    }
-    else
-    {
-        y -= wantedTop - upSlot;
-    }
+    y = bestY;
 }
@@ -23,6 +23,8 @@
 #define TEXTMANAGER_H
 
 #include <list>
+#include <map>
+#include <vector>
 
 #include "localconsts.h"
 
@@ -52,7 +54,12 @@ class TextManager final
         /**
          * Move the text around the screen
          */
-        void moveText(Text *const text, const int x, const int y) const;
+        void moveText(Text *const text, const int x, const int y);
+
+        /**
+         * Update index after text position changed without placing
+         */
+        void updateText(Text *const text);
 
         /**
          * Remove the text from the manager
@@ -72,8 +79,16 @@ class TextManager final
         void place(const Text *const textObj, const Text *const omit,
                    const int &x, int &y, const int h) const;
 
+        void addToGrid(Text *const text);
+
+        void removeFromGrid(const Text *const text);
+
         typedef std::list<Text *> TextList; /**< The container type */
         TextList mTextList; /**< The container */
+
+        typedef std::vector<Text *> TextVector;
+        typedef std::map<int, TextVector> TextGrid;
+        TextGrid mGrid; /**< Texts by screen columns */
 };
 
 extern TextManager *textManager;
@@ -88,6 +88,11 @@ void Cpu::detect()
 #endif
 }
 
+int Cpu::getFlags()
+{
+    return mCpuFlags;
+}
+
 void Cpu::printFlags()
 {
     std::string str("CPU features:");
@@ -39,6 +39,8 @@ namespace Cpu
     void detect();
 
     void printFlags();
+
+    int getFlags() A_WARN_UNUSED;
 }  // namespace CPU
 
 #endif  // UTILS_CPU_H
@@ -0,0 +1,458 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "utils/datapack.h"
+
+#include "logger.h"
+
+#include "utils/mutex.h"
+#include "utils/physfstools.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <sys/stat.h>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "debug.h"
+
+namespace
+{
+    const char packMagic[4] = {'M', 'P', 'A', 'K'};
+    const uint32_t packVersion = 1;
+    const uint32_t headerSize = 20;
+    const uint32_t entrySize = 16;
+    const uint32_t packAlign = 16;
+
+    struct PackFile final
+    {
+        PackFile() :
+            data(nullptr),
+            size(0),
+            count(0)
+        {
+        }
+
+        A_DELETE_COPY(PackFile)
+
+        const unsigned char *data;
+        size_t size;
+        uint32_t count;
+    };
+
+    typedef std::map<std::string, PackFile*> PackFiles;
+    typedef PackFiles::const_iterator PackFilesCIter;
+
+    // packs searched from image decoder threads
+    Mutex mPacksMutex;
+    PackFiles mPacks;
+    // unloaded packs can be still used by opened music or fonts
+    std::vector<PackFile*> mRetiredPacks;
+}  // namespace
+
+static uint32_t readUInt(const unsigned char *const ptr)
+{
+    return static_cast<uint32_t>(ptr[0])
+        | (static_cast<uint32_t>(ptr[1]) << 8)
+        | (static_cast<uint32_t>(ptr[2]) << 16)
+        | (static_cast<uint32_t>(ptr[3]) << 24);
+}
+
+static void writeUInt(std::ofstream &file, const uint32_t val)
+{
+    const char buf[4] =
+    {
+        static_cast<char>(val & 0xff),
+        static_cast<char>((val >> 8) & 0xff),
+        static_cast<char>((val >> 16) & 0xff),
+        static_cast<char>((val >> 24) & 0xff)
+    };
+    file.write(buf, 4);
+}
+
+static std::string getPackName(const std::string &archive)
+{
+    return archive + ".pack";
+}
+
+static bool getArchiveStat(const std::string &archive,
+                           uint32_t &size,
+                           uint32_t &time)
+{
+    struct stat statbuf;
+    if (stat(archive.c_str(), &statbuf))
+        return false;
+    size = static_cast<uint32_t>(statbuf.st_size);
+    time = static_cast<uint32_t>(statbuf.st_mtime);
+    return true;
+}
+
+static void freePack(PackFile *const pack)
+{
+    if (!pack)
+        return;
+#ifdef WIN32
+    delete [] pack->data;
+#else
+    if (pack->data)
+    {
+        munmap(const_cast<unsigned char*>(pack->data), pack->size);
+    }
+#endif
+    delete pack;
+}
+
+static PackFile *mapPack(const std::string &name)
+{
+    PackFile *pack = nullptr;
+#ifdef WIN32
+    std::ifstream file(name.c_str(), std::ios::in | std::ios::binary);
+    if (!file.is_open())
+        return nullptr;
+    file.seekg(0, std::ios::end);
+    const std::streamoff size = file.tellg();
+    if (size <= 0)
+        return nullptr;
+    file.seekg(0, std::ios::beg);
+    unsigned char *const data = new unsigned char[static_cast<size_t>(size)];
+    file.read(reinterpret_cast<char*>(data), size);
+    if (!file.good())
+    {
+        delete [] data;
+        return nullptr;
+    }
+    pack = new PackFile;
+    pack->data = data;
+    pack->size = static_cast<size_t>(size);
+#else
+    const int fd = open(name.c_str(), O_RDONLY);
+    if (fd == -1)
+        return nullptr;
+    struct stat statbuf;
+    if (fstat(fd, &statbuf) || statbuf.st_size <= 0)
+    {
+        close(fd);
+        return nullptr;
+    }
+    const size_t size = static_cast<size_t>(statbuf.st_size);
+    void *const data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return nullptr;
+    pack = new PackFile;
+    pack->data = static_cast<const unsigned char*>(data);
+    pack->size = size;
+#endif
+    return pack;
+}
+
+static bool validatePack(PackFile *const pack,
+                         const std::string &archive)
+{
+    const unsigned char *const data = pack->data;
+    const size_t size = pack->size;
+    if (size < headerSize
+        || memcmp(data, packMagic, 4)
+        || readUInt(data + 4) != packVersion)
+    {
+        return false;
+    }
+    uint32_t archiveSize = 0;
+    uint32_t archiveTime = 0;
+    if (!getArchiveStat(archive, archiveSize, archiveTime)
+        || readUInt(data + 8) != archiveSize
+        || readUInt(data + 12) != archiveTime)
+    {
+        return false;
+    }
+    const uint32_t count = readUInt(data + 16);
+    if (count > (size - headerSize) / entrySize)
+        return false;
+
+    const char *prevName = nullptr;
+    for (uint32_t f = 0; f < count; f ++)
+    {
+        const unsigned char *const entry = data + headerSize + f * entrySize;
+        const uint32_t nameOffset = readUInt(entry);
+        const uint32_t nameLen = readUInt(entry + 4);
+        const uint32_t dataOffset = readUInt(entry + 8);
+        const uint32_t dataSize = readUInt(entry + 12);
+        if (nameOffset >= size
+            || nameLen >= size - nameOffset
+            || data[nameOffset + nameLen] != 0
+            || dataOffset > size
+            || dataSize > size - dataOffset)
+        {
+            return false;
+        }
+        // binary search need sorted names
+        const char *const name = reinterpret_cast<const char*>(
+            data + nameOffset);
+        if (prevName && strcmp(prevName, name) >= 0)
+            return false;
+        prevName = name;
+    }
+    pack->count = count;
+    return true;
+}
+
+static void collectFiles(const std::string &dir,
+                         const std::set<std::string> &archives,
+                         std::map<std::string, StringVect> &files)
+{
+    char **list = PhysFs::enumerateFiles(dir.c_str());
+    for (char **i = list; *i; i++)
+    {
+        const std::string path = dir.empty() ? std::string(*i)
+            : std::string(dir).append("/").append(*i);
+        if (PhysFs::isDirectory(path.c_str()))
+        {
+            collectFiles(path, archives, files);
+            continue;
+        }
+        const char *const realDir = PhysFs::getRealDir(path.c_str());
+        if (!realDir)
+            continue;
+        const std::string archive = realDir;
+        if (archives.find(archive) != archives.end())
+            files[archive].push_back(path);
+    }
+    PhysFs::freeList(list);
+}
+
+static bool writePack(const std::string &archive,
+                      StringVect &files)
+{
+    uint32_t archiveSize = 0;
+    uint32_t archiveTime = 0;
+    if (!getArchiveStat(archive, archiveSize, archiveTime))
+        return false;
+
+    std::sort(files.begin(), files.end());
+    const uint32_t count = static_cast<uint32_t>(files.size());
+    std::vector<uint32_t> sizes;
+    sizes.reserve(count);
+    FOR_EACH (StringVectCIter, it, files)
+    {
+        PHYSFS_file *const file = PhysFs::openRead((*it).c_str());
+        if (!file)
+            return false;
+        sizes.push_back(static_cast<uint32_t>(PHYSFS_fileLength(file)));
+        PHYSFS_close(file);
+    }
+
+    uint32_t namesSize = 0;
+    FOR_EACH (StringVectCIter, it, files)
+        namesSize += static_cast<uint32_t>((*it).size()) + 1;
+    uint32_t dataOffset = headerSize + count * entrySize + namesSize;
+    dataOffset = (dataOffset + packAlign - 1) & ~(packAlign - 1);
+
+    const std::string packName = getPackName(archive);
+    std::ofstream pack(packName.c_str(),
+        std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!pack.is_open())
+        return false;
+
+    pack.write(packMagic, 4);
+    writeUInt(pack, packVersion);
+    writeUInt(pack, archiveSize);
+    writeUInt(pack, archiveTime);
+    writeUInt(pack, count);
+
+    uint32_t nameOffset = headerSize + count * entrySize;
+    uint32_t offset = dataOffset;
+    for (uint32_t f = 0; f < count; f ++)
+    {
+        const uint32_t nameLen = static_cast<uint32_t>(files[f].size());
+        writeUInt(pack, nameOffset);
+        writeUInt(pack, nameLen);
+        writeUInt(pack, offset);
+        writeUInt(pack, sizes[f]);
+        nameOffset += nameLen + 1;
+        offset = (offset + sizes[f] + packAlign - 1) & ~(packAlign - 1);
+    }
+    for (uint32_t f = 0; f < count; f ++)
+        pack.write(files[f].c_str(), files[f].size() + 1);
+
+    const char zeros[packAlign] = { };
+    offset = nameOffset;
+    bool status(true);
+    for (uint32_t f = 0; f < count && status; f ++)
+    {
+        pack.write(zeros, (packAlign - offset % packAlign) % packAlign);
+        offset = (offset + packAlign - 1) & ~(packAlign - 1);
+
+        const uint32_t size = sizes[f];
+        PHYSFS_file *const file = PhysFs::openRead(files[f].c_str());
+        if (!file)
+        {
+            status = false;
+            break;
+        }
+        if (size > 0)
+        {
+            char *const buf = new char[size];
+            if (PHYSFS_read(file, buf, 1, size) == static_cast<int>(size))
+                pack.write(buf, size);
+            else
+                status = false;
+            delete [] buf;
+        }
+        PHYSFS_close(file);
+        offset += size;
+    }
+    pack.close();
+    if (!status || pack.fail())
+    {
+        ::remove(packName.c_str());
+        return false;
+    }
+    logger->log("Created data pack %s (%u files)", packName.c_str(), count);
+    return true;
+}
+
+namespace DataPack
+{
+    void loadPacks(const StringVect &archives)
+    {
+        std::set<std::string> missing;
+        FOR_EACH (StringVectCIter, it, archives)
+        {
+            if (!load(*it))
+                missing.insert(*it);
+        }
+        if (missing.empty())
+            return;
+
+        std::map<std::string, StringVect> files;
+        collectFiles("", missing, files);
+        FOR_EACH (std::set<std::string>::const_iterator, it, missing)
+        {
+            const std::string &archive = *it;
+            if (writePack(archive, files[archive]))
+                load(archive);
+            else
+                logger->log("Error creating data pack for: " + archive);
+        }
+    }
+
+    bool load(const std::string &archive)
+    {
+        MutexLocker lock(&mPacksMutex);
+        if (mPacks.find(archive) != mPacks.end())
+            return true;
+
+        PackFile *const pack = mapPack(getPackName(archive));
+        if (!pack)
+            return false;
+        if (!validatePack(pack, archive))
+        {
+            logger->log("Outdated or broken data pack for: " + archive);
+            freePack(pack);
+            return false;
+        }
+        mPacks[archive] = pack;
+        return true;
+    }
+
+    void unload(const std::string &archive)
+    {
+        MutexLocker lock(&mPacksMutex);
+        const PackFiles::iterator it = mPacks.find(archive);
+        if (it == mPacks.end())
+            return;
+        mRetiredPacks.push_back((*it).second);
+        mPacks.erase(it);
+    }
+
+    void clear()
+    {
+        MutexLocker lock(&mPacksMutex);
+        FOR_EACH (PackFilesCIter, it, mPacks)
+            freePack((*it).second);
+        mPacks.clear();
+        FOR_EACH (std::vector<PackFile*>::const_iterator, it, mRetiredPacks)
+            freePack(*it);
+        mRetiredPacks.clear();
+    }
+
+    const char *find(const char *const fname, int &size)
+    {
+        if (!fname)
+            return nullptr;
+
+        MutexLocker lock(&mPacksMutex);
+        if (mPacks.empty())
+            return nullptr;
+        const char *const realDir = PhysFs::getRealDir(fname);
+        if (!realDir)
+            return nullptr;
+        const PackFilesCIter it = mPacks.find(realDir);
+        if (it == mPacks.end())
+            return nullptr;
+
+        const char *name = fname;
+        while (*name == '/')
+            name ++;
+
+        const PackFile *const pack = (*it).second;
+        const unsigned char *const data = pack->data;
+        uint32_t first = 0;
+        uint32_t last = pack->count;
+        while (first < last)
+        {
+            const uint32_t middle = first + (last - first) / 2;
+            const unsigned char *const entry = data + headerSize
+                + middle * entrySize;
+            const int cmp = strcmp(name, reinterpret_cast<const char*>(
+                data + readUInt(entry)));
+            if (!cmp)
+            {
+                size = static_cast<int>(readUInt(entry + 12));
+                return reinterpret_cast<const char*>(
+                    data + readUInt(entry + 8));
+            }
+            if (cmp < 0)
+                last = middle;
+            else
+                first = middle + 1;
+        }
+        return nullptr;
+    }
+
+    SDL_RWops *openRead(const char *const fname)
+    {
+        int size = 0;
+        const char *const data = find(fname, size);
+        if (!data)
+            return nullptr;
+        return SDL_RWFromConstMem(data, size);
+    }
+}  // namespace DataPack
@@ -0,0 +1,63 @@
+/*
+ *  The ManaPlus Client
+ *  Copyright (C) 2014  The ManaPlus Developers
+ *
+ *  This file is part of The ManaPlus Client.
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UTILS_DATAPACK_H
+#define UTILS_DATAPACK_H
+
+#include "utils/stringvector.h"
+
+#include <SDL_rwops.h>
+
+#include <string>
+
+#include "localconsts.h"
+
+/**
+ * Uncompressed copy of update archive. Pack have sorted path table and
+ * aligned file blobs. It mapped into memory and files served from it
+ * without inflating and without PhysFS reads.
+ * Pack used only for files what PhysFS would load from same archive.
+ */
+namespace DataPack
+{
+    /**
+     * Loads packs for given archives and builds missing or outdated packs.
+     * Archives must be already added into search path.
+     */
+    void loadPacks(const StringVect &archives);
+
+    bool load(const std::string &archive);
+
+    void unload(const std::string &archive);
+
+    void clear();
+
+    /**
+     * Returns file data from loaded pack or nullptr.
+     */
+    const char *find(const char *const fname, int &size) A_WARN_UNUSED;
+
+    /**
+     * Returns read only SDL_RWops for file from loaded pack or nullptr.
+     */
+    SDL_RWops *openRead(const char *const fname) A_WARN_UNUSED;
+}  // namespace DataPack
+
+#endif  // UTILS_DATAPACK_H
@@ -26,6 +26,7 @@
 
 #include "logger.h"
 
+#include "utils/datapack.h"
 #include "utils/fuzzer.h"
 #include "utils/physfscheckutils.h"
 
@@ -241,6 +242,9 @@ SDL_RWops *PHYSFSRWOPS_openRead(const char *const fname)
     if (Fuzzer::conditionTerminate(fname))
         return nullptr;
 #endif
+    SDL_RWops *const rw = DataPack::openRead(fname);
+    if (rw)
+        return rw;
     return create_rwops(PhysFs::openRead(fname));
 } /* PHYSFSRWOPS_openRead */
 
@@ -22,6 +22,9 @@
 
 #include "logger.h"
 
+#include "utils/datapack.h"
+
+#include <cstring>
 #include <iostream>
 #include <unistd.h>
 
@@ -132,6 +135,11 @@ namespace PhysFs
         return PHYSFS_getRealDir(filename);
     }
 
+    PHYSFS_sint64 getLastModTime(const char *const filename)
+    {
+        return PHYSFS_getLastModTime(filename);
+    }
+
     bool mkdir(const char *const dirname)
     {
         return PHYSFS_mkdir(dirname);
@@ -139,6 +147,21 @@ namespace PhysFs
 
     void *loadFile(const std::string &fileName, int &fileSize)
     {
+        const char *const packData = DataPack::find(fileName.c_str(),
+            fileSize);
+        if (packData)
+        {
+            void *const buffer = calloc(fileSize, 1);
+            if (!buffer)
+            {
+                logger->log("Error: Out of memory loading %s",
+                    fileName.c_str());
+                return nullptr;
+            }
+            memcpy(buffer, packData, fileSize);
+            return buffer;
+        }
+
         // Attempt to open the specified file using PhysicsFS
         PHYSFS_file *const file = PhysFs::openRead(fileName.c_str());
 
@@ -42,6 +42,7 @@ namespace PhysFs
     bool addToSearchPath(const char *const newDir, const int appendToPath);
     bool removeFromSearchPath(const char *const oldDir);
     const char *getRealDir(const char *const filename);
+    PHYSFS_sint64 getLastModTime(const char *const filename);
     bool mkdir(const char *const dirName);
     void *loadFile(const std::string &fileName, int &fileSize);
 }  // namespace PhysFs
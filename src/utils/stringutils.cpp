@@ -730,3 +730,29 @@ void secureChatCommand(std::string &str)
     if (str[0] == '/' || str[0] == '@' || str[0] == '#')
         str = "_" + str;
 }
+
+uint32_t hashString(const std::string &str)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261U;
+    const size_t sz = str.size();
+    for (size_t f = 0; f < sz; f ++)
+    {
+        hash ^= static_cast<uint8_t>(str[f]);
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+uint64_t hashString64(const std::string &str)
+{
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    const size_t sz = str.size();
+    for (size_t f = 0; f < sz; f ++)
+    {
+        hash ^= static_cast<uint8_t>(str[f]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
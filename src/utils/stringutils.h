@@ -238,4 +238,8 @@ bool isDigit(const std::string &str);
 
 void secureChatCommand(std::string &str);
 
+uint32_t hashString(const std::string &str) A_WARN_UNUSED;
+
+uint64_t hashString64(const std::string &str) A_WARN_UNUSED;
+
 #endif  // UTILS_STRINGUTILS_H
@@ -568,3 +568,21 @@ TEST(stringuntils, isDigit)
     EXPECT_FALSE(isDigit("1.23"));
     EXPECT_FALSE(isDigit("12-34"));
 }
+
+TEST(stringuntils, hashString)
+{
+    EXPECT_EQ(2166136261U, hashString(""));
+    EXPECT_EQ(0xe40c292cU, hashString("a"));
+    EXPECT_EQ(hashString("test.png|W:#ff0000"),
+        hashString("test.png|W:#ff0000"));
+    EXPECT_NE(hashString("test.png|W:#ff0000"),
+        hashString("test.png|W:#00ff00"));
+}
+
+TEST(stringuntils, hashString64)
+{
+    EXPECT_EQ(0xcbf29ce484222325ULL, hashString64(""));
+    EXPECT_EQ(0xaf63dc4c8601ec8cULL, hashString64("a"));
+    EXPECT_EQ(hashString64("test line1"), hashString64("test line1"));
+    EXPECT_NE(hashString64("test line1"), hashString64("test line2"));
+}
@@ -41,6 +41,8 @@ class PoParser final
 
         static bool checkLang(const std::string &lang);
 
+        static std::string getFileName(const std::string &lang);
+
         static PoDict *getEmptyDict();
 
     private:
@@ -57,8 +59,6 @@ class PoParser final
 
         bool checkLine() const;
 
-        static std::string getFileName(const std::string &lang);
-
         PoDict *getDict() const;
 
         static void convertStr(std::string &str);
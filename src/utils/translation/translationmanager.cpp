@@ -76,6 +76,18 @@ PoDict *TranslationManager::loadLang(const LangVect &lang,
     return PoParser::getEmptyDict();
 }
 
+void TranslationManager::getLangFiles(const LangVect &lang,
+                                      StringVect &files)
+{
+    FOR_EACH (LangIter, it, lang)
+    {
+        if (*it == "C")
+            continue;
+        files.push_back(PoParser::getFileName(*it));
+        files.push_back(PoParser::getFileName("help/" + *it));
+    }
+}
+
 bool TranslationManager::translateFile(const std::string &fileName,
                                        PoDict *const dict,
                                        StringVect &lines)
@@ -41,6 +41,12 @@ class TranslationManager final
 
         static void loadCurrentLang();
 
+        /**
+         * Adds po files what can be loaded for given languages, even if
+         * files not exists.
+         */
+        static void getLangFiles(const LangVect &lang, StringVect &files);
+
         static bool translateFile(const std::string &fileName,
                                   PoDict *const dict,
                                   StringVect &lines);